@@ -9,8 +9,11 @@
 
 #include "tm4c123gh6pm.h"
 #include "ADC.h"
+#ifdef HOST_BUILD
+#include "VirtualBoard.h"
+#endif
 
-const uint8_t NUM_CHANNELS = 12;
+#define NUM_CHANNELS 12
 const uint8_t HW_AVG = ADC_SAC_AVG_64X;
 
 typedef enum ChannelStatus {CLOSED, OPEN} ChannelStatus;
@@ -63,6 +66,9 @@ uint16_t ADC_In(uint8_t channel) {
   
   // Get sample
   ADC1_PSSI_R = 0x8; // Initiate SS3
+#ifdef HOST_BUILD
+  VirtualBoard_AdcConvert();
+#endif
   while((ADC1_RIS_R&0x8)==0){}; // Wait for conversion to complete
   val = ADC1_SSFIFO3_R&0xFFF; // Read result
   ADC1_ISC_R = 0x8; // Acknowledge completion
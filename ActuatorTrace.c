@@ -0,0 +1,221 @@
+/**  
+ * File: ActuatorTrace.c
+ * Author: Sarah Masimore
+ * Last Updated Date: 10/18/2026
+ * Description: Records raw actuator ADC samples each sim tick into a compact
+ *              binary trace, or replays a recorded trace in place of the ADC
+ *              so a run can be reproduced exactly.
+ */
+
+#include <stdint.h>
+#ifdef HOST_BUILD
+#include <stdio.h>
+#endif
+#include "ActuatorTrace.h"
+#include "Simulator.h"
+#include "Telemetry.h"
+#include "ADC.h"
+#include "OS.h"
+#include "UART.h"
+#include "terminal.h"
+
+static uint8_t Channels[MAX_TRACE_CHANNELS];
+static uint8_t NumChannels = 0;
+static struct actuator_sample * CurSample = 0;
+
+#ifdef RECORD_ACTUATORS
+static struct actuator_sample Trace[MAX_NUM_TICKS];
+static uint16_t TraceLen = 0;
+static struct actuator_sample Discard;
+#endif
+
+// Sample i of the replayed trace must be tick i. Ticks past the end repeat 
+// the last sample.
+#if defined(REPLAY_ACTUATORS) && defined(HOST_BUILD)
+// Loaded from ACTUATOR_TRACE_PATH when the first channel is opened.
+static struct actuator_sample ReplayTrace[MAX_NUM_TICKS];
+static uint16_t ReplayTraceLen = 0;
+static void loadReplayTrace(void);
+#elif defined(REPLAY_ACTUATORS)
+// Paste the output of tools/TelemetryDecode -a on a recorded trace here.
+static const struct actuator_sample ReplayTrace[] = {
+  {0, {4095, 0, 80}, 0}, // fwd at full speed, straight
+};
+static const uint16_t ReplayTraceLen = 
+  sizeof(ReplayTrace) / sizeof(ReplayTrace[0]);
+#endif
+
+static uint8_t getSlot(uint8_t channel);
+
+/**
+ * Opens ADC channel and registers it with the trace.
+ */
+void ActuatorTrace_Open(uint8_t channel) {
+  if (getSlot(channel) < NumChannels) {
+    return;
+  }
+  
+  if (NumChannels == MAX_TRACE_CHANNELS) {
+    terminal_printString("Error: Too many actuator trace channels\r\n");
+    return;
+  }
+  
+#if defined(REPLAY_ACTUATORS) && defined(HOST_BUILD)
+  if (NumChannels == 0) {
+    loadReplayTrace();
+  }
+#endif
+  
+  Channels[NumChannels++] = channel;
+#ifndef REPLAY_ACTUATORS
+  ADC_Open(channel);
+#endif
+}
+
+/**
+ * Marks the start of a sim tick.
+ */
+void ActuatorTrace_StartTick(uint32_t numTicks) {
+#ifdef RECORD_ACTUATORS
+  // Trace full, keep sampling but drop samples.
+  if (TraceLen == MAX_NUM_TICKS) {
+    CurSample = &Discard;
+    return;
+  }
+  
+  CurSample = &Trace[TraceLen++];
+  CurSample->numTicks = numTicks;
+  CurSample->time = (uint32_t)OS_Time();
+#endif
+
+#ifdef REPLAY_ACTUATORS
+  CurSample = (struct actuator_sample *)&ReplayTrace[
+    numTicks < ReplayTraceLen ? numTicks : ReplayTraceLen - 1];
+  // A sample out of place would silently replay the wrong tick.
+  if (CurSample->numTicks != CurSample - ReplayTrace) {
+    terminal_fatalErrorHandler(E_ACTUATOR_TRACE_IO, 
+      "Replay trace samples are not in tick order");
+  }
+#endif
+}
+
+/**
+ * Returns sample for channel from ADC or replayed trace.
+ */
+uint16_t ActuatorTrace_In(uint8_t channel) {
+  uint8_t slot = getSlot(channel);
+  
+#ifdef REPLAY_ACTUATORS
+  if (CurSample == 0 || slot == NumChannels) {
+    return 0;
+  }
+  
+  return CurSample->adc[slot];
+#else
+  uint16_t val = ADC_In(channel);
+  
+  if (CurSample != 0 && slot < NumChannels) {
+    CurSample->adc[slot] = val;
+  }
+  
+  return val;
+#endif
+}
+
+/**
+ * Saves the recorded trace as actuator frames, to ACTUATOR_TRACE_PATH on host
+ * builds or over the UART.
+ */
+void ActuatorTrace_Save(void) {
+#ifdef RECORD_ACTUATORS
+  uint8_t frame[TELEMETRY_ACTUATOR_FRAME_BYTES];
+  uint16_t len;
+  int i;
+#ifdef HOST_BUILD
+  FILE *file = fopen(ACTUATOR_TRACE_PATH, "wb");
+  
+  if (file == 0) {
+    terminal_printString("Error: Can't write " ACTUATOR_TRACE_PATH "\r\n");
+    return;
+  }
+  for (i = 0; i < TraceLen; i++) {
+    len = Telemetry_EncodeActuator(&Trace[i], frame);
+    fwrite(frame, 1, len, file);
+  }
+  if (fclose(file) != 0) {
+    terminal_printString("Error: Can't write " ACTUATOR_TRACE_PATH "\r\n");
+    return;
+  }
+  terminal_printString("Actuator trace saved to " ACTUATOR_TRACE_PATH "\r\n");
+#else
+  // A lone delimiter ends any text before the first frame.
+  frame[0] = 0;
+  UART_OutBuffer((char *)frame, 1);
+  for (i = 0; i < TraceLen; i++) {
+    len = Telemetry_EncodeActuator(&Trace[i], frame);
+    UART_OutBuffer((char *)frame, len);
+  }
+#endif
+#endif
+}
+
+#if defined(REPLAY_ACTUATORS) && defined(HOST_BUILD)
+/**
+ * Reads actuator frames from ACTUATOR_TRACE_PATH into ReplayTrace. Anything
+ * else in the file, such as terminal text and live data frames in a 
+ * capture of the board's UART, is skipped. A gap in the frames' ticks, e.g.
+ * a frame corrupted by a lost byte, is a fatal error.
+ */
+static void loadReplayTrace(void) {
+  uint8_t frame[TELEMETRY_ACTUATOR_FRAME_BYTES];
+  struct actuator_sample sample;
+  uint16_t len = 0;
+  FILE *file = fopen(ACTUATOR_TRACE_PATH, "rb");
+  int c;
+  
+  if (file == 0) {
+    terminal_fatalErrorHandler(E_ACTUATOR_TRACE_IO, 
+      "Can't open " ACTUATOR_TRACE_PATH ", record one with RECORD_ACTUATORS");
+  }
+  while ((c = fgetc(file)) != EOF && ReplayTraceLen < MAX_NUM_TICKS) {
+    if (c != 0) {
+      // Too long to be an actuator frame. Dropped at the next 0.
+      if (len < TELEMETRY_ACTUATOR_FRAME_BYTES) {
+        frame[len] = c;
+      }
+      len++;
+      continue;
+    }
+    if (len > 0 && len <= TELEMETRY_ACTUATOR_FRAME_BYTES &&
+        Telemetry_DecodeActuator(frame, len, &sample)) {
+      if (sample.numTicks != ReplayTraceLen) {
+        terminal_fatalErrorHandler(E_ACTUATOR_TRACE_IO, 
+          "Ticks missing from " ACTUATOR_TRACE_PATH ", frames were lost");
+      }
+      ReplayTrace[ReplayTraceLen++] = sample;
+    }
+    len = 0;
+  }
+  fclose(file);
+  
+  if (ReplayTraceLen == 0) {
+    terminal_fatalErrorHandler(E_ACTUATOR_TRACE_IO, 
+      "No actuator frames in " ACTUATOR_TRACE_PATH);
+  }
+}
+#endif
+
+/**
+ * Returns trace slot for channel, NumChannels if channel not registered.
+ */
+static uint8_t getSlot(uint8_t channel) {
+  uint8_t i;
+  
+  for (i = 0; i < NumChannels; i++) {
+    if (Channels[i] == channel) {
+      return i;
+    }
+  }
+  
+  return NumChannels;
+}
@@ -0,0 +1,64 @@
+/**	
+ * File: ActuatorTrace.h
+ * Author: Sarah Masimore
+ * Last Updated Date: 10/18/2026
+ * Description: Records raw actuator ADC samples each sim tick into a compact
+ *              binary trace, or replays a recorded trace in place of the ADC
+ *              so a run can be reproduced exactly.
+ */
+
+#ifndef ACTUATORTRACE_H
+#define ACTUATORTRACE_H
+
+#include <stdint.h>
+#include "Simulator.h"
+
+// Uncomment one to record actuator samples or replay a recorded trace 
+// instead of reading the ADC. Host builds save to and replay from 
+// ACTUATOR_TRACE_PATH. The board sends the trace over the UART and replays 
+// ReplayTrace in ActuatorTrace.c.
+//#define RECORD_ACTUATORS
+//#define REPLAY_ACTUATORS
+
+#ifdef HOST_BUILD
+#define ACTUATOR_TRACE_PATH "actuator_trace.bin"
+#endif
+
+#define MAX_TRACE_CHANNELS 3 // motor PB7, motor PB6, servo
+
+/**
+ * One sim tick of raw 12-bit ADC samples. Samples are stored in the order
+ * channels were opened with ActuatorTrace_Open. 12 bytes per tick.
+ */
+struct actuator_sample {
+	uint16_t numTicks;
+	uint16_t adc[MAX_TRACE_CHANNELS];
+	uint32_t time; // low 32 bits of OS_Time when tick started
+};
+
+/**
+ * Opens ADC channel and registers it with the trace. Use in place of ADC_Open
+ * for any channel read by an actuator.
+ */
+void ActuatorTrace_Open(uint8_t channel);
+
+/**
+ * Marks the start of a sim tick. Must be called before actuator channels are
+ * read for the tick.
+ */
+void ActuatorTrace_StartTick(uint32_t numTicks);
+
+/**
+ * Returns sample for channel. Reads the ADC (recording the sample if 
+ * RECORD_ACTUATORS) or, if REPLAY_ACTUATORS, returns the recorded sample for
+ * the current tick.
+ */
+uint16_t ActuatorTrace_In(uint8_t channel);
+
+/**
+ * Saves the recorded trace as actuator frames (see Telemetry.h). Host builds
+ * write them to ACTUATOR_TRACE_PATH, the board sends them over the UART.
+ */
+void ActuatorTrace_Save(void);
+
+#endif // ACTUATORTRACE_H
@@ -11,12 +11,14 @@
 #include "Actuators.h"
 #include "MotorActuator.h"
 #include "ServoActuator.h"
+#include "ActuatorTrace.h"
+
+extern uint32_t NumSimTicks;
 
 // Uncomment to mock actuator values (e.g. for testing sim)
 //#define MOCK_ACTUATORS
 
 #ifdef MOCK_ACTUATORS
-  extern uint32_t NumSimTicks;
   // Example of completion
   //uint32_t TestDir[34] = {90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90, 90};  
   // Example of crash
@@ -34,14 +36,31 @@ void Actuators_Init(void) {
 
 /**
  * Gets input voltage values, maps to environment values, and stores in Car.
+ * Input samples come from ActuatorTrace, which records or replays them.
  */
 void Actuators_UpdateVelocityAndDirection(struct car * car) {
 #ifdef MOCK_ACTUATORS
   car->dir = TestDir[NumSimTicks];
 #else
   uint16_t dir;
+  ActuatorTrace_StartTick(NumSimTicks);
+#ifdef DIFF_DRIVE
+  MotorActuator_GetWheelVelocities(&car->velLeft, &car->velRight);
+  car->vel = (car->velLeft + car->velRight) / 2;
+#else
   car->vel = MotorActuator_GetVelocity();
-  dir = car->dir + ServoActuator_GetDirection();
-  car->dir = dir > 360 ? dir - 360 : dir;
+#endif
+  dir = ServoActuator_GetDirection();
+#if defined(DIFF_DRIVE)
+  // Wheel velocities steer, Simulator_MoveCarDiff turns the car. The servo
+  // is still read so actuator traces have every channel.
+  (void)dir;
+#elif defined(BICYCLE_MODEL)
+  // Servo angle steers the front wheels, Simulator_MoveCarArc turns the car.
+  car->steer = dir > 180 ? (int16_t)dir - 360 : dir;
+#else
+  dir = car->dir + dir;
+  car->dir = dir >= 360 ? dir - 360 : dir;
+#endif
 #endif
 }
@@ -47,6 +47,14 @@ typedef enum ErrorCodes {
   E_NO_SPACE_FOR_THREAD,
   E_STOPPED_SOLE_ACTIVE_THREAD,
   E_NO_ACTIVE_THREADS,
+  E_SCHEDULER_CORRUPT,
+  E_STACK_OVERFLOW,
+  
+  // Host
+  E_VIRTUAL_BOARD_MAP = 600,
+  E_POSE_TABLE_IO,
+  E_POSE_TABLE_MISMATCH,
+  E_ACTUATOR_TRACE_IO,
   
 } ErrorCode_t;
 
@@ -113,4 +113,245 @@ unsigned short NAME ## Fifo_Size (void){\
 // SIZE can be any size
 // creates RxFifo_Init() RxFifo_Get() and RxFifo_Put()
 
+// macro to create an index FIFO whose Get blocks on an OS semaphore
+// Put never blocks, so it can be called from ISRs. When full the data is
+// dropped and counted in NAME ## Overflows.
+// One producer and one consumer. Needs OS.h.
+#define AddBlockingFifo(NAME,SIZE,TYPE,SUCCESS,FAIL) \
+uint32_t volatile NAME ## PutI;    \
+uint32_t volatile NAME ## GetI;    \
+uint32_t volatile NAME ## Overflows; \
+Sema4Type NAME ## DataAvailable;   \
+TYPE static NAME ## Fifo [SIZE];        \
+void NAME ## Fifo_Init(void){           \
+  NAME ## PutI = NAME ## GetI = 0;      \
+  NAME ## Overflows = 0;                \
+  OS_InitSemaphore(&NAME ## DataAvailable, 0); \
+}                                       \
+int NAME ## Fifo_Put (TYPE data){       \
+  if(( NAME ## PutI - NAME ## GetI ) & ~(SIZE-1)){  \
+    NAME ## Overflows++;                \
+    return(FAIL);      \
+  }                    \
+  NAME ## Fifo[ NAME ## PutI &(SIZE-1)] = data; \
+  NAME ## PutI++;      \
+  OS_Signal(&NAME ## DataAvailable);    \
+  return(SUCCESS);     \
+}                      \
+int NAME ## Fifo_Get (TYPE *datapt){  \
+  OS_Wait(&NAME ## DataAvailable);    \
+  *datapt = NAME ## Fifo[ NAME ## GetI &(SIZE-1)];  \
+  NAME ## GetI++;      \
+  return(SUCCESS);     \
+}                      \
+unsigned short NAME ## Fifo_Size (void){  \
+ return ((unsigned short)( NAME ## PutI - NAME ## GetI ));  \
+}
+// e.g.,
+// AddBlockingFifo(Data,8,struct data, 1,0)
+// SIZE must be a power of two
+// creates DataFifo_Init() DataFifo_Get() DataFifo_Put() and DataOverflows
+// DataFifo_Init() must be called before OS_Launch
+
+// Queues passed by pointer, with batched Put/Get.
+// SPSC: one producer, one consumer. MPSC: any number of producers, one 
+// consumer. On the host these are lock free on C11 atomics, with the put and
+// get indices on separate cache lines. On target they compile to the index 
+// FIFO above, MPSC Put in a critical section.
+// PutN/GetN return the number of elements moved.
+#ifdef HOST_BUILD
+#include <stdatomic.h>
+#define FIFO_CACHE_LINE 64
+
+// macro to create a lock free single producer single consumer queue
+#define AddSpscFifo(NAME,SIZE,TYPE,SUCCESS,FAIL) \
+static struct {                         \
+  _Alignas(FIFO_CACHE_LINE) atomic_uint PutI; \
+  _Alignas(FIFO_CACHE_LINE) atomic_uint GetI; \
+  _Alignas(FIFO_CACHE_LINE) TYPE Fifo[SIZE]; \
+} NAME ## Spsc;                         \
+void NAME ## Fifo_Init(void){           \
+  atomic_init(&NAME ## Spsc.PutI, 0);   \
+  atomic_init(&NAME ## Spsc.GetI, 0);   \
+}                                       \
+uint32_t NAME ## Fifo_PutN (TYPE const *data, uint32_t n){ \
+  uint32_t put = atomic_load_explicit(&NAME ## Spsc.PutI, memory_order_relaxed); \
+  uint32_t get = atomic_load_explicit(&NAME ## Spsc.GetI, memory_order_acquire); \
+  uint32_t i;                           \
+  if(n > SIZE - (put - get)){           \
+    n = SIZE - (put - get);             \
+  }                                     \
+  for(i = 0; i < n; i++){               \
+    NAME ## Spsc.Fifo[(put + i) & (SIZE-1)] = data[i]; \
+  }                                     \
+  atomic_store_explicit(&NAME ## Spsc.PutI, put + n, memory_order_release); \
+  return n;                             \
+}                                       \
+uint32_t NAME ## Fifo_GetN (TYPE *data, uint32_t n){ \
+  uint32_t get = atomic_load_explicit(&NAME ## Spsc.GetI, memory_order_relaxed); \
+  uint32_t put = atomic_load_explicit(&NAME ## Spsc.PutI, memory_order_acquire); \
+  uint32_t i;                           \
+  if(n > put - get){                    \
+    n = put - get;                      \
+  }                                     \
+  for(i = 0; i < n; i++){               \
+    data[i] = NAME ## Spsc.Fifo[(get + i) & (SIZE-1)]; \
+  }                                     \
+  atomic_store_explicit(&NAME ## Spsc.GetI, get + n, memory_order_release); \
+  return n;                             \
+}                                       \
+int NAME ## Fifo_Put (TYPE const *data){ \
+  return NAME ## Fifo_PutN(data, 1) ? (SUCCESS) : (FAIL); \
+}                                       \
+int NAME ## Fifo_Get (TYPE *data){      \
+  return NAME ## Fifo_GetN(data, 1) ? (SUCCESS) : (FAIL); \
+}                                       \
+uint32_t NAME ## Fifo_Size (void){      \
+  return atomic_load(&NAME ## Spsc.PutI) - atomic_load(&NAME ## Spsc.GetI); \
+}
+
+// macro to create a lock free multiple producer single consumer queue
+// Bounded ring with a sequence number per slot. A producer claims a slot by
+// advancing PutI, then publishes it by setting the slot's sequence.
+#define AddMpscFifo(NAME,SIZE,TYPE,SUCCESS,FAIL) \
+static struct {                         \
+  _Alignas(FIFO_CACHE_LINE) atomic_uint PutI; \
+  _Alignas(FIFO_CACHE_LINE) uint32_t GetI; \
+  _Alignas(FIFO_CACHE_LINE) struct {    \
+    atomic_uint Seq;                    \
+    TYPE Data;                          \
+  } Fifo[SIZE];                         \
+} NAME ## Mpsc;                         \
+void NAME ## Fifo_Init(void){ uint32_t i; \
+  atomic_init(&NAME ## Mpsc.PutI, 0);   \
+  NAME ## Mpsc.GetI = 0;                \
+  for(i = 0; i < SIZE; i++){            \
+    atomic_init(&NAME ## Mpsc.Fifo[i].Seq, i); \
+  }                                     \
+}                                       \
+int NAME ## Fifo_Put (TYPE const *data){ \
+  uint32_t put = atomic_load_explicit(&NAME ## Mpsc.PutI, memory_order_relaxed); \
+  uint32_t seq;                         \
+  while(1){                             \
+    seq = atomic_load_explicit(&NAME ## Mpsc.Fifo[put & (SIZE-1)].Seq, memory_order_acquire); \
+    if((int32_t)(seq - put) < 0){       \
+      return(FAIL);                     \
+    }                                   \
+    if(seq == put && atomic_compare_exchange_weak_explicit(&NAME ## Mpsc.PutI, \
+        &put, put + 1, memory_order_relaxed, memory_order_relaxed)){ \
+      break;                            \
+    }                                   \
+    if(seq != put){                     \
+      put = atomic_load_explicit(&NAME ## Mpsc.PutI, memory_order_relaxed); \
+    }                                   \
+  }                                     \
+  NAME ## Mpsc.Fifo[put & (SIZE-1)].Data = *data; \
+  atomic_store_explicit(&NAME ## Mpsc.Fifo[put & (SIZE-1)].Seq, put + 1, \
+    memory_order_release);              \
+  return(SUCCESS);                      \
+}                                       \
+uint32_t NAME ## Fifo_PutN (TYPE const *data, uint32_t n){ uint32_t i; \
+  for(i = 0; i < n; i++){               \
+    if(NAME ## Fifo_Put(&data[i]) != (SUCCESS)){ \
+      break;                            \
+    }                                   \
+  }                                     \
+  return i;                             \
+}                                       \
+uint32_t NAME ## Fifo_GetN (TYPE *data, uint32_t n){ \
+  uint32_t get = NAME ## Mpsc.GetI;     \
+  uint32_t i;                           \
+  for(i = 0; i < n; i++){               \
+    if(atomic_load_explicit(&NAME ## Mpsc.Fifo[(get + i) & (SIZE-1)].Seq, \
+        memory_order_acquire) != get + i + 1){ \
+      break;                            \
+    }                                   \
+    data[i] = NAME ## Mpsc.Fifo[(get + i) & (SIZE-1)].Data; \
+    atomic_store_explicit(&NAME ## Mpsc.Fifo[(get + i) & (SIZE-1)].Seq, \
+      get + i + SIZE, memory_order_release); \
+  }                                     \
+  NAME ## Mpsc.GetI = get + i;          \
+  return i;                             \
+}                                       \
+int NAME ## Fifo_Get (TYPE *data){      \
+  return NAME ## Fifo_GetN(data, 1) ? (SUCCESS) : (FAIL); \
+}                                       \
+uint32_t NAME ## Fifo_Size (void){      \
+  return atomic_load(&NAME ## Mpsc.PutI) - NAME ## Mpsc.GetI; \
+}
+
+#else
+
+// macro to create a single producer single consumer queue
+#define AddSpscFifo(NAME,SIZE,TYPE,SUCCESS,FAIL) \
+uint32_t volatile NAME ## PutI;    \
+uint32_t volatile NAME ## GetI;    \
+TYPE static NAME ## Fifo [SIZE];        \
+void NAME ## Fifo_Init(void){ long sr;  \
+  sr = StartCritical();                 \
+  NAME ## PutI = NAME ## GetI = 0;      \
+  EndCritical(sr);                      \
+}                                       \
+uint32_t NAME ## Fifo_PutN (TYPE const *data, uint32_t n){ uint32_t i; \
+  if(n > SIZE - (NAME ## PutI - NAME ## GetI)){ \
+    n = SIZE - (NAME ## PutI - NAME ## GetI); \
+  }                                     \
+  for(i = 0; i < n; i++){               \
+    NAME ## Fifo[(NAME ## PutI + i) & (SIZE-1)] = data[i]; \
+  }                                     \
+  NAME ## PutI += n;                    \
+  return n;                             \
+}                                       \
+uint32_t NAME ## Fifo_GetN (TYPE *data, uint32_t n){ uint32_t i; \
+  if(n > NAME ## PutI - NAME ## GetI){  \
+    n = NAME ## PutI - NAME ## GetI;    \
+  }                                     \
+  for(i = 0; i < n; i++){               \
+    data[i] = NAME ## Fifo[(NAME ## GetI + i) & (SIZE-1)]; \
+  }                                     \
+  NAME ## GetI += n;                    \
+  return n;                             \
+}                                       \
+int NAME ## Fifo_Put (TYPE const *data){ \
+  return NAME ## Fifo_PutN(data, 1) ? (SUCCESS) : (FAIL); \
+}                                       \
+int NAME ## Fifo_Get (TYPE *data){      \
+  return NAME ## Fifo_GetN(data, 1) ? (SUCCESS) : (FAIL); \
+}                                       \
+uint32_t NAME ## Fifo_Size (void){      \
+  return NAME ## PutI - NAME ## GetI;   \
+}
+
+// macro to create a multiple producer single consumer queue
+#define AddMpscFifo(NAME,SIZE,TYPE,SUCCESS,FAIL) \
+AddSpscFifo(NAME ## Unlocked,SIZE,TYPE,SUCCESS,FAIL) \
+void NAME ## Fifo_Init(void){           \
+  NAME ## UnlockedFifo_Init();          \
+}                                       \
+uint32_t NAME ## Fifo_PutN (TYPE const *data, uint32_t n){ long sr; \
+  sr = StartCritical();                 \
+  n = NAME ## UnlockedFifo_PutN(data, n); \
+  EndCritical(sr);                      \
+  return n;                             \
+}                                       \
+uint32_t NAME ## Fifo_GetN (TYPE *data, uint32_t n){ \
+  return NAME ## UnlockedFifo_GetN(data, n); \
+}                                       \
+int NAME ## Fifo_Put (TYPE const *data){ \
+  return NAME ## Fifo_PutN(data, 1) ? (SUCCESS) : (FAIL); \
+}                                       \
+int NAME ## Fifo_Get (TYPE *data){      \
+  return NAME ## Fifo_GetN(data, 1) ? (SUCCESS) : (FAIL); \
+}                                       \
+uint32_t NAME ## Fifo_Size (void){      \
+  return NAME ## UnlockedFifo_Size();   \
+}
+
+#endif
+// e.g.,
+// AddMpscFifo(Rows,256,struct row, 1,0)
+// SIZE must be a power of two
+// creates RowsFifo_Init() RowsFifo_Put() RowsFifo_PutN() RowsFifo_Get()
+// RowsFifo_GetN() and RowsFifo_Size()
+
 #endif //  __FIFO_H__
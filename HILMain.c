@@ -1,7 +1,7 @@
 /**
  * File: HILMain.c
  * Author: Sarah Masimore
- * Last Updated Date: 04/22/2018
+ * Last Updated Date: 10/18/2026
  * Description: Controller managing simulator, actuators, sensors, and timer 
  *              interrupt for racecar HIL testing.
  */
@@ -12,53 +12,216 @@
 #include "Simulator.h"
 #include "Sensors.h"
 #include "Actuators.h"
+#include "ActuatorTrace.h"
 #include "UART.h"
 #include "SimLogger.h"
 #include "OS.h"
 #include "terminal.h"
 #include "FIFO.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "LineBuilder.h"
+#include "Telemetry.h"
+#include "TrackSDF.h"
+#include "World.h"
+#include "Obstacles.h"
+#include "Race.h"
+#ifdef HOST_BUILD
+#include <stdlib.h>
+#include <unistd.h>
+#include "VirtualBoard.h"
+#include "PoseTable.h"
+#endif
 
 #define NUM_SENSORS 7
 #define NUM_WALLS 6
 #define DEBUGGING
+// Send live data as binary frames (see Telemetry.h) instead of text. Decode
+// on the host with tools/TelemetryDecode.
+//#define BINARY_TELEMETRY
+// Race replayed opponents (see World.h). Car's sensors see them and hitting
+// one ends the sim.
+//#define OPPONENTS
+// Add a sliding door and a pedestrian to the track (see Obstacles.h).
+//#define OBSTACLES
+// Time the race through checkpoint gates (see Race.h) instead of ending it 
+// when the car passes finishLineY. Splits are printed with the log.
+//#define RACE_GATES
 
 struct car Car;
 struct environment Environment;
 struct sensor Sensors[NUM_SENSORS];
+#ifdef OBSTACLES
+#define OBSTACLE_WALLS 5
+struct wall Walls[NUM_WALLS + OBSTACLE_WALLS];
+#else
 struct wall Walls[NUM_WALLS];
+#endif
 
 uint32_t NumSimTicks = 0;
 uint8_t SimComplete = 0;
 struct live_data LiveData;
 
+#ifdef TRACK_SDF
+// 100 mm cells cover the 3 x 5 m track in 3.3 KB.
+#define SDF_CELL_MM 100
+#define SDF_MAX_CELLS 1700
+static uint16_t SdfCells[SDF_MAX_CELLS];
+static struct track_sdf TrackSdf;
+static uint32_t MinClearance = SDF_FAR; // closest the car got to a wall, mm
+#ifdef OBSTACLES
+// Moving walls only change cells within range, the rest stay as built.
+#define SDF_RANGE_MM 300
+static uint16_t SdfStaticCells[SDF_MAX_CELLS];
+#endif
+#endif
+
+#ifdef OBSTACLES
+// Door slides out of the right straight's left wall and back. Pedestrian
+// crosses the start straight, then leaves.
+#define NUM_OBSTACLES 2
+static const struct wall DoorShape[] = {{2250, 1800, 2500, 1800}};
+static const struct obstacle_key DoorKeys[] = {
+  {0, 0, 0, 1}, {10, 0, 0, 1}, {20, 250, 0, 1}, {35, 250, 0, 1}, 
+  {45, 0, 0, 1}
+};
+static const struct wall PedestrianShape[] = {
+  {1050, 900, 1200, 900}, {1200, 900, 1200, 1050}, 
+  {1050, 1050, 1200, 1050}, {1050, 900, 1050, 1050}
+};
+static const struct obstacle_key PedestrianKeys[] = {
+  {0, 0, 0, 0}, {3, 0, 0, 1}, {20, 650, 0, 1}, {21, 650, 0, 0}
+};
+static struct obstacle Obstacles[NUM_OBSTACLES] = {
+  {DoorShape, 1, DoorKeys, sizeof(DoorKeys) / sizeof(DoorKeys[0])},
+  {PedestrianShape, 4, PedestrianKeys, 
+   sizeof(PedestrianKeys) / sizeof(PedestrianKeys[0])}
+};
+static struct obstacle_set ObstacleSet;
+#endif
+
+#ifdef OPPONENTS
+// One car crawling up the start straight ahead of Car, one parked in the
+// right straight. Poses are per sim tick.
+#define NUM_OPPONENTS 2
+static const struct trace_pose SlowCarPoses[] = {
+  {1800, 600, 90}, {1800, 630, 90}, {1800, 660, 90}, {1800, 690, 90}, 
+  {1800, 720, 90}, {1800, 750, 90}, {1800, 780, 90}, {1800, 810, 90}, 
+  {1800, 840, 90}, {1790, 870, 95}, {1780, 900, 95}, {1770, 930, 95}
+};
+static const struct trace_pose ParkedCarPoses[] = {{2650, 2500, 90}};
+static const struct pose_trace OpponentTraces[NUM_OPPONENTS] = {
+  {sizeof(SlowCarPoses) / sizeof(SlowCarPoses[0]), SlowCarPoses},
+  {1, ParkedCarPoses}
+};
+static struct car Opponents[NUM_OPPONENTS];
+static struct world World; // Car is car 0
+#endif
+
+#ifdef RACE_GATES
+// Sector gate where the car turns into the corridor, finish across the right
+// straight where finishLineY was. One lap, since the track isn't a circuit.
+#define NUM_GATES 2
+#define NUM_LAPS 1
+static const struct gate Gates[NUM_GATES] = {
+  {2000, 1500, 2000, 500}, {2500, 2000, 3000, 2000}
+};
+static struct race Race;
+#endif
+
+#if defined(HOST_BUILD) && defined(POSE_TABLE)
+// Built on the first run of a track, mapped from disk after that.
+#define POSE_TABLE_PATH "posetable.bin"
+#define POSE_TABLE_CELL_MM 20
+static struct pose_table PoseTable;
+#endif
+
 static void initObjects(void);
 static void addSimFGThread(void);
 static void simThread(void);
 static void dataOut(void);
 static void endSim(char * message);
+#ifndef HOST_BUILD
+static void commandThread(void);
+#endif
+
+// Held while printing so dataOut frames and end of sim output don't 
+// interleave. If simThread waits on it, dataOut inherits simThread's priority.
+Sema4Type TerminalMutex;
 
 // Fifo for storing live data to be printed to terminal in dataOut thread.
-AddIndexFifo(LiveData, 1, struct live_data, 1, 0);
+// dataOut blocks on it between frames, and commandThread blocks in 
+// UART_InChar, so idle gets the spare CPU. The 'threads' command shows the 
+// split. Must be a power of two.
+#define LIVE_DATA_FIFO_SIZE 8
+AddBlockingFifo(LiveData, LIVE_DATA_FIFO_SIZE, struct live_data, 1, 0);
 
 int main(void){
   OS_Init();
+#ifdef HOST_BUILD
+  // Registers must be mapped before any driver init.
+  VirtualBoard_Init(0);
+#endif
   
   // Simulator inits
   terminal_init();
   initObjects();
+#ifdef TRACK_SDF
+  if (TrackSDF_Build(&TrackSdf, &Environment, SdfCells, SDF_MAX_CELLS, 
+                     SDF_CELL_MM) == E_SUCCESS) {
+    Environment.sdf = &TrackSdf;
+#ifdef OBSTACLES
+    TrackSDF_EnableUpdates(&TrackSdf, &Environment, SdfStaticCells, 
+                           SDF_RANGE_MM);
+#endif
+  } else {
+    terminal_printString("Track too large for distance field\r\n");
+  }
+#endif
+#if defined(HOST_BUILD) && defined(POSE_TABLE)
+  if (PoseTable_Open(&PoseTable, POSE_TABLE_PATH, &Environment) == E_SUCCESS ||
+      (PoseTable_Build(&Environment, Car.x, Car.y, POSE_TABLE_CELL_MM, 
+                       sysconf(_SC_NPROCESSORS_ONLN) > 64 ? 64 : 
+                       sysconf(_SC_NPROCESSORS_ONLN), 
+                       POSE_TABLE_PATH) == E_SUCCESS &&
+       PoseTable_Open(&PoseTable, POSE_TABLE_PATH, &Environment) == E_SUCCESS)) {
+    Environment.poseTable = &PoseTable;
+  } else {
+    terminal_printString("No pose table, casting sensor rays\r\n");
+  }
+#endif
+#ifdef OBSTACLES
+  // After the distance field and pose table, which only cover static walls.
+  Obstacles_Init(&ObstacleSet, &Environment, Obstacles, NUM_OBSTACLES, 
+                 NUM_WALLS + OBSTACLE_WALLS);
+#endif
   Sensors_Init(&Car);
   Actuators_Init();
   LiveDataFifo_Init();
+  SimLogger_Init();
+  OS_InitSemaphore(&TerminalMutex, 1);
   
   // Set sensors to initial state.
+#ifdef OPPONENTS
+  World_Step(&World, 0);
+  World_UpdateSensors(&World, 0);
+#else
   Simulator_UpdateSensors(&Car, &Environment);
+#endif
   Sensors_UpdateOutput(&Car);
   
   // Background sim thread
   OS_AddPeriodicThread(&addSimFGThread, CLOCK_FREQ / SIM_FREQ, 2); // 10 hz
   
   // Foreground data output thread, lowest priority.
-  OS_AddThread(&dataOut, 128, 9); 
+  OS_AddThread(&dataOut, 1024, 9); 
+  
+#ifndef HOST_BUILD
+  // Terminal commands for reading thread stats and the profiler. Blocks in 
+  // UART_InChar between characters, so idle gets the CPU left over by the 
+  // sim. Host UART reads block the whole process, so not run there.
+  OS_AddThread(&commandThread, 512, 9);
+#endif
   
   terminal_printString("\r\n Starting test...\r\n");
   OS_Launch(TIME_2MS);
@@ -71,7 +234,7 @@ int main(void){
  * won't be able to run to clear the buffer (simThread will hang).
  */
 static void addSimFGThread(void) {
-  OS_AddThread(&simThread, 128, 1); // 10 hz, higher priority than terminal
+  OS_AddThread(&simThread, 512, 1); // 10 hz, higher priority than terminal
 }
 
 /**
@@ -91,9 +254,20 @@ static void simThread(void) {
   // Store car's previous x,y to later check if hit a wall.
   uint32_t prevX = Car.x;
   uint32_t prevY = Car.y;
+#ifdef DEBUGGING
+  static uint32_t stageCycles[NUM_SIM_STAGES];
+  uint32_t stageStart = OS_Time();
+  uint32_t stageEnd;
+  int i;
+#endif
   
   // Update actuator values (velocity and direction) and log.
   Actuators_UpdateVelocityAndDirection(&Car);
+#ifdef DEBUGGING
+  stageEnd = OS_Time();
+  stageCycles[STAGE_ACTUATORS] = stageEnd - stageStart;
+  stageStart = stageEnd;
+#endif
   
   // Log event after velocity and dir have been updated but before
   // car location has been updated.
@@ -106,26 +280,83 @@ static void simThread(void) {
   LiveData.y = Car.y;
   LiveData.vel = Car.vel;
   LiveData.dir = Car.dir;
+  for (i = 0; i < LIVE_DATA_SENSORS; i++) {
+    LiveData.sensors[i] = Car.sensors[i].val > 0xFFFF ? 
+      0xFFFF : Car.sensors[i].val;
+  }
+  for (i = 0; i < NUM_SIM_STAGES; i++) {
+    LiveData.stageCycles[i] = stageCycles[i];
+  }
   LiveDataFifo_Put(LiveData);
+  LiveData.seq++;
+  stageStart = OS_Time();
 #endif
     
   // Update car position based on current position, velocity, and direction.
   Simulator_MoveCar(&Car, MS_PER_SIM_TICK);
+#ifdef DEBUGGING
+  stageEnd = OS_Time();
+  stageCycles[STAGE_MOVE] = stageEnd - stageStart;
+  stageStart = stageEnd;
+#endif
+  
+#ifdef OBSTACLES
+  // Obstacles move to where they are next tick before the car is checked
+  // against them.
+  Obstacles_Step(&ObstacleSet, NumSimTicks + 1);
+#endif
   
   // Check if hit wall.
   if (Simulator_HitWall(&Environment, prevX, prevY, Car.x, Car.y)) {
     endSim("Car crashed into wall!");
   }
+#ifdef OPPONENTS
+  // Opponents move to their next pose too.
+  if (World_Step(&World, NumSimTicks + 1) & 1) {
+    endSim("Car crashed into another car!");
+  }
+#endif
+#ifdef TRACK_SDF
+  if (Environment.sdf) {
+    uint32_t clearance = TrackSDF_Clearance(Environment.sdf, Car.x, Car.y);
+    MinClearance = clearance < MinClearance ? clearance : MinClearance;
+  }
+#endif
+#ifdef DEBUGGING
+  stageEnd = OS_Time();
+  stageCycles[STAGE_COLLISION] = stageEnd - stageStart;
+  stageStart = stageEnd;
+#endif
   
+#ifdef RACE_GATES
+  // Times are from the start of the sim, so a gate crossed this tick is 
+  // between NumSimTicks and NumSimTicks + 1 ticks.
+  if (Race_Step(&Race, prevX, prevY, Car.x, Car.y, 
+                NumSimTicks * MS_PER_SIM_TICK * 1000, 
+                MS_PER_SIM_TICK * 1000) != RACE_NONE) {
+    SimLogger_LogSplit(&Race.split);
+    if (Race.split.event == RACE_FINISHED) {
+      endSim("Car completed race!");
+    }
+  }
+#else
   // If got to this point and car's y position is higher than finish line,
   // race is over.
   if (Car.y >= Environment.finishLineY) {
     endSim("Car completed race!");
   }    
+#endif
   
   // Update sensor vals and update voltages being outputted to car.
+#ifdef OPPONENTS
+  World_UpdateSensors(&World, 0);
+#else
   Simulator_UpdateSensors(&Car, &Environment);
+#endif
   Sensors_UpdateOutput(&Car);
+#ifdef DEBUGGING
+  stageCycles[STAGE_SENSORS] = OS_Time() - stageStart;
+#endif
   
   NumSimTicks++;
   
@@ -138,36 +369,52 @@ static void simThread(void) {
 
 /**
  * Whenever there's data to print and nothing more important to run, prints to
- * terminal. Foreground thread.
+ * terminal. Blocks until simThread puts a frame. Foreground thread.
  */
 static void dataOut(void) {
   struct live_data live_data;
+#ifdef BINARY_TELEMETRY
+  uint8_t frame[TELEMETRY_FRAME_BYTES];
+  uint16_t len;
+#else
+  static struct line_builder line;
+#endif
   while(1) {
-    if (LiveDataFifo_Get(&live_data) && !SimComplete) {
-      terminal_printString("t: ");
-      terminal_printValueDec(live_data.time / 80000000);
-      terminal_printString(" | x: ");
-      terminal_printValueDec(live_data.x);
-      terminal_printString(" | y: ");
-      terminal_printValueDec(live_data.y);
-      terminal_printString(" | vel: ");
-      if (live_data.vel < 0) {
-        terminal_printString("-");
-        terminal_printValueDec(live_data.vel * -1);
-      } else {
-        terminal_printValueDec(live_data.vel);
-      }
-      terminal_printString(" | dir: ");
-      terminal_printValueDec(live_data.dir);
-      terminal_printString(" | servo duty: ");
-      terminal_printValueDec(live_data.servoDuty);    
-      terminal_printString(" | motor pb7 duty: ");
-      terminal_printValueDec(live_data.motorPB7Duty);  
-      terminal_printString(" | motor pb6 duty: ");
-      terminal_printValueDec(live_data.motorPB6Duty);  
-      terminal_printString("\r\n");
-      terminal_printString("\r\n");
+    LiveDataFifo_Get(&live_data);
+#ifdef BINARY_TELEMETRY
+    if (!SimComplete) {
+      len = Telemetry_Encode(&live_data, frame);
+      OS_MutexLock(&TerminalMutex);
+      UART_OutBuffer((char *)frame, len);
+      OS_MutexUnlock(&TerminalMutex);
+    }
+#else
+    if (!SimComplete) {
+      // Build the frame before taking the mutex, so it's only held for the
+      // FIFO put.
+      LineBuilder_Clear(&line);
+      LineBuilder_AppendString(&line, "t: ");
+      LineBuilder_AppendUDec(&line, live_data.time / 80000000);
+      LineBuilder_AppendString(&line, " | x: ");
+      LineBuilder_AppendUDec(&line, live_data.x);
+      LineBuilder_AppendString(&line, " | y: ");
+      LineBuilder_AppendUDec(&line, live_data.y);
+      LineBuilder_AppendString(&line, " | vel: ");
+      LineBuilder_AppendDec(&line, live_data.vel);
+      LineBuilder_AppendString(&line, " | dir: ");
+      LineBuilder_AppendUDec(&line, live_data.dir);
+      LineBuilder_AppendString(&line, " | servo duty: ");
+      LineBuilder_AppendUDec(&line, live_data.servoDuty);
+      LineBuilder_AppendString(&line, " | motor pb7 duty: ");
+      LineBuilder_AppendUDec(&line, live_data.motorPB7Duty);
+      LineBuilder_AppendString(&line, " | motor pb6 duty: ");
+      LineBuilder_AppendUDec(&line, live_data.motorPB6Duty);
+      LineBuilder_AppendString(&line, "\r\n\r\n");
+      OS_MutexLock(&TerminalMutex);
+      terminal_printLine(&line);
+      OS_MutexUnlock(&TerminalMutex);
     }
+#endif
   }
 }
 
@@ -177,6 +424,10 @@ static void dataOut(void) {
  * 
  */
 static void initObjects(void) {
+#ifdef OPPONENTS
+  uint8_t i;
+  
+#endif
   Walls[0].startX = 1000;
   Walls[0].startY = 0;
   Walls[0].endX = 1000;
@@ -210,6 +461,9 @@ static void initObjects(void) {
   Environment.numWalls = NUM_WALLS;
   Environment.walls = Walls;  
   Environment.finishLineY = 2000;  
+#ifdef RACE_GATES
+  Race_Init(&Race, Gates, NUM_GATES, NUM_LAPS);
+#endif
   
   // Front center
   Sensors[0].type = S_US;
@@ -254,19 +508,69 @@ static void initObjects(void) {
   Car.y = 1;
   Car.vel = 1000; // 1000 mm/s
   Car.dir = 90;
+  
+#ifdef OPPONENTS
+  World_Init(&World, &Environment);
+  World_AddCar(&World, &Car, 0);
+  for (i = 0; i < NUM_OPPONENTS; i++) {
+    World_AddCar(&World, &Opponents[i], &OpponentTraces[i]);
+  }
+#endif
 }
 
 static void endSim(char * message) {
   OS_RemovePeriodicThread();
+  OS_MutexLock(&TerminalMutex);
   terminal_printString("\r\n");
   SimLogger_PrintToTerminal();
   terminal_printString("\r\n");
+#ifdef RECORD_ACTUATORS
+  ActuatorTrace_Save();
+  terminal_printString("\r\n");
+#endif
   terminal_printString(message);
   terminal_printString("\r\n");
+  terminal_printString("Wall tests per 100 sensor rays: ");
+  terminal_printValueDec(NumRaysCast ? NumWallTests * 100 / NumRaysCast : 0);
+  terminal_printString("\r\n");
+#ifdef TRACK_SDF
+  terminal_printString("Min wall clearance (mm): ");
+  terminal_printValueDec(MinClearance);
+  terminal_printString("\r\n");
+#endif
+  terminal_printString("Live data frames dropped: ");
+  terminal_printValueDec(LiveDataOverflows);
+  terminal_printString("\r\n");
   terminal_printString("Test complete.\r\n\r\n");
+  OS_PrintThreadStats();
+#ifdef PROFILE_CRITICAL
+  Profiler_PrintToTerminal();
+#endif
+#if TRACE_LEVEL > TRACE_LEVEL_NONE
+  if (Trace_Count() > 0) {
+    Trace_PrintToTerminal();
+  }
+#endif
   SimComplete = 1;
+  OS_MutexUnlock(&TerminalMutex);
+#ifdef HOST_BUILD
+  // Nothing left to drive the virtual board, so end the run.
+  exit(0);
+#endif
 }
 
+#ifndef HOST_BUILD
+/**
+ * Reads and runs terminal commands, e.g. "threads" to print thread stats.
+ * Foreground thread.
+ */
+static void commandThread(void) {
+  while(1) {
+    terminal_ReadAndParse();
+  }
+}
+#endif
+
 /* 
 
 TEST ENVIRONMENTS
@@ -0,0 +1,63 @@
+/**
+ * File: HilController.h
+ * Author: Sarah Masimore
+ * Last Updated Date: 10/18/2026
+ * Description: Interface for compiling a racecar control law into the host
+ *              build instead of wiring the car to the board. The controller
+ *              sees the values the hardware path puts on the pins, quantized
+ *              the same way: each IR's PWM duty from IRSensor_DutyFromMM and
+ *              each Ping's echo period from USSensor_PeriodFromMM. It
+ *              answers with the duties it would drive on the servo and motor
+ *              pins, which go through ServoActuator and MotorActuator as the
+ *              ADC samples of those duties. See tools/SilBench.
+ *
+ *              A controller is one C file defining hil_controller_step,
+ *              linked in place of tools/PingController.c. Keep the structs'
+ *              layout fixed and bump HIL_CONTROLLER_ABI when it changes, so
+ *              controller builds can check they match.
+ */
+
+#ifndef HILCONTROLLER_H
+#define HILCONTROLLER_H
+
+#include <stdint.h>
+
+#define HIL_CONTROLLER_ABI 1
+
+#define HIL_NUM_IR 5 // in IRSensor channel order
+#define HIL_NUM_PING 3 // in USSensor channel order
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Inputs for one controller step. Channels with no sensor read 0.
+ */
+struct sensor_readings {
+	uint32_t time; // us since the run started
+	uint16_t irDuty[HIL_NUM_IR]; // tenths of percent low
+	uint32_t pingPeriod[HIL_NUM_PING]; // echo width, bus cycles
+};
+
+/**
+ * Outputs of one controller step, tenths of percent high. Kept between
+ * steps, so a controller only sets what changes.
+ */
+struct actuator_out {
+	uint16_t servoDuty; // PE3
+	uint16_t pb7Duty; // motor PB7, PE2
+	uint16_t pb6Duty; // motor PB6, PE0
+};
+
+/**
+ * Run the controller once on in and update out.
+ */
+void hil_controller_step(const struct sensor_readings * in,
+                         struct actuator_out * out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // HILCONTROLLER_H
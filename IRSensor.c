@@ -1,7 +1,7 @@
 /**  
  * File: IRSensor.c
  * Author: Sarah Masimore
- * Last Updated Date: 04/19/2018
+ * Last Updated Date: 10/18/2026
  * Description: Manages init'ing and updating IR sensor ports and pins.
  */
  
@@ -15,7 +15,6 @@
 #define CALIBRATION_AT_500MM 18
 #define CALIBRATION_DIST 500
  
-static uint16_t getDutyFromSensorVal(uint32_t val);
 static void setChannelDuty(uint8_t channel, uint16_t duty);
 
  /**
@@ -168,7 +167,7 @@ void IRSensor_Init(struct sensor * sensor) {
 }
 
 void IRSensor_UpdateOutput(struct sensor * sensor) {
-  uint16_t duty = getDutyFromSensorVal(sensor->val);
+  uint16_t duty = IRSensor_DutyFromMM(sensor->val);
   setChannelDuty(sensor->channel, duty);
 }
 
@@ -176,7 +175,7 @@ void IRSensor_UpdateOutput(struct sensor * sensor) {
  * Given value (distance from closest object in path of sensor), determine
  * duty value to pass PWM. Duty is % time low (resolution .1%).
  */
-static uint16_t getDutyFromSensorVal(uint32_t val) {
+uint16_t IRSensor_DutyFromMM(uint32_t val) {
   uint16_t duty;
   
   if (val < IR_MIN_MM || val > IR_MAX_MM) {
@@ -1,7 +1,7 @@
 /**	
  * File: IRSensor.h
  * Author: Sarah Masimore
- * Last Updated Date: 04/19/2018
+ * Last Updated Date: 10/18/2026
  * Description: Manages init'ing and updating IR sensor ports and pins.
  */
  
@@ -26,3 +26,9 @@
 void IRSensor_Init(struct sensor * sensor);
 
 void IRSensor_UpdateOutput(struct sensor * sensor);
+
+/**
+ * Duty (tenths of percent low) IRSensor_UpdateOutput puts on the PWM for a 
+ * sensor val in mm, 0 out of the sensor's range.
+ */
+uint16_t IRSensor_DutyFromMM(uint32_t val);
@@ -0,0 +1,114 @@
+/********** LineBuilder.c ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Fixed capacity line builder for terminal output. See 
+  LineBuilder.h.
+*/
+
+#include <stdint.h>
+#include "LineBuilder.h"
+
+// Two ASCII digits for each value 0-99, so each divide by 100 produces two 
+// characters.
+static const char DigitPairs[200] = {
+  '0','0','0','1','0','2','0','3','0','4','0','5','0','6','0','7','0','8','0','9',
+  '1','0','1','1','1','2','1','3','1','4','1','5','1','6','1','7','1','8','1','9',
+  '2','0','2','1','2','2','2','3','2','4','2','5','2','6','2','7','2','8','2','9',
+  '3','0','3','1','3','2','3','3','3','4','3','5','3','6','3','7','3','8','3','9',
+  '4','0','4','1','4','2','4','3','4','4','4','5','4','6','4','7','4','8','4','9',
+  '5','0','5','1','5','2','5','3','5','4','5','5','5','6','5','7','5','8','5','9',
+  '6','0','6','1','6','2','6','3','6','4','6','5','6','6','6','7','6','8','6','9',
+  '7','0','7','1','7','2','7','3','7','4','7','5','7','6','7','7','7','8','7','9',
+  '8','0','8','1','8','2','8','3','8','4','8','5','8','6','8','7','8','8','8','9',
+  '9','0','9','1','9','2','9','3','9','4','9','5','9','6','9','7','9','8','9','9'
+};
+
+// Most decimal digits in a uint32_t.
+#define MAX_UDEC_DIGITS 10
+
+/**
+ * Empties the line.
+ */
+void LineBuilder_Clear(struct line_builder *line) {
+  line->len = 0;
+}
+
+/**
+ * Appends a null terminated string, truncated at the line's capacity.
+ */
+void LineBuilder_AppendString(struct line_builder *line, const char *str) {
+  uint16_t len = line->len;
+  while (*str && len < LINE_CAPACITY) {
+    line->buf[len++] = *str++;
+  }
+  line->len = len;
+}
+
+/**
+ * Number of decimal digits in value.
+ */
+static uint16_t numDigits(uint32_t value) {
+  if (value < 10) return 1;
+  if (value < 100) return 2;
+  if (value < 1000) return 3;
+  if (value < 10000) return 4;
+  if (value < 100000) return 5;
+  if (value < 1000000) return 6;
+  if (value < 10000000) return 7;
+  if (value < 100000000) return 8;
+  if (value < 1000000000) return 9;
+  return 10;
+}
+
+/**
+ * Appends an unsigned value in decimal. Digits are written two at a time,
+ * least significant first, straight into the line. If the value doesn't fit,
+ * it's formatted in a scratch buffer and truncated from there.
+ */
+void LineBuilder_AppendUDec(struct line_builder *line, uint32_t value) {
+  char digits[MAX_UDEC_DIGITS];
+  uint16_t num = numDigits(value);
+  uint16_t len = line->len;
+  char *end;
+  uint32_t pair;
+  int i;
+  
+  end = (len + num <= LINE_CAPACITY) ? &line->buf[len + num] : &digits[num];
+  while (value >= 100) {
+    pair = (value % 100) * 2;
+    value /= 100;
+    *--end = DigitPairs[pair + 1];
+    *--end = DigitPairs[pair];
+  }
+  if (value >= 10) {
+    *--end = DigitPairs[value * 2 + 1];
+    *--end = DigitPairs[value * 2];
+  } else {
+    *--end = '0' + value;
+  }
+  
+  if (end == digits) {
+    for (i = 0; i < num && len < LINE_CAPACITY; i++) {
+      line->buf[len++] = digits[i];
+    }
+    line->len = len;
+  } else {
+    line->len = len + num;
+  }
+}
+
+/**
+ * Appends a signed value in decimal. The magnitude is taken as unsigned so
+ * INT32_MIN prints correctly.
+ */
+void LineBuilder_AppendDec(struct line_builder *line, int32_t value) {
+  if (value < 0) {
+    if (line->len < LINE_CAPACITY) {
+      line->buf[line->len++] = '-';
+    }
+    LineBuilder_AppendUDec(line, 0u - (uint32_t)value);
+  } else {
+    LineBuilder_AppendUDec(line, value);
+  }
+}
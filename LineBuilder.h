@@ -0,0 +1,53 @@
+/********** LineBuilder.h ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Builds a line of terminal output in a fixed buffer, so it can
+  be sent to the UART with one bulk FIFO put (see terminal_printLine). 
+  Appends past the capacity are truncated.
+*/
+#ifndef LINEBUILDER_H
+#define LINEBUILDER_H
+
+#include <stdint.h>
+
+// Longest line, in characters. Fits a dataOut frame.
+#define LINE_CAPACITY 192
+
+struct line_builder {
+  uint16_t len;
+  char buf[LINE_CAPACITY];
+};
+
+/**************LineBuilder_Clear***************
+ Empties the line.
+ Inputs : line - line to clear
+ Outputs: none
+*/
+void LineBuilder_Clear(struct line_builder *line);
+
+/**************LineBuilder_AppendString***************
+ Appends a null terminated string.
+ Inputs : line - line to append to
+          str - string to append
+ Outputs: none
+*/
+void LineBuilder_AppendString(struct line_builder *line, const char *str);
+
+/**************LineBuilder_AppendUDec***************
+ Appends an unsigned value in decimal.
+ Inputs : line - line to append to
+          value - value to append
+ Outputs: none
+*/
+void LineBuilder_AppendUDec(struct line_builder *line, uint32_t value);
+
+/**************LineBuilder_AppendDec***************
+ Appends a signed value in decimal, with a leading '-' if negative.
+ Inputs : line - line to append to
+          value - value to append
+ Outputs: none
+*/
+void LineBuilder_AppendDec(struct line_builder *line, int32_t value);
+
+#endif
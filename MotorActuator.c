@@ -1,32 +1,67 @@
 /**  
  * File: MotorActuator.c
  * Author: Sarah Masimore
- * Last Updated Date: 04/22/2018
+ * Last Updated Date: 10/18/2026
  * Description: Inits and reads input capture and pins to determine robot velocity.
  * NOTE: currently PB6 not reading expected values so assuming fwd at constant speed.
+ *       MOTOR_INPUT_CAPTURE reads the raw PWM instead (see MotorCapture.h).
  */
  
 #include "MotorActuator.h"
-#include "ADC.h"
+#include "ActuatorTrace.h"
+#include "MotorCapture.h"
 #include "Simulator.h"
+#include "terminal.h"
 
 #define MOTORS_IN_PARALLEL_MODE
 
 #define MAX_VELOCITY 1114 // mm/s, measured car's velocity at max pwm
+#define PARALLEL_FWD_DUTY 999 // tenths of percent, assumed in parallel mode
+#define PARALLEL_REV_DUTY 700
 #define PB7_ADC_CHANNEL 1
 #define PB6_ADC_CHANNEL 3 // channel 2, PE1 not working
 
 extern struct live_data LiveData;
 
+// Printed by tools/MotorFit for tau = 150 ms, max accel = 4000 mm/s^2.
+// These are starting values, not yet fit to a logged run of the car.
+static const struct motor_coeffs MotorCoeffs[] = {
+  {1, 435, 1024},
+  {5, 2149, 5120},
+  {10, 4227, 10240},
+  {20, 8181, 20480},
+  {50, 18577, 51200},
+  {100, 31889, 102400},
+};
+
+#ifdef MOTOR_DYNAMICS
+static struct motor_model DriveMotor; // left wheel with DIFF_DRIVE
+static struct motor_model RightMotor;
+#endif
+
 static int32_t getVelocityFromDuty(uint32_t adc_val, uint8_t forward);
+static int32_t getTargetVelocity(void);
+static void readDuties(int32_t * pb7_duty, int32_t * pb6_duty);
 
 /**
  * Initializes ADC and pins for reading motor voltage and h-bridge to determine
  * direction.
  */
 void MotorActuator_Init(void) {
-  ADC_Open(PB7_ADC_CHANNEL);
-  ADC_Open(PB6_ADC_CHANNEL);
+#ifdef MOTOR_INPUT_CAPTURE
+  MotorCapture_Init();
+#else
+  ActuatorTrace_Open(PB7_ADC_CHANNEL);
+  ActuatorTrace_Open(PB6_ADC_CHANNEL);
+#endif
+#ifdef MOTOR_DYNAMICS
+  // Stepping a model with no coefficients would read through a null pointer.
+  if (MotorModel_Init(&DriveMotor, MS_PER_SIM_TICK) != E_SUCCESS ||
+      MotorModel_Init(&RightMotor, MS_PER_SIM_TICK) != E_SUCCESS) {
+    terminal_fatalErrorHandler(E_INVALID_PARAM, 
+      "No motor coefficients for MS_PER_SIM_TICK, run tools/MotorFit");
+  }
+#endif
 }
 
 /**
@@ -34,25 +69,86 @@ void MotorActuator_Init(void) {
  * state and differential motor speeds are ignored. 
  */
 int32_t MotorActuator_GetVelocity(void) {
-  int32_t pb7_duty = ADC_In(PB7_ADC_CHANNEL) * 1000 / 4096; 
-  int32_t pb6_duty = ADC_In(PB6_ADC_CHANNEL) * 1000 / 4096; 
+#ifdef MOTOR_DYNAMICS
+  return MotorModel_Step(&DriveMotor, getTargetVelocity());
+#else
+  return getTargetVelocity();
+#endif
+}
 
-  // Print to terminal for debugging
-  LiveData.motorPB7Duty = pb7_duty;
-  LiveData.motorPB6Duty = pb6_duty;
+/**
+ * Differential drive: each motor's PWM drives one wheel forward, PB7 the
+ * left and PB6 the right.
+ */
+void MotorActuator_GetWheelVelocities(int32_t * left, int32_t * right) {
+  int32_t pb7_duty, pb6_duty;
+  
+  readDuties(&pb7_duty, &pb6_duty);
+  *left = getVelocityFromDuty(pb7_duty, 1);
+  *right = getVelocityFromDuty(pb6_duty, 1);
+#ifdef MOTOR_DYNAMICS
+  *left = MotorModel_Step(&DriveMotor, *left);
+  *right = MotorModel_Step(&RightMotor, *right);
+#endif
+}
+
+/**
+ * Start model at rest with the coefficients for msPerTick.
+ */
+ErrorCode_t MotorModel_Init(struct motor_model * model, uint32_t msPerTick) {
+  uint8_t i;
+  
+  for (i = 0; i < sizeof(MotorCoeffs) / sizeof(MotorCoeffs[0]); i++) {
+    if (MotorCoeffs[i].msPerTick == msPerTick) {
+      model->coeffs = &MotorCoeffs[i];
+      model->vel = 0;
+      return E_SUCCESS;
+    }
+  }
+  return E_INVALID_PARAM;
+}
+
+/**
+ * vel += alpha * (target - vel), with the change held to maxStep. alpha is 
+ * the exact first-order lag over a tick with the target held, so the model
+ * doesn't depend on tick length except where the acceleration limit kicks 
+ * in.
+ */
+int32_t MotorModel_Step(struct motor_model * model, int32_t target) {
+  int32_t maxStep = model->coeffs->maxStep;
+  int32_t error = target * (1 << MOTOR_VEL_FRAC_BITS) - model->vel;
+  int32_t step = (int32_t)((int64_t)error * model->coeffs->alpha >> 16);
+  
+  if (step > maxStep) {
+    step = maxStep;
+  } else if (step < -maxStep) {
+    step = -maxStep;
+  }
+  model->vel += step;
+  return (model->vel + (1 << (MOTOR_VEL_FRAC_BITS - 1))) >> 
+         MOTOR_VEL_FRAC_BITS;
+}
+
+/**
+ * Velocity the motor duty would settle at.
+ */
+static int32_t getTargetVelocity(void) {
+  int32_t pb7_duty, pb6_duty;
+  
+  readDuties(&pb7_duty, &pb6_duty);
 	
 #ifdef MOTORS_IN_PARALLEL_MODE
   // Robot moving forwards.
   if (pb7_duty >= pb6_duty) {
     // When running hw actuators in parallel, pin is pulled down. Set as full speed.
     // When not running them in parallel use PB6 duty.
-    return getVelocityFromDuty(999, 1);
+    return getVelocityFromDuty(PARALLEL_FWD_DUTY, 1);
   }
   
   // Robog moving backwards.
   // When running hw actuators in parallel, pin is pulled down. Set as 70% speed.
   // When not running them in parallel use PB7 duty.
-  return getVelocityFromDuty(700, 0);
+  return getVelocityFromDuty(PARALLEL_REV_DUTY, 0);
 #endif
   
   // Robot moving forwards.
@@ -64,6 +160,23 @@ int32_t MotorActuator_GetVelocity(void) {
   return getVelocityFromDuty(pb7_duty, 0);
 }
 
+/**
+ * Reads both motor duties (in tenth of percent) and logs them.
+ */
+static void readDuties(int32_t * pb7_duty, int32_t * pb6_duty) {
+#ifdef MOTOR_INPUT_CAPTURE
+  *pb7_duty = MotorCapture_GetDuty(MOTOR_CAPTURE_PB7);
+  *pb6_duty = MotorCapture_GetDuty(MOTOR_CAPTURE_PB6);
+#else
+  *pb7_duty = ActuatorTrace_In(PB7_ADC_CHANNEL) * 1000 / 4096; 
+  *pb6_duty = ActuatorTrace_In(PB6_ADC_CHANNEL) * 1000 / 4096; 
+#endif
+
+  // Print to terminal for debugging
+  LiveData.motorPB7Duty = *pb7_duty;
+  LiveData.motorPB6Duty = *pb6_duty;
+}
+
 /**
  * Determine velocity from duty (in tenth of percent). If going backwards, return the negative 
  * vel.
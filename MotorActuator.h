@@ -1,11 +1,43 @@
 /**	
  * File: MotorActuator.h
  * Author: Sarah Masimore
- * Last Updated Date: 04/22/2018
+ * Last Updated Date: 10/18/2026
  * Description: Manages init'ing ADC and pins to read motor values.
  */
+
+#ifndef MOTORACTUATOR_H
+#define MOTORACTUATOR_H
  
  #include <stdint.h>
+ #include "ErrorCodes.h"
+
+// Uncomment so velocity follows duty through a first-order lag with an
+// acceleration limit instead of jumping to it each tick.
+//#define MOTOR_DYNAMICS
+#define MOTOR_VEL_FRAC_BITS 8 // model velocity is mm/s / 2^8
+
+// Uncomment to read motor duty from the raw PWM with input capture (see
+// MotorCapture.h) instead of the RC filtered voltage on the ADC. Motor 
+// samples are then not recorded or replayed by ActuatorTrace.
+//#define MOTOR_INPUT_CAPTURE
+
+/**
+ * Coefficients for one tick length, from tools/MotorFit. alpha is 
+ * 1 - exp(-dt / tau) in Q16 and maxStep is max accel * dt, fine mm/s.
+ */
+struct motor_coeffs {
+	uint16_t msPerTick;
+	uint16_t alpha;
+	int32_t maxStep;
+};
+
+/**
+ * One motor's velocity response, stepped once per sim tick.
+ */
+struct motor_model {
+	const struct motor_coeffs * coeffs;
+	int32_t vel; // mm/s / 2^MOTOR_VEL_FRAC_BITS
+};
 
 /**
  * Initializes ADC and pins for reading motor voltage and h-bridge to determine
@@ -14,6 +46,27 @@
 void MotorActuator_Init(void);
 
 /**
- * Reads ADC and H-bridge values to determine velocity. 
+ * Reads ADC and H-bridge values to determine velocity. With MOTOR_DYNAMICS,
+ * the velocity at the end of this tick as the motor responds to the duty.
  */
 int32_t MotorActuator_GetVelocity(void);
+
+/**
+ * Differential drive: left wheel velocity from PB7 duty and right from PB6,
+ * forward only, in mm/s. With MOTOR_DYNAMICS each wheel has its own model.
+ */
+void MotorActuator_GetWheelVelocities(int32_t * left, int32_t * right);
+
+/**
+ * Start model at rest with the coefficients for msPerTick. Returns 
+ * E_INVALID_PARAM if MotorFit made none for that tick length.
+ */
+ErrorCode_t MotorModel_Init(struct motor_model * model, uint32_t msPerTick);
+
+/**
+ * Move model one tick toward target (mm/s) and return its velocity in mm/s.
+ * Integer only, so host and target runs match bit for bit.
+ */
+int32_t MotorModel_Step(struct motor_model * model, int32_t target);
+
+#endif // MOTORACTUATOR_H
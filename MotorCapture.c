@@ -0,0 +1,132 @@
+/**
+ * File: MotorCapture.c
+ * Author: Sarah Masimore
+ * Last Updated Date: 10/18/2026
+ * Description: Wide timer input capture of motor PWM. See MotorCapture.h.
+ *
+ *              The edge interrupt reads the pin to tell a rising edge from a
+ *              falling one, so high and low times must be longer than its
+ *              latency (about 1 us, a tenth of a percent at 1 kHz). Shorter
+ *              pulses read as 0 or 100%.
+ */
+
+#include "tm4c123gh6pm.h"
+#include "MotorCapture.h"
+
+#define PC6 0x40
+#define PC7 0x80
+
+/**
+ * Edge times are the timer's count, which wraps every 2^32 cycles (53 s),
+ * so differences are taken mod 2^32.
+ */
+struct capture_channel {
+	uint32_t lastRise; // count at the last rising edge
+	uint32_t lastEdge;
+	uint32_t period; // cycles from the rise before lastRise to lastRise
+	uint8_t haveRise; // lastRise is valid
+	uint8_t haveEdge;
+	uint16_t duty; // tenths of percent, written only by the edge interrupt
+};
+
+static volatile struct capture_channel Channels[MOTOR_CAPTURE_CHANNELS];
+
+static void recordEdge(volatile struct capture_channel * channel,
+                       uint32_t time, uint8_t level);
+
+/**
+ * Inits PC6 and PC7 as WT1CCP0 and WT1CCP1, and Wide Timer 1 A and B in
+ * count up, edge time mode on both edges.
+ */
+void MotorCapture_Init(void) {
+  volatile unsigned long delay;
+
+  SYSCTL_RCGCWTIMER_R |= 0x02; // Activate wide timer 1
+  SYSCTL_RCGCGPIO_R |= 0x04; // Init Port C
+  delay = SYSCTL_RCGCGPIO_R; // Noop to allow time to finish init'ing
+
+  GPIO_PORTC_DIR_R &= ~(PC6 | PC7); // Inputs
+  GPIO_PORTC_AFSEL_R |= PC6 | PC7; // Enable alternate function
+  GPIO_PORTC_PCTL_R &= ~0xFF000000; // Clear PC6, PC7
+  GPIO_PORTC_PCTL_R |= GPIO_PCTL_PC6_WT1CCP0 | GPIO_PCTL_PC7_WT1CCP1;
+  GPIO_PORTC_AMSEL_R &= ~(PC6 | PC7); // Disable analog functionality
+  GPIO_PORTC_DEN_R |= PC6 | PC7; // Enable digital I/O
+
+  WTIMER1_CTL_R = 0; // Disable while configuring
+  WTIMER1_CFG_R = TIMER_CFG_16_BIT; // Split into two 32-bit timers
+  WTIMER1_TAMR_R = TIMER_TAMR_TACDIR | TIMER_TAMR_TACMR | TIMER_TAMR_TAMR_CAP;
+  WTIMER1_TBMR_R = TIMER_TBMR_TBCDIR | TIMER_TBMR_TBCMR | TIMER_TBMR_TBMR_CAP;
+  WTIMER1_TAILR_R = 0xFFFFFFFF; // Count through all 32 bits
+  WTIMER1_TBILR_R = 0xFFFFFFFF;
+  WTIMER1_TAPR_R = 0; // No prescale, edge times in bus cycles
+  WTIMER1_TBPR_R = 0;
+  WTIMER1_ICR_R = TIMER_ICR_CAECINT | TIMER_ICR_CBECINT; // Clear flags
+  WTIMER1_IMR_R = TIMER_IMR_CAEIM | TIMER_IMR_CBEIM; // Arm interrupts
+
+  // Interrupts 96 and 97, priority 1 so edges aren't held up by sensors.
+  NVIC_PRI24_R = (NVIC_PRI24_R & ~0xE0E0) | 0x2020;
+  NVIC_EN3_R |= 0x3;
+
+  WTIMER1_CTL_R = TIMER_CTL_TAEVENT_BOTH | TIMER_CTL_TBEVENT_BOTH |
+                  TIMER_CTL_TAEN | TIMER_CTL_TBEN;
+}
+
+/**
+ * Duty of channel's last full PWM cycle, or the steady level.
+ */
+uint16_t MotorCapture_GetDuty(uint8_t channel) {
+  volatile struct capture_channel * c = &Channels[channel];
+  uint32_t now = channel == MOTOR_CAPTURE_PB6 ? WTIMER1_TAV_R : WTIMER1_TBV_R;
+
+  if (!c->haveEdge || now - c->lastEdge > MOTOR_CAPTURE_STALE_CYCLES) {
+    return (channel == MOTOR_CAPTURE_PB6 ? GPIO_PORTC_DATA_R & PC6 :
+            GPIO_PORTC_DATA_R & PC7) ? 1000 : 0;
+  }
+  return c->duty;
+}
+
+/**
+ * Edge on PC6, racecar PB6.
+ */
+void WideTimer1A_Handler(void) {
+  WTIMER1_ICR_R = TIMER_ICR_CAECINT; // Acknowledge
+  recordEdge(&Channels[MOTOR_CAPTURE_PB6], WTIMER1_TAR_R,
+             (GPIO_PORTC_DATA_R & PC6) != 0);
+}
+
+/**
+ * Edge on PC7, racecar PB7.
+ */
+void WideTimer1B_Handler(void) {
+  WTIMER1_ICR_R = TIMER_ICR_CBECINT; // Acknowledge
+  recordEdge(&Channels[MOTOR_CAPTURE_PB7], WTIMER1_TBR_R,
+             (GPIO_PORTC_DATA_R & PC7) != 0);
+}
+
+/**
+ * A rise ends a period, a fall ends the high time and sets the duty from
+ * it and the period just before. Duty is one 16-bit store, so readers
+ * never see half an update.
+ */
+static void recordEdge(volatile struct capture_channel * channel,
+                       uint32_t time, uint8_t level) {
+  uint32_t high;
+
+  if (level) {
+    channel->period = channel->haveRise ? time - channel->lastRise : 0;
+    channel->lastRise = time;
+    channel->haveRise = 1;
+  } else if (channel->haveRise && channel->period != 0 &&
+             channel->period <= MOTOR_CAPTURE_STALE_CYCLES) {
+    // A pin held high isn't a cycle. Otherwise jitter can make high a 
+    // little longer than the period before it.
+    high = time - channel->lastRise;
+    if (high <= MOTOR_CAPTURE_STALE_CYCLES) {
+      high = high > channel->period ? channel->period : high;
+      channel->duty = high * 1000 / channel->period;
+    }
+  }
+
+  channel->lastEdge = time;
+  channel->haveEdge = 1;
+}
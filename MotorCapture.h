@@ -0,0 +1,39 @@
+/**
+ * File: MotorCapture.h
+ * Author: Sarah Masimore
+ * Last Updated Date: 10/18/2026
+ * Description: Measures the racecar's motor PWM (its PB6 and PB7) with wide
+ *              timer input capture instead of averaging the RC filtered
+ *              voltage on the ADC. The unfiltered signals go to PC6
+ *              (WT1CCP0, racecar PB6) and PC7 (WT1CCP1, racecar PB7). Each
+ *              edge is timestamped by Wide Timer 1 counting up at the bus
+ *              clock, and its interrupt updates the duty, so reading it
+ *              costs nothing and it is at most one PWM period old.
+ */
+
+#ifndef MOTORCAPTURE_H
+#define MOTORCAPTURE_H
+
+#include <stdint.h>
+
+#define MOTOR_CAPTURE_PB6 0
+#define MOTOR_CAPTURE_PB7 1
+#define MOTOR_CAPTURE_CHANNELS 2
+
+// No edge for this long means the pin is held high or low (0 or 100% duty).
+// Also the longest PWM period measured, so PWM must be at least 100 Hz.
+#define MOTOR_CAPTURE_STALE_CYCLES 800000 // 10 ms at 80 MHz
+
+/**
+ * Inits PC6 and PC7 and Wide Timer 1 A and B to time both edges of each
+ * signal.
+ */
+void MotorCapture_Init(void);
+
+/**
+ * Duty of channel's last full PWM cycle in tenths of percent, 0 - 1000.
+ * 0 or 1000 if the pin has been steady for MOTOR_CAPTURE_STALE_CYCLES.
+ */
+uint16_t MotorCapture_GetDuty(uint8_t channel);
+
+#endif // MOTORCAPTURE_H
@@ -15,6 +15,12 @@
 #include "unitConvert.h"
 #include "getHighest.h"
 #include "OSAux.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "StackPool.h"
+#ifdef HOST_BUILD
+#include "OSHost.h"
+#endif
 
 extern TCB_t * Current_Thread;
 
@@ -22,17 +28,21 @@ uint32_t StartCritical(void);
 void EndCritical(uint32_t oldState);
 void DisableInterrupts(void);
 void EnableInterrupts(void);
+void WaitForInterrupt(void);
 void StartOS(void);
 
 uint8_t OSLaunched = 0;
 
 // Periodic threads
+#ifndef HOST_BUILD
 static void (*PeriodicTask)(void) = 0;
+#endif
 unsigned long Period = 0;
 
 uint32_t TimeSliceCycles;
 extern uint32_t Systick_Calls;
 
+
 void initSystemClockTimer(void);
 
 // Running thread structure
@@ -43,16 +53,25 @@ uint32_t priorityOccupied;
 TCB_t * InactiveThreads = 0;
 TCB_t * SleepThreads = 0;
 
-// Allocate memory
+// Allocate memory. Stacks come from StackPool.
 TCB_t TCBs[MAX_THREADS];
-uint32_t ThreadStacks[MAX_THREADS][STACK_SIZE];
+
+/**************idleThread***************
+Description: Runs when no other thread is ready. Sleeps until the next 
+  interrupt.
+*/
+static void idleThread(void) {
+  while (1) {
+    WaitForInterrupt();
+  }
+}
 
 void initStack(TCB_t* TCBPt, void (*task)(void)){
   uint32_t* TCBstackPt;
-  TCBPt->stackPointer = &ThreadStacks[TCBPt->tid][STACK_SIZE];
+  TCBPt->stackPointer = TCBPt->stackBase + TCBPt->stackWords;
   TCBstackPt = TCBPt->stackPointer;
   *(--TCBstackPt) = 0x01000000;     // thumb bit
-  *(--TCBstackPt) = (uint32_t)task;  // user task
+  *(--TCBstackPt) = (uint32_t)(uintptr_t)task;  // user task
   *(--TCBstackPt) = 0x14141414;     // R14
   *(--TCBstackPt) = 0x12121212;     // R12
   *(--TCBstackPt) = 0x03030303;     // R3
@@ -68,6 +87,9 @@ void initStack(TCB_t* TCBPt, void (*task)(void)){
   *(--TCBstackPt) = 0x05050505;      // R5
   *(--TCBstackPt) = 0x04040404;      // R4
   TCBPt->stackPointer -= 16;
+#ifdef HOST_BUILD
+  OSHost_InitContext(TCBPt, task);
+#endif
 }
 
 /**************OS_Init***************
@@ -77,41 +99,47 @@ Outputs: ErrorCode
 */
 ErrorCode_t OS_Init(void) { 
   int iii;
+#ifndef HOST_BUILD
   PLL_Init(Bus80MHz);
+  // Cycle counter for per-thread CPU accounting in Pack_Context
+  DEMCR_R |= DEMCR_TRCENA;
+  DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+#endif
+#ifdef PROFILE_CRITICAL
+  Profiler_Init();
+#endif
   // loop through threads and create I ll
   TCBs[0].prevTCB = &TCBs[MAX_THREADS-1];
   for(iii = 0; iii < MAX_THREADS; iii++){
-    terminal_printMessage("Initializing TCB ", 0);
     TCBs[iii].tid = iii;
-    TCBs[iii].stackPointer = &ThreadStacks[iii][STACK_SIZE];
-    terminal_printValue(iii);
-    terminal_printMessage("Previous TCB address is ", 0);
-    terminal_printValue((uint32_t)(TCBs[iii].prevTCB));
-    terminal_printMessage("Current TCB address is ", 0);
-    terminal_printValue((uint32_t)(&TCBs[iii]));
+    TCBs[iii].stackPointer = 0;
+    TCBs[iii].stackBase = 0;
+    TCBs[iii].stackWords = 0;
+    TCBs[iii].stackHighWater = 0;
+    TCBs[iii].runCycles = 0;
+    TRACE_INFO(TRACE_TCB_INIT, iii, &TCBs[iii]);
     if(iii == MAX_THREADS - 1){
       break;
     }
     
     TCBs[iii].nextTCB = &TCBs[iii+1];
-    
-    terminal_printMessage("Next TCB address is ", 0);
-    terminal_printValue((uint32_t)(TCBs[iii].nextTCB));
-    
     TCBs[iii+1].prevTCB = &TCBs[iii];
   }
   TCBs[MAX_THREADS-1].nextTCB = &TCBs[0];
-  terminal_printMessage("Next TCB address is ", 0);
-  terminal_printValue((uint32_t)(TCBs[MAX_THREADS-1].nextTCB));
 
   InactiveThreads = &TCBs[0];
-  terminal_printMessage("Initialization successful!", 0);
+  StackPool_Init();
+  TRACE_INFO(TRACE_OS_INIT_DONE, MAX_THREADS, 0);
+  
+  OS_AddThread(&idleThread, 256, IDLE_PRIORITY);
   
   initSystemClockTimer();
   
   return E_SUCCESS;
 }
 
+// Host builds use a virtual clock, see OSHost.c.
+#ifndef HOST_BUILD
 void initSystemClockTimer(void) {
   volatile int delay;
   
@@ -124,22 +152,40 @@ void initSystemClockTimer(void) {
   WTIMER0_TAMR_R |= (TIMER_TAMR_TACDIR | TIMER_TAMR_TAMR_1_SHOT);
   WTIMER0_CTL_R |= TIMER_CTL_TAEN;
 }
+#endif
 
 /**************OS_AddThread***************
 Description: Adds thread.
-Inputs: none
-Outputs: 1 if successful
+Inputs: task - thread entry point
+        stackSize - stack size in bytes, rounded up to a StackPool size class
+        priority - 0 is highest
+Outputs: 1 if successful, 0 if no TCBs or stacks are free
 */
 unsigned long OS_AddThread(void (*task)(void), unsigned long stackSize, unsigned long priority) {
   TCB_t* newTCB;
-  uint8_t newTID, prevTID, nextTID;
+#if TRACE_LEVEL >= TRACE_LEVEL_ADVISORY
+  uint8_t newTID;
+#endif
+#if TRACE_LEVEL >= TRACE_LEVEL_INFO
+  uint8_t prevTID, nextTID;
+#endif
   uint32_t oldIntrState;
-  terminal_printMessage("Adding new thread", 0);
+  uint32_t * stackBase;
+  uint16_t stackWords;
+  
+  stackBase = StackPool_Alloc(stackSize, &stackWords);
+  if (stackBase == 0){
+    TRACE_CRITICAL(TRACE_NO_STACK, stackSize, priority);
+    return 0;
+  }
+  
   // There is the possibility of a critical section if two threads are being created or destroyed at the same time.
-  oldIntrState = StartCritical();
+  oldIntrState = PROFILED_START_CRITICAL(CS_ADD_THREAD_ALLOC);
   if (InactiveThreads == 0){
-    EndCritical(oldIntrState);
-    terminal_printMessage("Failed to add thread!", 3);
+    PROFILED_END_CRITICAL(CS_ADD_THREAD_ALLOC, oldIntrState);
+    StackPool_Free(stackBase, stackWords);
+    TRACE_CRITICAL(TRACE_ADD_THREAD_FAILED, task, priority);
+    return 0;
   }
   
   newTCB = InactiveThreads;
@@ -152,43 +198,38 @@ unsigned long OS_AddThread(void (*task)(void), unsigned long stackSize, unsigned
     InactiveThreads = 0;
   }
   
-  EndCritical(oldIntrState);
+  PROFILED_END_CRITICAL(CS_ADD_THREAD_ALLOC, oldIntrState);
   
   newTCB->priority = priority;
+  newTCB->basePriority = priority;
+  newTCB->blockedOn = 0;
+  newTCB->heldMutexes = 0;
+  newTCB->stackBase = stackBase;
+  newTCB->stackWords = stackWords;
   initStack(newTCB, task);
   
-  oldIntrState = StartCritical();
-  if (ReadyThreads[priority] == 0){
-    ReadyThreads[priority] = newTCB;
-    priorityOccupied |= 1 << (NUM_PRIORITY_LEVELS - priority - 1);
-    newTCB->prevTCB = newTCB;
-    newTCB->nextTCB = newTCB;
-  }
-  else{
-    newTCB->prevTCB = ReadyThreads[priority]->prevTCB;
-    newTCB->nextTCB = ReadyThreads[priority];
-    ReadyThreads[priority]->prevTCB->nextTCB = newTCB;
-    ReadyThreads[priority]->prevTCB = newTCB;
-  }
+  oldIntrState = PROFILED_START_CRITICAL(CS_ADD_THREAD_READY);
+  OSAux_ReadyInsert(newTCB);
   
+  // Neighbors read inside the critical section, only for the trace.
+#if TRACE_LEVEL >= TRACE_LEVEL_ADVISORY
   newTID = newTCB->tid;
+#endif
+#if TRACE_LEVEL >= TRACE_LEVEL_INFO
   prevTID = newTCB->prevTCB->tid;
   nextTID = newTCB->nextTCB->tid;
-  EndCritical(oldIntrState);
+#endif
+  PROFILED_END_CRITICAL(CS_ADD_THREAD_READY, oldIntrState);
   
   if (InactiveThreads == 0){
-    terminal_printMessage("No remaining inactive threads", 1);
+    TRACE_ADVISORY(TRACE_NO_INACTIVE, newTID, 0);
   }
-  terminal_printMessage("Successfully added new thread with TID ", 0);
-  terminal_printValue(newTID);
-  terminal_printMessage("Previous thread has TID ", 0);
-  terminal_printValue(prevTID);
-  terminal_printMessage("Next thread has TID ", 0);
-  terminal_printValue(nextTID);
+  TRACE_INFO(TRACE_ADD_THREAD, newTID, (prevTID << 8) | nextTID);
   
   return 1;
 }
 
+#ifndef HOST_BUILD
 /**************OS_AddPeriodicThread***************
 Description: Initializes periodic timer thread.
 Inputs:
@@ -244,9 +285,109 @@ Inputs: none
 Outputs: none
 */
 void Timer5A_Handler(void) {
+#ifdef PROFILE_CRITICAL
+  // Periodic down-counter reloads on timeout, so the elapsed count is the 
+  // entry latency.
+  Profiler_RecordLatency(ISR_TIMER5, TIMER5_TAILR_R - TIMER5_TAR_R);
+#endif
   TIMER5_ICR_R = 0x1; // Acknowledge
   (*PeriodicTask)(); // Execute user task
 }
+#endif
+
+/**************inThreadMode***************
+Description: Returns 1 if called from a foreground thread, 0 if from an ISR.
+*/
+static uint8_t inThreadMode(void) {
+#ifdef HOST_BUILD
+  return !OSHost_InInterrupt();
+#else
+  return (NVIC_INT_CTRL_R & NVIC_INT_CTRL_VEC_ACT_M) == 0;
+#endif
+}
+
+/**************yieldIfPreempted***************
+Description: After waking a thread or dropping priority, lets a higher 
+  priority ready thread run now instead of at the next time slice. Does 
+  nothing in an ISR since the scheduler will run when it returns.
+*/
+static void yieldIfPreempted(void) {
+  if (inThreadMode() && getHighestPriority() < Current_Thread->priority) {
+    OS_Suspend();
+  }
+}
+
+// ******** OS_InitSemaphore ************
+// initialize semaphore, with no blocked threads or owner
+// input:  pointer to a semaphore, initial value (1 for a mutex)
+// output: none
+void OS_InitSemaphore(Sema4Type *semaPt, long value) {
+  int iii;
+  semaPt->Value = value;
+  for (iii = 0; iii < NUM_PRIORITY_LEVELS; iii++) {
+    semaPt->Queue[iii] = 0;
+  }
+  semaPt->priorityWaiting = 0;
+  semaPt->owner = 0;
+  semaPt->nextHeld = 0;
+}
+
+// ******** OS_Signal ************
+// increment semaphore, wake highest priority waiter if any
+// can be called from background threads
+// input:  pointer to a counting semaphore
+// output: none
+void OS_Signal(Sema4Type *semaPt) {
+  uint32_t oldIntrState = PROFILED_START_CRITICAL(CS_SIGNAL);
+  semaPt->Value++;
+  if (semaPt->Value <= 0 && semaPt->priorityWaiting) {
+    restoreBlockedThread(semaPt);
+  }
+  PROFILED_END_CRITICAL(CS_SIGNAL, oldIntrState);
+  yieldIfPreempted();
+}
+
+// ******** OS_bSignal ************
+// wake highest priority waiter if any, otherwise set to 1
+// can be called from background threads
+// input:  pointer to a binary semaphore
+// output: none
+void OS_bSignal(Sema4Type *semaPt) {
+  uint32_t oldIntrState = PROFILED_START_CRITICAL(CS_BSIGNAL);
+  if (semaPt->priorityWaiting) {
+    restoreBlockedThread(semaPt);
+  } else {
+    semaPt->Value = 1;
+  }
+  PROFILED_END_CRITICAL(CS_BSIGNAL, oldIntrState);
+  yieldIfPreempted();
+}
+
+// ******** OS_MutexUnlock ************
+// unlock a mutex held by the calling thread, passing ownership to the highest
+// priority waiter, and drop the priority inherited through it
+// input:  pointer to a mutex
+// output: none
+void OS_MutexUnlock(Sema4Type *semaPt) {
+  uint32_t oldIntrState = PROFILED_START_CRITICAL(CS_MUTEX_UNLOCK);
+  if (semaPt->owner != Current_Thread) {
+    PROFILED_END_CRITICAL(CS_MUTEX_UNLOCK, oldIntrState);
+    TRACE_WARNING(TRACE_MUTEX_NOT_OWNER, semaPt, Current_Thread->tid);
+    return;
+  }
+  
+  OSAux_ReleaseMutex(Current_Thread, semaPt);
+  
+  if (semaPt->priorityWaiting) {
+    semaPt->owner = restoreBlockedThread(semaPt);
+    OSAux_HoldMutex(semaPt->owner, semaPt);
+  } else {
+    semaPt->owner = 0;
+    semaPt->Value = 1;
+  }
+  PROFILED_END_CRITICAL(CS_MUTEX_UNLOCK, oldIntrState);
+  yieldIfPreempted();
+}
 
 //******** OS_Id *************** 
 // returns the thread ID for the currently running thread
@@ -256,6 +397,7 @@ unsigned long OS_Id(void) {
   return ReadyThreads[getHighestPriority()]->tid;
 }
 
+#ifndef HOST_BUILD
 // ******** OS_Sleep ************
 // place this thread into a dormant state
 // input:  number of msec to sleep
@@ -280,6 +422,36 @@ void OS_Kill(void) {
   }
 }
 
+// ******** OS_Wait ************
+// decrement semaphore, block if less than zero
+// input:  pointer to a counting semaphore
+// output: none
+void OS_Wait(Sema4Type *semaPt) {
+  __asm{
+    SVC #3, {r0=semaPt}
+  }
+}
+
+// ******** OS_bWait ************
+// clear semaphore if set, otherwise block until signalled
+// input:  pointer to a binary semaphore
+// output: none
+void OS_bWait(Sema4Type *semaPt) {
+  __asm{
+    SVC #4, {r0=semaPt}
+  }
+}
+
+// ******** OS_MutexLock ************
+// lock a mutex, block and lend our priority to its owner if already locked
+// input:  pointer to a mutex
+// output: none
+void OS_MutexLock(Sema4Type *semaPt) {
+  __asm{
+    SVC #5, {r0=semaPt}
+  }
+}
+
 // ******** OS_Suspend ************
 // suspend execution of currently running thread
 // scheduler will choose another thread to execute
@@ -315,6 +487,7 @@ uint64_t OS_Time(void) {
   currentTime += lowBits;
   return currentTime;
 }
+#endif
 
 // ******** OS_TimeDifference ************
 // Calculates difference between two times
@@ -329,12 +502,19 @@ uint64_t OS_TimeDifference(uint64_t start, uint64_t stop) {
 
 // ******** OS_MsTime ************
 // reads the current time in msec (from Lab 1). Uses Systick_Calls to approximate.
+// With TICKLESS, ends a skipped tick period first so the slices already 
+// elapsed are counted.
 // Inputs:  none
 // Outputs: time in ms units
 // You are free to select the time resolution for this function
 // It is ok to make the resolution to match the first call to OS_AddPeriodicThread
 unsigned long OS_MsTime(void) {
-  return (Systick_Calls * TimeSliceCycles) / 80000;
+  unsigned long ms;
+  uint32_t oldIntrState = StartCritical();
+  OSAux_TicklessEnd();
+  ms = (Systick_Calls * TimeSliceCycles) / 80000;
+  EndCritical(oldIntrState);
+  return ms;
 }
 
 //******** OS_Launch *************** 
@@ -345,14 +525,16 @@ unsigned long OS_MsTime(void) {
 // In Lab 2, you can ignore the theTimeSlice field
 // In Lab 3, you should implement the user-defined TimeSlice field
 // It is ok to limit the range of theTimeSlice to match the 24-bit SysTick
+#ifndef HOST_BUILD
 void OS_Launch(unsigned long theTimeSlice) {
   if (theTimeSlice > 0x00FFFFFF){
     terminal_fatalErrorHandler(E_INVALID_TIME_SLICE, "Time slice out of bounds");
   }
   if (theTimeSlice < 8000){
-    terminal_printMessage("Time slice size less than 100 us", 2);
+    TRACE_WARNING(TRACE_SHORT_TIME_SLICE, theTimeSlice, 0);
   }
   TimeSliceCycles = theTimeSlice;
+  OSAux_TickInit();
   NVIC_ST_CTRL_R = 0;
   NVIC_ST_RELOAD_R = theTimeSlice;
   NVIC_ST_CURRENT_R = 0;
@@ -367,3 +549,119 @@ void OS_Launch(unsigned long theTimeSlice) {
   
   StartOS();
 }
+
+/**************SysTick_Program***************
+Description: Restarts SysTick so it next fires after cycles, then every 
+  cycles.
+Inputs: cycles - SysTick period
+Outputs: none
+*/
+void SysTick_Program(uint32_t cycles) {
+  NVIC_ST_RELOAD_R = cycles;
+  NVIC_ST_CURRENT_R = 0; // Reloads on next clock
+}
+
+/**************SysTick_Elapsed***************
+Description: Returns cycles since SysTick period started. If the period has 
+  already ended, includes it and clears the pending SysTick.
+Inputs: none
+Outputs: cycles elapsed
+*/
+uint32_t SysTick_Elapsed(void) {
+  uint32_t elapsed = NVIC_ST_RELOAD_R - NVIC_ST_CURRENT_R;
+  if (NVIC_INT_CTRL_R & NVIC_INT_CTRL_PENDSTSET) {
+    elapsed += NVIC_ST_RELOAD_R;
+    NVIC_INT_CTRL_R = NVIC_INT_CTRL_PENDSTCLR;
+  }
+  return elapsed;
+}
+#endif
+
+/**************OS_StackHighWater***************
+Description: Returns the most stack a TCB's threads have used since boot.
+Inputs: tid - thread id
+Outputs: words used
+*/
+uint32_t OS_StackHighWater(uint8_t tid) {
+#ifdef HOST_BUILD
+  return OSHost_StackHighWater(tid);
+#else
+  TCB_t * thread = &TCBs[tid];
+  uint32_t iii = 1; // skip guard word
+  if (thread->stackBase != 0) {
+    while (iii < thread->stackWords && thread->stackBase[iii] == STACK_PAINT) {
+      iii++;
+    }
+    if (thread->stackWords - iii > thread->stackHighWater) {
+      thread->stackHighWater = thread->stackWords - iii;
+    }
+  }
+  return thread->stackHighWater;
+#endif
+}
+
+/**************isInactive***************
+Description: Returns 1 if TCB is in the inactive list.
+*/
+static uint8_t isInactive(TCB_t * thread) {
+  TCB_t * inactive = InactiveThreads;
+  if (inactive == 0) {
+    return 0;
+  }
+  do {
+    if (inactive == thread) {
+      return 1;
+    }
+    inactive = inactive->nextTCB;
+  } while (inactive != InactiveThreads);
+  return 0;
+}
+
+/**************OS_PrintThreadStats***************
+Description: Prints CPU cycles and stack high water mark for every TCB that
+  has run since boot.
+Inputs: none
+Outputs: none
+*/
+void OS_PrintThreadStats(void) {
+  int iii;
+  uint8_t inactive;
+  uint64_t runCycles;
+  uint64_t elapsed;
+  uint32_t oldIntrState;
+  
+  // Count the slices of a skipped tick period too.
+  oldIntrState = StartCritical();
+  OSAux_TicklessEnd();
+  elapsed = (uint64_t)Systick_Calls * TimeSliceCycles;
+  EndCritical(oldIntrState);
+  
+  terminal_printString("\r\n----- Threads -----\r\n");
+  terminal_printString("tid,state,priority,kcycles,cpu%,stack words\r\n");
+  for (iii = 0; iii < MAX_THREADS; iii++) {
+    oldIntrState = StartCritical();
+    runCycles = TCBs[iii].runCycles;
+    inactive = isInactive(&TCBs[iii]);
+    EndCritical(oldIntrState);
+    if (runCycles == 0) {
+      continue;
+    }
+    
+    terminal_printValueDec(iii);
+    terminal_printString(inactive ? ",inactive," : ",active,");
+    terminal_printValueDec(TCBs[iii].basePriority);
+    terminal_printString(",");
+    terminal_printValueDec(runCycles / 1000);
+    terminal_printString(",");
+    terminal_printValueDec(elapsed ? runCycles * 100 / elapsed : 0);
+    terminal_printString(",");
+    terminal_printValueDec(OS_StackHighWater(iii));
+    terminal_printString("/");
+#ifdef HOST_BUILD
+    terminal_printValueDec(HOST_STACK_SIZE / 4);
+#else
+    terminal_printValueDec(TCBs[iii].stackWords);
+#endif
+    terminal_printString("\r\n");
+  }
+}
@@ -9,9 +9,19 @@
 #define OS_H
 
 #define MAX_THREADS 40
-#define STACK_SIZE 128
 
-#define NUM_PRIORITY_LEVELS 10
+// Fill for unused stack words, scanned for the high water mark.
+#define STACK_PAINT 0xCAFEF00D
+
+// Priorities 0 (highest) to 9 are for user threads. The lowest level is 
+// reserved for the idle thread.
+#define NUM_PRIORITY_LEVELS 11
+#define IDLE_PRIORITY (NUM_PRIORITY_LEVELS - 1)
+
+// Uncomment to reprogram SysTick to skip ticks while the running thread has
+// no time slice to share and no sleeper is due. Not yet validated on the 
+// board. tools/SchedCheck covers it on the host with -DTICKLESS.
+//#define TICKLESS
 
 // edit these depending on your clock        
 #define TIME_1MS    80000          
@@ -31,12 +41,22 @@ typedef struct TCB_t {
   struct TCB_t * nextTCB;
   uint32_t sleepUntil;
   uint8_t tid;
-  uint8_t priority;
+  uint8_t priority; // offset of tid and priority hard coded in OSasm.s
+  uint8_t basePriority; // priority before any inherited from mutex waiters
+  struct Sema4 * blockedOn; // semaphore thread is blocked on, 0 if none
+  uint64_t runCycles; // cycles run in this TCB since boot, offset hard coded in OSasm.s
+  uint32_t * stackBase; // lowest word of stack from StackPool, 0 if none, offset hard coded in OSasm.s
+  uint16_t stackWords; // size of stack in words
+  uint16_t stackHighWater; // most words used by any thread in this TCB
+  struct Sema4 * heldMutexes; // mutexes owned, linked through nextHeld
 } TCB_t;
 
 struct  Sema4{
   long Value;
-  TCB_t * Queue;
+  TCB_t * Queue[NUM_PRIORITY_LEVELS]; // circular blocked list per priority
+  uint32_t priorityWaiting; // same bit layout as priorityOccupied
+  TCB_t * owner; // thread holding mutex, only used by OS_MutexLock/Unlock
+  struct Sema4 * nextHeld; // next mutex owner holds
 };
 typedef struct Sema4 Sema4Type;
 
@@ -132,6 +152,24 @@ void OS_bWait(Sema4Type *semaPt);
 // output: none
 void OS_bSignal(Sema4Type *semaPt); 
 
+// ******** OS_MutexLock ************
+// lock a mutex (binary semaphore initialized to 1), block if already locked
+// while blocked, the owner inherits the caller's priority if it is higher
+// must be called from a foreground thread
+// input:  pointer to a mutex
+// output: none
+void OS_MutexLock(Sema4Type *semaPt);
+
+// ******** OS_MutexUnlock ************
+// unlock a mutex held by the calling thread, passing it to the highest 
+// priority waiter, and drop the priority inherited through it
+// the caller keeps the priority of the highest waiter on any mutex it still
+// holds
+// must be called from a foreground thread
+// input:  pointer to a mutex
+// output: none
+void OS_MutexUnlock(Sema4Type *semaPt);
+
 //******** OS_AddThread *************** 
 // add a foregound thread to the scheduler
 // Inputs: pointer to a void/void foreground task
@@ -298,4 +336,19 @@ unsigned long OS_MsTime(void);
 // It is ok to limit the range of theTimeSlice to match the 24-bit SysTick
 void OS_Launch(unsigned long theTimeSlice);
 
+/**************OS_StackHighWater***************
+Description: Returns the most stack a TCB's threads have used since boot.
+Inputs: tid - thread id
+Outputs: words used
+*/
+uint32_t OS_StackHighWater(uint8_t tid);
+
+/**************OS_PrintThreadStats***************
+Description: Prints CPU cycles and stack high water mark for every TCB that
+  has run since boot.
+Inputs: none
+Outputs: none
+*/
+void OS_PrintThreadStats(void);
+
 #endif
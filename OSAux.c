@@ -7,7 +7,13 @@
 */
 
 #include "OS.h"
+#include "OSAux.h"
 #include "getHighest.h"
+#include "Profiler.h"
+#include "StackPool.h"
+#ifdef PROFILE_CRITICAL
+#include "tm4c123gh6pm.h"
+#endif
 
 uint32_t StartCritical(void); // Disable interrupts
 void EndCritical(uint32_t oldState);  // Enable interrupts
@@ -16,59 +22,232 @@ extern TCB_t * ReadyThreads[NUM_PRIORITY_LEVELS];
 extern uint32_t priorityOccupied;
 
 extern TCB_t * SleepThreads;
+extern TCB_t * Current_Thread;
+extern uint32_t TimeSliceCycles;
+
+// Time slices covered by the SysTick period now running. 1 unless tickless.
+static uint32_t TickPeriod = 1;
+
+// SysTick period currently programmed, in cycles.
+static uint32_t TickReload;
+
+static uint32_t ticksUntilNextEvent(void);
+static void planTick(void);
 
 extern uint32_t CS_Ignore;
 extern uint32_t Systick_Calls;
 extern TCB_t* Current_Thread;
 
-/******** restoreBlockedThread ************
- Restores the first highest priority thread from specified block list
- Inputs: semaPt - pointer to the semaphore we wish to unblock from
+/******** OSAux_ReadyInsert ************
+ Appends a thread to the back of the ready list for its priority
+ Inputs: TCB_Pt - thread to insert, must not be in any list
+ Outputs: none
+*/
+void OSAux_ReadyInsert(TCB_t *TCB_Pt){
+  uint8_t priority = TCB_Pt->priority;
+  if(ReadyThreads[priority] == 0){
+    ReadyThreads[priority] = TCB_Pt;
+    priorityOccupied |= 1 << (NUM_PRIORITY_LEVELS - priority - 1);
+    TCB_Pt->prevTCB = TCB_Pt;
+    TCB_Pt->nextTCB = TCB_Pt;
+  }
+  else{
+    TCB_Pt->prevTCB = ReadyThreads[priority]->prevTCB;
+    TCB_Pt->nextTCB = ReadyThreads[priority];
+    ReadyThreads[priority]->prevTCB->nextTCB = TCB_Pt;
+    ReadyThreads[priority]->prevTCB = TCB_Pt;
+  }
+  OSAux_TicklessCheck();
+}
+
+/******** OSAux_ReadyRemove ************
+ Removes a thread from the ready list for its priority
+ Inputs: TCB_Pt - thread to remove, must be in a ready list
+ Outputs: none
+*/
+void OSAux_ReadyRemove(TCB_t *TCB_Pt){
+  uint8_t priority = TCB_Pt->priority;
+  if(TCB_Pt->nextTCB != TCB_Pt){
+    TCB_Pt->nextTCB->prevTCB = TCB_Pt->prevTCB;
+    TCB_Pt->prevTCB->nextTCB = TCB_Pt->nextTCB;
+    if(ReadyThreads[priority] == TCB_Pt){
+      ReadyThreads[priority] = TCB_Pt->nextTCB;
+    }
+  }
+  else{
+    ReadyThreads[priority] = 0;
+    priorityOccupied &= ~(1 << (NUM_PRIORITY_LEVELS - priority - 1));
+  }
+}
+
+/******** OSAux_BlockedInsert ************
+ Appends a thread to the back of a semaphore's blocked list for its priority
+ Inputs: semaPt - semaphore thread is blocking on
+         TCB_Pt - thread to insert, must not be in any list
+ Outputs: none
+*/
+void OSAux_BlockedInsert(Sema4Type *semaPt, TCB_t *TCB_Pt){
+  uint8_t priority = TCB_Pt->priority;
+  TCB_t *first = semaPt->Queue[priority];
+  if(first == 0){
+    semaPt->Queue[priority] = TCB_Pt;
+    semaPt->priorityWaiting |= 1 << (NUM_PRIORITY_LEVELS - priority - 1);
+    TCB_Pt->prevTCB = TCB_Pt;
+    TCB_Pt->nextTCB = TCB_Pt;
+  }
+  else{
+    TCB_Pt->prevTCB = first->prevTCB;
+    TCB_Pt->nextTCB = first;
+    first->prevTCB->nextTCB = TCB_Pt;
+    first->prevTCB = TCB_Pt;
+  }
+  TCB_Pt->blockedOn = semaPt;
+}
+
+/******** OSAux_BlockedRemove ************
+ Removes a thread from a semaphore's blocked list for its priority
+ Inputs: semaPt - semaphore thread is blocked on
+         TCB_Pt - thread to remove
  Outputs: none
 */
-void restoreBlockedThread(Sema4Type *semaPt){
-    uint8_t priority;
-    TCB_t *firstHighest, *firstTCB, *currentTCB;
-    firstTCB = semaPt->Queue;
-    firstHighest = firstTCB;
-    for(currentTCB = firstTCB->nextTCB; currentTCB != firstTCB; currentTCB = currentTCB->nextTCB){
-      if (firstHighest->priority == 0) break;
-      if(currentTCB->priority < firstHighest->priority){
-        firstHighest = currentTCB;
-      }
+void OSAux_BlockedRemove(Sema4Type *semaPt, TCB_t *TCB_Pt){
+  uint8_t priority = TCB_Pt->priority;
+  if(TCB_Pt->nextTCB != TCB_Pt){
+    TCB_Pt->nextTCB->prevTCB = TCB_Pt->prevTCB;
+    TCB_Pt->prevTCB->nextTCB = TCB_Pt->nextTCB;
+    if(semaPt->Queue[priority] == TCB_Pt){
+      semaPt->Queue[priority] = TCB_Pt->nextTCB;
     }
+  }
+  else{
+    semaPt->Queue[priority] = 0;
+    semaPt->priorityWaiting &= ~(1 << (NUM_PRIORITY_LEVELS - priority - 1));
+  }
+  TCB_Pt->blockedOn = 0;
+}
+
+/******** restoreBlockedThread ************
+ Restores the first highest priority thread from specified block list. 
+ Highest waiting priority is found with CLZ on the semaphore's bitmap.
+ Inputs: semaPt - pointer to the semaphore we wish to unblock from, must have
+           at least one waiter
+ Outputs: pointer to restored thread
+*/
+TCB_t *restoreBlockedThread(Sema4Type *semaPt){
+  TCB_t *firstHighest;
+  firstHighest = semaPt->Queue[getHighestPriorityOf(semaPt->priorityWaiting)];
+  OSAux_BlockedRemove(semaPt, firstHighest);
+  OSAux_ReadyInsert(firstHighest);
+  return firstHighest;
+}
+
+/******** isSleeping ************
+ Returns 1 if thread is in the sleep list. Only used on the rare priority 
+ inheritance path, so a linear scan is fine.
+*/
+static uint8_t isSleeping(TCB_t *TCB_Pt){
+  TCB_t *sleeper;
+  for(sleeper = SleepThreads; sleeper != 0; sleeper = sleeper->nextTCB){
+    if(sleeper == TCB_Pt) return 1;
+  }
+  return 0;
+}
+
+/******** OSAux_InheritPriority ************
+ Raises the owner of a mutex to priority, following the chain if the owner is
+ itself blocked on another mutex
+ Inputs: semaPt - mutex being waited on
+         priority - priority of the waiting thread
+ Outputs: none
+*/
+void OSAux_InheritPriority(Sema4Type *semaPt, uint8_t priority){
+  TCB_t *owner;
+  int depth;
+  for(depth = 0; depth < MAX_THREADS && semaPt != 0; depth++){
+    owner = semaPt->owner;
+    if((owner == 0) || (owner->priority <= priority)) return;
     
-    // dequeue from blocked list
-    if(firstHighest->nextTCB != firstHighest){
-      firstHighest->nextTCB->prevTCB = firstHighest->prevTCB;
-      firstHighest->prevTCB->nextTCB = firstHighest->nextTCB;
-      if(firstHighest == firstTCB){
-        semaPt->Queue = firstTCB->nextTCB;
-      }
+    if(owner->blockedOn != 0){
+      semaPt = owner->blockedOn;
+      OSAux_BlockedRemove(semaPt, owner);
+      owner->priority = priority;
+      OSAux_BlockedInsert(semaPt, owner);
+    }
+    else if(isSleeping(owner)){
+      owner->priority = priority;  // rejoins ready list at this priority on wake
+      return;
     }
     else{
-      semaPt->Queue = 0;
+      OSAux_ReadyRemove(owner);
+      owner->priority = priority;
+      OSAux_ReadyInsert(owner);
+      return;
     }
-    
-    // enqueue in ready
-    priority = firstHighest->priority;
-    if(ReadyThreads[priority] == 0){
-      ReadyThreads[priority] = firstHighest;
-      priorityOccupied |= 1 << (NUM_PRIORITY_LEVELS - priority - 1);
-      firstHighest->prevTCB = firstHighest;
-      firstHighest->nextTCB = firstHighest;
+  }
+}
+
+/******** OSAux_HoldMutex ************
+ Pushes a mutex onto the front of its owner's list
+ Inputs: TCB_Pt - new owner
+         semaPt - mutex, not in any thread's list
+ Outputs: none
+*/
+void OSAux_HoldMutex(TCB_t *TCB_Pt, Sema4Type *semaPt){
+  semaPt->nextHeld = TCB_Pt->heldMutexes;
+  TCB_Pt->heldMutexes = semaPt;
+}
+
+/******** OSAux_ReleaseMutex ************
+ Unlinks a mutex from its owner's list, then recomputes the owner's
+ priority from the waiters on the mutexes it still holds. Threads hold few
+ mutexes, so walking the list is fine. A running owner goes to the head of
+ its new ready list, where Context_Switch expects the running thread.
+ Inputs: TCB_Pt - owner, must be in a ready list
+         semaPt - mutex in TCB_Pt's list
+ Outputs: none
+*/
+void OSAux_ReleaseMutex(TCB_t *TCB_Pt, Sema4Type *semaPt){
+  Sema4Type **link;
+  Sema4Type *held;
+  uint8_t priority = TCB_Pt->basePriority;
+  uint8_t waiter;
+  
+  for(link = &TCB_Pt->heldMutexes; *link != 0; link = &(*link)->nextHeld){
+    if(*link == semaPt){
+      *link = semaPt->nextHeld;
+      break;
     }
-    else{
-      firstHighest->prevTCB = ReadyThreads[priority]->prevTCB;
-      firstHighest->nextTCB = ReadyThreads[priority];
-      ReadyThreads[priority]->prevTCB->nextTCB = firstHighest;
-      ReadyThreads[priority]->prevTCB = firstHighest;
+  }
+  semaPt->nextHeld = 0;
+  
+  for(held = TCB_Pt->heldMutexes; held != 0; held = held->nextHeld){
+    if(held->priorityWaiting){
+      waiter = getHighestPriorityOf(held->priorityWaiting);
+      priority = waiter < priority ? waiter : priority;
     }
+  }
+  
+  if(priority != TCB_Pt->priority){
+    OSAux_ReadyRemove(TCB_Pt);
+    TCB_Pt->priority = priority;
+    OSAux_ReadyInsert(TCB_Pt);
+    if(TCB_Pt == Current_Thread){
+      ReadyThreads[priority] = TCB_Pt; // list is circular, tail becomes head
+    }
+  }
 }
 
 void OSAux_Wake(void){
   TCB_t* TCB_Pt;
-  uint32_t criticalStatus = StartCritical();
+  uint32_t criticalStatus;
+#ifdef PROFILE_CRITICAL
+  // Called first thing from SysTick_Handler. SysTick counts down from reload
+  // when it fires, so the elapsed count is the entry latency.
+  Profiler_RecordLatency(ISR_SYSTICK, NVIC_ST_RELOAD_R - NVIC_ST_CURRENT_R);
+#endif
+  criticalStatus = PROFILED_START_CRITICAL(CS_WAKE);
+  Systick_Calls += TickPeriod;
+  TickPeriod = 1;
   TCB_Pt = SleepThreads;
   while ((TCB_Pt != 0) && (TCB_Pt->sleepUntil <= Systick_Calls)){
     SleepThreads = SleepThreads->nextTCB;
@@ -76,21 +255,89 @@ void OSAux_Wake(void){
       SleepThreads->prevTCB = 0;
     }
     
-    // No TCB's in priority list
-    if (!ReadyThreads[TCB_Pt->priority]) {
-      ReadyThreads[TCB_Pt->priority] = TCB_Pt;
-      TCB_Pt->nextTCB = TCB_Pt;
-      TCB_Pt->prevTCB = TCB_Pt;
-      priorityOccupied |= 1 << (NUM_PRIORITY_LEVELS - TCB_Pt->priority - 1);
-    } else {
-      // Otherwise, append to back
-      TCB_Pt->prevTCB = ReadyThreads[TCB_Pt->priority]->prevTCB;
-      TCB_Pt->nextTCB = ReadyThreads[TCB_Pt->priority];
-      ReadyThreads[TCB_Pt->priority]->prevTCB->nextTCB = TCB_Pt;
-      ReadyThreads[TCB_Pt->priority]->prevTCB = TCB_Pt;
-    }
+    OSAux_ReadyInsert(TCB_Pt);
     
     TCB_Pt = SleepThreads;
   }
-  EndCritical(criticalStatus);
+  planTick();
+  PROFILED_END_CRITICAL(CS_WAKE, criticalStatus);
+}
+
+void OSAux_FreeStack(TCB_t *TCB_Pt){
+  OS_StackHighWater(TCB_Pt->tid);
+  StackPool_Free(TCB_Pt->stackBase, TCB_Pt->stackWords);
+  TCB_Pt->stackBase = 0;
+}
+
+void OSAux_TickInit(void){
+  TickPeriod = 1;
+  TickReload = TimeSliceCycles;
+}
+
+void OSAux_TicklessCheck(void){
+  TCB_t* next;
+  if(TickPeriod == 1){
+    return;
+  }
+  next = ReadyThreads[getHighestPriority()];
+  if((next != Current_Thread) || (next->nextTCB != next) ||
+     ((SleepThreads != 0) && 
+      (SleepThreads->sleepUntil < Systick_Calls + TickPeriod))){
+    OSAux_TicklessEnd();
+  }
+}
+
+void OSAux_TicklessEnd(void){
+  uint32_t elapsed;
+  if(TickPeriod == 1){
+    return;
+  }
+  elapsed = SysTick_Elapsed();
+  Systick_Calls += elapsed / TimeSliceCycles;
+  TickReload = TimeSliceCycles - (elapsed % TimeSliceCycles);
+  SysTick_Program(TickReload);
+  TickPeriod = 1;
+}
+
+/******** ticksUntilNextEvent ************
+ Returns how many time slices SysTick can skip. 1 if the next thread shares
+ its priority and needs time slicing, otherwise up to the next sleeper's 
+ wake time, limited by SysTick's 24 bit reload.
+ Inputs: none
+ Outputs: time slices until SysTick is needed
+*/
+static uint32_t ticksUntilNextEvent(void){
+#ifdef TICKLESS
+  TCB_t* next;
+  uint32_t ticks = 0x00FFFFFF / TimeSliceCycles;
+  if(priorityOccupied == 0){
+    return 1;
+  }
+  next = ReadyThreads[getHighestPriority()];
+  if(next->nextTCB != next){
+    return 1;
+  }
+  // Sleep list is ordered, so only the head matters.
+  if((SleepThreads != 0) && (SleepThreads->sleepUntil - Systick_Calls < ticks)){
+    ticks = SleepThreads->sleepUntil - Systick_Calls;
+  }
+  return ticks ? ticks : 1;
+#else
+  return 1;
+#endif
+}
+
+/******** planTick ************
+ Programs the next SysTick period. Reprograms only when the period changes,
+ since restarting SysTick drops the cycles since it fired.
+ Inputs: none
+ Outputs: none
+*/
+static void planTick(void){
+  uint32_t ticks = ticksUntilNextEvent();
+  if(ticks * TimeSliceCycles != TickReload){
+    TickReload = ticks * TimeSliceCycles;
+    SysTick_Program(TickReload);
+  }
+  TickPeriod = ticks;
 }
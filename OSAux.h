@@ -8,6 +8,8 @@
 #ifndef OSAUX_H
 #define OSAUX_H
 
+#include "OS.h"
+
 /**************OSAux_Wake***************
  Removes threads that are ready to be woken from the sleep list
  Inputs : none
@@ -15,4 +17,119 @@
 */
 void OSAux_Wake(void);
 
+/**************OSAux_TickInit***************
+ Starts SysTick bookkeeping at one tick per time slice. Called by OS_Launch
+ after TimeSliceCycles is set.
+ Inputs : none
+ Outputs: none
+*/
+void OSAux_TickInit(void);
+
+/**************OSAux_TicklessCheck***************
+ Ends a multi-tick SysTick period early if the scheduler state no longer 
+ allows it, i.e. a different thread should run, the next thread shares its
+ priority, or a sleeper is due sooner. Called whenever a thread is made 
+ ready and at the end of every context switch. Interrupts must be disabled.
+ Inputs : none
+ Outputs: none
+*/
+void OSAux_TicklessCheck(void);
+
+/**************OSAux_TicklessEnd***************
+ Ends a multi-tick SysTick period at the next tick boundary, crediting 
+ Systick_Calls with the ticks already elapsed. Interrupts must be disabled.
+ Inputs : none
+ Outputs: none
+*/
+void OSAux_TicklessEnd(void);
+
+/**************SysTick_Program***************
+ Restarts SysTick so it next fires after cycles, then every cycles. 
+ Implemented in OS.c, or OSHost.c on host.
+ Inputs : cycles - SysTick period
+ Outputs: none
+*/
+void SysTick_Program(uint32_t cycles);
+
+/**************SysTick_Elapsed***************
+ Returns cycles since SysTick period started. If the period has already 
+ ended, includes it and clears the pending SysTick. Implemented in OS.c, or
+ OSHost.c on host.
+ Inputs : none
+ Outputs: cycles elapsed
+*/
+uint32_t SysTick_Elapsed(void);
+
+/**************OSAux_ReadyInsert***************
+ Appends a thread to the back of the ready list for its priority
+ Inputs : TCB_Pt - thread to insert, must not be in any list
+ Outputs: none
+*/
+void OSAux_ReadyInsert(TCB_t *TCB_Pt);
+
+/**************OSAux_ReadyRemove***************
+ Removes a thread from the ready list for its priority
+ Inputs : TCB_Pt - thread to remove, must be in a ready list
+ Outputs: none
+*/
+void OSAux_ReadyRemove(TCB_t *TCB_Pt);
+
+/**************OSAux_BlockedInsert***************
+ Appends a thread to a semaphore's blocked list for its priority
+ Inputs : semaPt - semaphore thread is blocking on
+          TCB_Pt - thread to insert, must not be in any list
+ Outputs: none
+*/
+void OSAux_BlockedInsert(Sema4Type *semaPt, TCB_t *TCB_Pt);
+
+/**************OSAux_BlockedRemove***************
+ Removes a thread from a semaphore's blocked list for its priority
+ Inputs : semaPt - semaphore thread is blocked on
+          TCB_Pt - thread to remove
+ Outputs: none
+*/
+void OSAux_BlockedRemove(Sema4Type *semaPt, TCB_t *TCB_Pt);
+
+/**************OSAux_FreeStack***************
+ Records a thread's stack high water mark and returns its stack to the pool.
+ Called when the thread is killed, interrupts must be disabled.
+ Inputs : TCB_Pt - thread being killed
+ Outputs: none
+*/
+void OSAux_FreeStack(TCB_t *TCB_Pt);
+
+/**************restoreBlockedThread***************
+ Moves the first highest priority waiter on a semaphore to the ready list
+ Inputs : semaPt - semaphore with at least one waiter
+ Outputs: pointer to restored thread
+*/
+TCB_t *restoreBlockedThread(Sema4Type *semaPt);
+
+/**************OSAux_InheritPriority***************
+ Raises the owner of a mutex (and any chain of owners it is blocked on) to
+ the priority of a waiting thread
+ Inputs : semaPt - mutex being waited on
+          priority - priority of the waiting thread
+ Outputs: none
+*/
+void OSAux_InheritPriority(Sema4Type *semaPt, uint8_t priority);
+
+/**************OSAux_HoldMutex***************
+ Adds a mutex to the list of those a thread owns
+ Inputs : TCB_Pt - new owner
+          semaPt - mutex, not in any thread's list
+ Outputs: none
+*/
+void OSAux_HoldMutex(TCB_t *TCB_Pt, Sema4Type *semaPt);
+
+/**************OSAux_ReleaseMutex***************
+ Removes a mutex from the list of those a thread owns and drops the thread
+ to the higher of its base priority and the highest waiter on any mutex it
+ still owns. A running thread stays the head of its ready list
+ Inputs : TCB_Pt - owner, must be in a ready list
+          semaPt - mutex in TCB_Pt's list
+ Outputs: none
+*/
+void OSAux_ReleaseMutex(TCB_t *TCB_Pt, Sema4Type *semaPt);
+
 #endif
@@ -0,0 +1,452 @@
+/********** OSHost.c ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host (Linux) backend for the OS, built when HOST_BUILD is 
+  defined. Replaces OSasm.s, SVCasm.s, the startup.s interrupt helpers, and the
+  hardware timers with ucontext threads and a virtual clock. Scheduling logic
+  in OS.c, OSAux.c and ServiceCalls.c is shared with the target build.
+  
+  Interrupts map to SIGALRM. PRIMASK maps to SIGALRM being blocked, so 
+  StartCritical/EndCritical keep the same meaning. Each SIGALRM is one 
+  SysTick: it advances the virtual clock by one time slice, runs the board 
+  model if any, runs the periodic thread if due, wakes sleeping threads, and
+  context switches.
+*/
+
+#ifdef HOST_BUILD
+
+#include <stdint.h>
+#include <signal.h>
+#include <sys/time.h>
+#include <ucontext.h>
+#include "OS.h"
+#include "OSHost.h"
+#include "OSAux.h"
+#include "ServiceCalls.h"
+#include "getHighest.h"
+#include "unitConvert.h"
+#include "terminal.h"
+#include "Trace.h"
+
+// Globals exported by OSasm.s on target.
+uint32_t CS_Ignore = 0;
+uint32_t Systick_Calls = 0;
+TCB_t * Current_Thread = 0;
+
+extern TCB_t * ReadyThreads[NUM_PRIORITY_LEVELS];
+extern uint32_t priorityOccupied;
+extern TCB_t * InactiveThreads;
+extern TCB_t * SleepThreads;
+extern uint8_t OSLaunched;
+extern unsigned long Period;
+extern uint32_t TimeSliceCycles;
+
+static ucontext_t Contexts[MAX_THREADS];
+static void (*Tasks[MAX_THREADS])(void);
+static uint8_t HostStacks[MAX_THREADS][HOST_STACK_SIZE];
+
+// Virtual clock, in 12.5ns units to match OS_Time on target.
+static uint64_t HostTime = 0;
+
+// Virtual SysTick period, reprogrammed by SysTick_Program when tickless.
+static uint64_t HostTickStart = 0;
+static uint64_t HostTickDeadline = 0;
+static uint32_t HostTickReload = 0;
+
+// HostTime when Current_Thread started running. Equivalent of 
+// LastSwitchCycles, but only as fine as the virtual tick.
+static uint64_t LastSwitchTime = 0;
+
+// Set while the periodic thread runs from the virtual SysTick.
+static uint8_t InInterrupt = 0;
+
+// Board interrupts, see OSHost_SetBoardHook.
+static void (*BoardHook)(uint64_t now) = 0;
+
+// Periodic thread, replaces Timer5.
+static void (*PeriodicTask)(void) = 0;
+static uint8_t PeriodicEnabled = 0;
+static uint64_t NextPeriodicTime = 0;
+
+static void threadEntry(void);
+static void unpackContext(void);
+static void contextSwitch(void);
+static void sysTickHandler(int sig);
+
+/*********** StartCritical ************************
+ make a copy of previous I bit, disable interrupts
+ inputs:  none
+ outputs: previous I bit
+*/
+uint32_t StartCritical(void) {
+  sigset_t block, old;
+  sigemptyset(&block);
+  sigaddset(&block, SIGALRM);
+  sigprocmask(SIG_BLOCK, &block, &old);
+  return sigismember(&old, SIGALRM);
+}
+
+/*********** EndCritical ************************
+ using the copy of previous I bit, restore I bit to previous value
+ inputs:  previous I bit
+ outputs: none
+*/
+void EndCritical(uint32_t oldState) {
+  sigset_t block;
+  if (oldState) {
+    return;
+  }
+  sigemptyset(&block);
+  sigaddset(&block, SIGALRM);
+  sigprocmask(SIG_UNBLOCK, &block, 0);
+}
+
+void DisableInterrupts(void) {
+  StartCritical();
+}
+
+void EnableInterrupts(void) {
+  EndCritical(0);
+}
+
+void WaitForInterrupt(void) {
+  sigset_t none;
+  sigemptyset(&none);
+  sigsuspend(&none);
+}
+
+/**************OSHost_InitContext***************
+ Creates the host context a new thread starts executing in.
+ Inputs : TCBPt - TCB of new thread
+          task - thread entry point
+ Outputs: none
+*/
+void OSHost_InitContext(TCB_t * TCBPt, void (*task)(void)) {
+  ucontext_t * context = &Contexts[TCBPt->tid];
+  
+  Tasks[TCBPt->tid] = task;
+  getcontext(context);
+  context->uc_stack.ss_sp = HostStacks[TCBPt->tid];
+  context->uc_stack.ss_size = HOST_STACK_SIZE;
+  context->uc_link = 0;
+  sigemptyset(&context->uc_sigmask); // threads start with interrupts enabled
+  makecontext(context, threadEntry, 0);
+}
+
+/**************OSHost_StackHighWater***************
+ Returns how much of a thread's host stack has been touched. Host stacks 
+ start zeroed and are never reused, so the scan stops at the first nonzero
+ byte.
+ Inputs : tid - thread id
+ Outputs: words used, out of HOST_STACK_SIZE / 4
+*/
+uint32_t OSHost_StackHighWater(uint8_t tid) {
+  uint32_t iii = 0;
+  while (iii < HOST_STACK_SIZE && HostStacks[tid][iii] == 0) {
+    iii++;
+  }
+  return (HOST_STACK_SIZE - iii) / 4;
+}
+
+/**************OSHost_SetBoardHook***************
+ Registers a function run on every virtual SysTick.
+ Inputs : hook - function to run, passed the virtual time
+ Outputs: none
+*/
+void OSHost_SetBoardHook(void (*hook)(uint64_t now)) {
+  BoardHook = hook;
+}
+
+/**************OSHost_CheckScheduler***************
+ Checks ready list and sleep list invariants.
+ Inputs : none
+ Outputs: none
+*/
+void OSHost_CheckScheduler(void) {
+  int priority, count;
+  TCB_t * TCB_Pt;
+  
+  for (priority = 0; priority < NUM_PRIORITY_LEVELS; priority++) {
+    uint32_t bit = 1 << (NUM_PRIORITY_LEVELS - priority - 1);
+    
+    if ((ReadyThreads[priority] != 0) != ((priorityOccupied & bit) != 0)) {
+      terminal_fatalErrorHandler(E_SCHEDULER_CORRUPT, 
+                                 "priorityOccupied out of sync");
+    }
+    
+    if (ReadyThreads[priority] == 0) {
+      continue;
+    }
+    
+    // Ready lists are circular and doubly linked, one priority per list.
+    TCB_Pt = ReadyThreads[priority];
+    count = 0;
+    do {
+      if (TCB_Pt->priority != priority || TCB_Pt->nextTCB->prevTCB != TCB_Pt ||
+          ++count > MAX_THREADS) {
+        terminal_fatalErrorHandler(E_SCHEDULER_CORRUPT, "Ready list corrupt");
+      }
+      TCB_Pt = TCB_Pt->nextTCB;
+    } while (TCB_Pt != ReadyThreads[priority]);
+  }
+  
+  // Sleep list is null terminated and ordered by wake time.
+  count = 0;
+  for (TCB_Pt = SleepThreads; TCB_Pt != 0; TCB_Pt = TCB_Pt->nextTCB) {
+    if ((TCB_Pt->nextTCB != 0 && 
+         TCB_Pt->nextTCB->sleepUntil < TCB_Pt->sleepUntil) || 
+        ++count > MAX_THREADS) {
+      terminal_fatalErrorHandler(E_SCHEDULER_CORRUPT, "Sleep list corrupt");
+    }
+  }
+}
+
+/**************OS_AddPeriodicThread***************
+Description: Initializes periodic thread, run from the virtual SysTick.
+  Period is rounded up to a whole number of time slices.
+Inputs:
+  task - pointer to function to run
+  period - period in clock cycles
+  priority - priority of interrupt (0-7), only checked for range
+Outputs: ErrorCode
+*/
+ErrorCode_t OS_AddPeriodicThread(void (*task)(void), unsigned long period, 
+                                 unsigned long priority) {
+  if (priority > 7) {
+    return E_INVALID_PRIORITY;
+  }
+  
+  PeriodicTask = task;
+  Period = period;
+  NextPeriodicTime = HostTime + period;
+  PeriodicEnabled = 1;
+  
+  return E_SUCCESS;
+}
+
+ErrorCode_t OS_RemovePeriodicThread(void) {
+  PeriodicEnabled = 0;
+  return E_SUCCESS;
+}
+
+/**************OS_Disable***************
+Description: Stops the virtual SysTick, in the event of a fatal error.
+Inputs: none
+Outputs: none
+*/
+void OS_Disable(void) {
+  struct itimerval timer = {{0, 0}, {0, 0}};
+  setitimer(ITIMER_REAL, &timer, 0);
+}
+
+void initSystemClockTimer(void) {
+  HostTime = 0;
+}
+
+// ******** OS_Sleep ************
+// Same as target SVC #2.
+void OS_Sleep(unsigned long sleepTime) {
+  uint32_t status = StartCritical();
+  OS_Sleep_SVC_C(ms2slices(sleepTime));
+  unpackContext();
+  EndCritical(status);
+}
+
+// ******** OS_Kill ************
+// Same as target SVC #1.
+void OS_Kill(void) {
+  uint32_t status = StartCritical();
+  OS_Transfer_SVC_C(&InactiveThreads);
+  unpackContext();
+  EndCritical(status);
+}
+
+// ******** OS_Wait ************
+// Same as target SVC #3.
+void OS_Wait(Sema4Type *semaPt) {
+  uint32_t status = StartCritical();
+  OS_Wait_SVC_C(semaPt);
+  unpackContext();
+  EndCritical(status);
+}
+
+// ******** OS_bWait ************
+// Same as target SVC #4.
+void OS_bWait(Sema4Type *semaPt) {
+  uint32_t status = StartCritical();
+  OS_bWait_SVC_C(semaPt);
+  unpackContext();
+  EndCritical(status);
+}
+
+// ******** OS_MutexLock ************
+// Same as target SVC #5.
+void OS_MutexLock(Sema4Type *semaPt) {
+  uint32_t status = StartCritical();
+  OS_MutexLock_SVC_C(semaPt);
+  unpackContext();
+  EndCritical(status);
+}
+
+/**************OSHost_InInterrupt***************
+ Returns 1 while the periodic thread is running from the virtual SysTick.
+*/
+uint8_t OSHost_InInterrupt(void) {
+  return InInterrupt;
+}
+
+// ******** OS_Suspend ************
+// Same as target SVC #0 (Yield_Context_Switch).
+void OS_Suspend(void) {
+  uint32_t status = StartCritical();
+  CS_Ignore = 1;
+  contextSwitch();
+  EndCritical(status);
+}
+
+// ******** OS_Time ************
+// return the virtual system time in 12.5ns units
+uint64_t OS_Time(void) {
+  return HostTime;
+}
+
+//******** OS_Launch *************** 
+// start the scheduler, enable interrupts. Starts the virtual SysTick with one
+// time slice every HOST_US_PER_TICK real microseconds.
+void OS_Launch(unsigned long theTimeSlice) {
+  struct sigaction action;
+  struct itimerval timer;
+  
+  if (theTimeSlice > 0x00FFFFFF){
+    terminal_fatalErrorHandler(E_INVALID_TIME_SLICE, "Time slice out of bounds");
+  }
+  if (theTimeSlice < 8000){
+    TRACE_WARNING(TRACE_SHORT_TIME_SLICE, theTimeSlice, 0);
+  }
+  if (priorityOccupied == 0) {
+    terminal_fatalErrorHandler(E_NO_ACTIVE_THREADS, "No threads to launch");
+  }
+  TimeSliceCycles = theTimeSlice;
+  OSAux_TickInit();
+  SysTick_Program(theTimeSlice);
+  
+  DisableInterrupts();
+  action.sa_handler = sysTickHandler;
+  sigemptyset(&action.sa_mask);
+  action.sa_flags = SA_RESTART;
+  sigaction(SIGALRM, &action, 0);
+  
+  timer.it_interval.tv_sec = 0;
+  timer.it_interval.tv_usec = HOST_US_PER_TICK;
+  timer.it_value = timer.it_interval;
+  setitimer(ITIMER_REAL, &timer, 0);
+  
+  OSLaunched = 1;
+  
+  Current_Thread = ReadyThreads[getHighestPriority()];
+  setcontext(&Contexts[Current_Thread->tid]);
+}
+
+/**************threadEntry***************
+ Runs a thread's task. Threads should never return but are killed if they do.
+*/
+static void threadEntry(void) {
+  Tasks[Current_Thread->tid]();
+  OS_Kill();
+}
+
+/**************unpackContext***************
+ Switches to the head of the highest priority ready list. Equivalent of
+ Pack_Context followed by Unpack_Context. Interrupts must be disabled.
+*/
+static void unpackContext(void) {
+  TCB_t * oldThread = Current_Thread;
+  
+  oldThread->runCycles += HostTime - LastSwitchTime;
+  LastSwitchTime = HostTime;
+  
+  Current_Thread = ReadyThreads[getHighestPriority()];
+  OSAux_TicklessCheck();
+  if (Current_Thread != oldThread) {
+    swapcontext(&Contexts[oldThread->tid], &Contexts[Current_Thread->tid]);
+  }
+}
+
+/**************contextSwitch***************
+ Rotates the previous thread's ready list then switches. Equivalent of 
+ Context_Switch. Interrupts must be disabled.
+*/
+static void contextSwitch(void) {
+  uint8_t priority = Current_Thread->priority;
+  
+  // Otherwise the rotation skips a thread at this priority.
+  if (ReadyThreads[priority] != Current_Thread) {
+    terminal_fatalErrorHandler(E_SCHEDULER_CORRUPT, 
+                               "Running thread not at head of ready list");
+  }
+  ReadyThreads[priority] = ReadyThreads[priority]->nextTCB;
+  unpackContext();
+}
+
+/**************SysTick_Program***************
+ Restarts the virtual SysTick so it next fires after cycles, then every 
+ cycles. Resolution is one SIGALRM, i.e. one time slice.
+ Inputs : cycles - SysTick period
+ Outputs: none
+*/
+void SysTick_Program(uint32_t cycles) {
+  HostTickStart = HostTime;
+  HostTickDeadline = HostTime + cycles;
+  HostTickReload = cycles;
+}
+
+/**************SysTick_Elapsed***************
+ Returns cycles since the virtual SysTick period started.
+ Inputs : none
+ Outputs: cycles elapsed
+*/
+uint32_t SysTick_Elapsed(void) {
+  return HostTime - HostTickStart;
+}
+
+/**************sysTickHandler***************
+ Each SIGALRM is one time slice. Runs the periodic thread in place of 
+ Timer5, then the virtual SysTick if its period is up. Runs with SIGALRM 
+ blocked.
+*/
+static void sysTickHandler(int sig) {
+  HostTime += TimeSliceCycles;
+  
+  if (BoardHook) {
+    InInterrupt = 1;
+    (*BoardHook)(HostTime);
+    InInterrupt = 0;
+  }
+  
+  if (PeriodicEnabled && HostTime >= NextPeriodicTime) {
+    NextPeriodicTime += Period;
+    InInterrupt = 1;
+    (*PeriodicTask)();
+    InInterrupt = 0;
+  }
+  
+  // Skipped slices when tickless
+  if (HostTime < HostTickDeadline) {
+    return;
+  }
+  HostTickStart = HostTickDeadline;
+  HostTickDeadline += HostTickReload;
+  
+  OSAux_Wake();
+  OSHost_CheckScheduler();
+  
+  // Int_Context_Switch
+  if (CS_Ignore) {
+    CS_Ignore = 0;
+    return;
+  }
+  contextSwitch();
+}
+
+#endif
@@ -0,0 +1,70 @@
+/********** OSHost.h ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host (Linux) backend for the OS, built when HOST_BUILD is 
+  defined. Replaces OSasm.s, SVCasm.s, the startup.s interrupt helpers, and the
+  hardware timers with ucontext threads and a virtual clock. Scheduling logic
+  in OS.c, OSAux.c and ServiceCalls.c is shared with the target build.
+*/
+
+#ifndef OSHOST_H
+#define OSHOST_H
+
+#ifdef HOST_BUILD
+
+#include <stdint.h>
+#include "OS.h"
+
+// Real microseconds per virtual SysTick. Each SysTick advances OS_Time by one
+// time slice, so a 2 ms slice at 100 us per tick runs 20x real time.
+#define HOST_US_PER_TICK 100
+
+// Threads run on host stacks since libc needs more room. StackPool stacks
+// are still allocated and freed so the pool is exercised.
+#define HOST_STACK_SIZE 65536
+
+/**************OSHost_InitContext***************
+ Creates the host context a new thread starts executing in. Called from 
+ initStack.
+ Inputs : TCBPt - TCB of new thread
+          task - thread entry point
+ Outputs: none
+*/
+void OSHost_InitContext(TCB_t * TCBPt, void (*task)(void));
+
+/**************OSHost_InInterrupt***************
+ Returns 1 while the periodic thread is running from the virtual SysTick, the
+ host equivalent of a nonzero IPSR.
+ Inputs : none
+ Outputs: 1 if in virtual ISR, otherwise 0
+*/
+uint8_t OSHost_InInterrupt(void);
+
+/**************OSHost_StackHighWater***************
+ Returns how much of a thread's host stack has been touched. Host 
+ equivalent of the StackPool paint scan in OS_StackHighWater.
+ Inputs : tid - thread id
+ Outputs: words used, out of HOST_STACK_SIZE / 4
+*/
+uint32_t OSHost_StackHighWater(uint8_t tid);
+
+/**************OSHost_SetBoardHook***************
+ Registers a function run on every virtual SysTick, before the periodic 
+ thread, as if it were the board's interrupts. See VirtualBoard.c.
+ Inputs : hook - function to run, passed the virtual time
+ Outputs: none
+*/
+void OSHost_SetBoardHook(void (*hook)(uint64_t now));
+
+/**************OSHost_CheckScheduler***************
+ Checks ready list and sleep list invariants. Calls 
+ terminal_fatalErrorHandler if any are violated. Run on every SysTick.
+ Inputs : none
+ Outputs: none
+*/
+void OSHost_CheckScheduler(void);
+
+#endif
+
+#endif
@@ -1,4 +1,8 @@
 NVIC_ST_CTRL_R EQU 0xE000E010
+DWT_CYCCNT_R   EQU 0xE0001004
+TCB_RUN_CYCLES EQU 24                ; offset of runCycles in TCB_t
+TCB_STACK_BASE EQU 32                ; offset of stackBase in TCB_t
+STACK_GUARD    EQU 0xDEADC0DE        ; must match StackPool.h
         
         PRESERVE8
 
@@ -6,10 +10,12 @@ NVIC_ST_CTRL_R EQU 0xE000E010
         EXPORT CS_Ignore
         EXPORT Systick_Calls
         EXPORT Current_Thread
+        EXPORT LastSwitchCycles
             
 CS_Ignore         DCD 0            ; ignore the next interrupt-driven context switch
-Systick_Calls     DCD 0            ; total # of times the systick handler has run
+Systick_Calls     DCD 0            ; total # of time slices elapsed, advanced by OSAux_Wake
 Current_Thread    DCD 0            ; pointer to currently executing thread
+LastSwitchCycles  DCD 0            ; DWT cycle count when Current_Thread started running
 
 
         AREA OS_Code, CODE, READONLY, ALIGN=2
@@ -23,9 +29,13 @@ Current_Thread    DCD 0            ; pointer to currently executing thread
         IMPORT StartCritical
         IMPORT EndCritical
         IMPORT getHighestPriority
+        IMPORT StackPool_StackOverflow
+        IMPORT OSAux_TicklessCheck
 
 ;**************Pack_Context***************
 ; Description: Saves state to TCB of currently active thread, in anticipation of changing the active thread.
+;     Also charges the cycles run since the last switch to the thread, and
+;     checks its stack guard word. Every context switch goes through here.
 ; Inputs : None
 ; Outputs: None
 
@@ -35,6 +45,25 @@ Pack_Context
     LDR   r0, =Current_Thread
     LDR   r0, [r0]                ; get pointer to current task's TCB
     
+    LDR   r2, =DWT_CYCCNT_R
+    LDR   r2, [r2]                ; current cycle count
+    LDR   r3, =LastSwitchCycles
+    LDR   r12, [r3]
+    STR   r2, [r3]                ; next thread starts now
+    SUB   r12, r2, r12            ; cycles run since last switch
+    LDR   r2, [r0, #TCB_RUN_CYCLES]
+    ADDS  r2, r2, r12            ; add to 64-bit runCycles
+    STR   r2, [r0, #TCB_RUN_CYCLES]
+    LDR   r2, [r0, #TCB_RUN_CYCLES+4]
+    ADC   r2, r2, #0
+    STR   r2, [r0, #TCB_RUN_CYCLES+4]
+    
+    LDR   r2, [r0, #TCB_STACK_BASE]
+    LDR   r2, [r2]                ; guard word at bottom of stack
+    LDR   r3, =STACK_GUARD
+    CMP   r2, r3
+    BNE   StackPool_StackOverflow    ; does not return
+    
     MRS   r1, PSP                ; get process stack pointer
     STMFD r1!, {r4-r11}            ; push r4-r11 to the process stack
     STR   r1, [r0]                ; store decremented SP to task SP
@@ -45,6 +74,7 @@ Pack_Context
 
 ;**************Unpack_Context***************
 ; Description: Restores the state of a new active thread.
+;     Ends a tickless SysTick period if the new thread needs time slicing.
 ; Inputs : None
 ; Outputs: None
 
@@ -64,6 +94,8 @@ Unpack_Context
     LDR   r1, =Current_Thread
     STR   r0, [r1]
     
+    BL    OSAux_TicklessCheck    ; preserves r4-r11
+    
     POP   {r0, lr}
     BX    lr
 
@@ -124,12 +156,8 @@ Context_Switch
         EXPORT SysTick_Handler
 
 SysTick_Handler
-    LDR  r0, =Systick_Calls        ; increment
-    LDR  r1, [r0]
-    ADD  r1, r1, #1
-    STR  r1, [r0]
     PUSH {r0,lr}                ; save lr
-    BL   OSAux_Wake                ; remove threads from the wake list
+    BL   OSAux_Wake                ; advance Systick_Calls, remove threads from the wake list
     BL   Int_Context_Switch        ; switch to next task
     POP  {r0,lr}
     BX   lr
@@ -184,6 +212,70 @@ OS_Sleep_SVC
     BX    lr
     
 
+;**************OS_Wait_SVC***************
+; Decrements a counting semaphore, blocking the active thread if negative
+; Inputs : r0 holds a pointer to the semaphore
+; Outputs: None
+
+    EXPORT OS_Wait_SVC
+    IMPORT OS_Wait_SVC_C        ;as much as possible is handled in C
+        
+OS_Wait_SVC
+    CPSID I
+    PUSH  {r0,lr}
+    BL    Pack_Context
+    POP   {r0, lr}
+    PUSH  {r0, lr}
+    BL    OS_Wait_SVC_C
+    BL    Unpack_Context
+    POP   {r0, lr}
+    CPSIE I
+    BX    lr
+    
+
+;**************OS_bWait_SVC***************
+; Takes a binary semaphore, blocking the active thread if it is clear
+; Inputs : r0 holds a pointer to the semaphore
+; Outputs: None
+
+    EXPORT OS_bWait_SVC
+    IMPORT OS_bWait_SVC_C        ;as much as possible is handled in C
+        
+OS_bWait_SVC
+    CPSID I
+    PUSH  {r0,lr}
+    BL    Pack_Context
+    POP   {r0, lr}
+    PUSH  {r0, lr}
+    BL    OS_bWait_SVC_C
+    BL    Unpack_Context
+    POP   {r0, lr}
+    CPSIE I
+    BX    lr
+    
+
+;**************OS_MutexLock_SVC***************
+; Locks a mutex, blocking the active thread and raising the owner's priority
+;    if it is already locked
+; Inputs : r0 holds a pointer to the mutex
+; Outputs: None
+
+    EXPORT OS_MutexLock_SVC
+    IMPORT OS_MutexLock_SVC_C        ;as much as possible is handled in C
+        
+OS_MutexLock_SVC
+    CPSID I
+    PUSH  {r0,lr}
+    BL    Pack_Context
+    POP   {r0, lr}
+    PUSH  {r0, lr}
+    BL    OS_MutexLock_SVC_C
+    BL    Unpack_Context
+    POP   {r0, lr}
+    CPSIE I
+    BX    lr
+    
+
 ;**************StartOS***************
 ; Description: Enables SysTick, protection, and begins first task.
 ;     Causes a hard fault if no tasks have been initialized.
@@ -217,6 +309,11 @@ StartOS
     LDR   r1, =Current_Thread
     STR   r0, [r1]
     
+    LDR   r1, =DWT_CYCCNT_R
+    LDR   r1, [r1]
+    LDR   r2, =LastSwitchCycles
+    STR   r1, [r2]                ; first thread starts now
+    
     LDR   sp, [r0]                ; get TCB stack pointer
     POP   {r4-r11}
     POP   {r0-r3}
@@ -0,0 +1,202 @@
+/**
+ * File: Obstacles.c
+ * Author: Sarah Masimore
+ * Last Updated Date: 10/18/2026
+ * Description: Moving and appearing obstacles. See Obstacles.h.
+ */
+
+#include "Obstacles.h"
+#include "TrackSDF.h"
+
+static void getPose(struct obstacle * obstacle, uint32_t tick, int32_t * dx,
+                    int32_t * dy, uint8_t * visible);
+static void growRegion(struct dirty_region * region,
+                       struct obstacle * obstacle, uint8_t * empty);
+static uint16_t writeWalls(struct obstacle_set * set);
+
+/**
+ * Place obstacles at tick 0 after env's static walls.
+ */
+ErrorCode_t Obstacles_Init(struct obstacle_set * set, struct environment * env,
+                           struct obstacle * obstacles, uint8_t numObstacles,
+                           uint16_t maxWalls) {
+  uint32_t numWalls = env->numWalls;
+  uint8_t i, empty;
+
+  if (numObstacles > OBSTACLES_MAX) {
+    return E_OVERFLOW;
+  }
+  for (i = 0; i < numObstacles; i++) {
+    numWalls += obstacles[i].numWalls;
+  }
+  if (numWalls > maxWalls) {
+    return E_BUFFER_TOO_SMALL;
+  }
+
+  set->env = env;
+  set->obstacles = obstacles;
+  set->numObstacles = numObstacles;
+  set->firstWall = env->numWalls;
+  for (i = 0; i < numObstacles; i++) {
+    getPose(&obstacles[i], 0, &obstacles[i].dx, &obstacles[i].dy,
+            &obstacles[i].visible);
+  }
+  env->numWalls = writeWalls(set);
+
+  // The distance field so far only has static walls.
+  for (i = 0; i < numObstacles && env->sdf; i++) {
+    empty = 1;
+    growRegion(&set->regions[0], &obstacles[i], &empty);
+    if (!empty) {
+      TrackSDF_Update(env->sdf, env, &set->regions[0]);
+    }
+  }
+
+  env->dirty = set->regions;
+  env->numDirty = 0;
+  return E_SUCCESS;
+}
+
+/**
+ * Move obstacles to where they are at tick.
+ *
+ * An obstacle that changed gets one region covering its walls before and
+ * after, so a small move is one small update. Walls are rewritten every
+ * step since an obstacle appearing or going away shifts the ones after it.
+ */
+void Obstacles_Step(struct obstacle_set * set, uint32_t tick) {
+  struct environment * env = set->env;
+  struct obstacle * obstacle;
+  struct dirty_region * region;
+  int32_t dx, dy;
+  uint8_t i, visible, empty;
+  uint8_t numDirty = 0;
+
+  for (i = 0; i < set->numObstacles; i++) {
+    obstacle = &set->obstacles[i];
+    getPose(obstacle, tick, &dx, &dy, &visible);
+    if (dx == obstacle->dx && dy == obstacle->dy &&
+        visible == obstacle->visible) {
+      continue;
+    }
+
+    region = &set->regions[numDirty];
+    empty = 1;
+    growRegion(region, obstacle, &empty);
+    obstacle->dx = dx;
+    obstacle->dy = dy;
+    obstacle->visible = visible;
+    growRegion(region, obstacle, &empty);
+    if (!empty) {
+      numDirty++;
+    }
+  }
+
+  env->numWalls = writeWalls(set);
+  if (env->sdf) {
+    for (i = 0; i < numDirty; i++) {
+      TrackSDF_Update(env->sdf, env, &set->regions[i]);
+    }
+  }
+  env->numDirty = numDirty;
+}
+
+/**
+ * Offset and visibility of obstacle at tick, linear between keys.
+ */
+static void getPose(struct obstacle * obstacle, uint32_t tick, int32_t * dx,
+                    int32_t * dy, uint8_t * visible) {
+  const struct obstacle_key * from;
+  const struct obstacle_key * to;
+  int32_t span, t;
+  uint8_t k = 0;
+
+  if (obstacle->numKeys == 0) {
+    *dx = 0;
+    *dy = 0;
+    *visible = 1;
+    return;
+  }
+
+  while (k + 1 < obstacle->numKeys && obstacle->keys[k + 1].tick <= tick) {
+    k++;
+  }
+  from = &obstacle->keys[k];
+  *visible = from->visible;
+  if (k + 1 == obstacle->numKeys || tick <= from->tick) {
+    *dx = from->dx;
+    *dy = from->dy;
+    return;
+  }
+
+  to = &obstacle->keys[k + 1];
+  span = to->tick - from->tick;
+  t = tick - from->tick;
+  *dx = from->dx + (to->dx - from->dx) * t / span;
+  *dy = from->dy + (to->dy - from->dy) * t / span;
+}
+
+/**
+ * Grows region to cover obstacle's walls at its current offset, if it's
+ * visible. empty is set to 0 once region covers anything.
+ */
+static void growRegion(struct dirty_region * region,
+                       struct obstacle * obstacle, uint8_t * empty) {
+  const struct wall * wall;
+  uint32_t minX, maxX, minY, maxY;
+  uint8_t k;
+
+  if (!obstacle->visible) {
+    return;
+  }
+
+  for (k = 0; k < obstacle->numWalls; k++) {
+    wall = &obstacle->shape[k];
+    minX = (wall->startX < wall->endX ? wall->startX : wall->endX) +
+           obstacle->dx;
+    maxX = (wall->startX < wall->endX ? wall->endX : wall->startX) +
+           obstacle->dx;
+    minY = (wall->startY < wall->endY ? wall->startY : wall->endY) +
+           obstacle->dy;
+    maxY = (wall->startY < wall->endY ? wall->endY : wall->startY) +
+           obstacle->dy;
+    if (*empty) {
+      region->minX = minX;
+      region->maxX = maxX;
+      region->minY = minY;
+      region->maxY = maxY;
+      *empty = 0;
+      continue;
+    }
+    region->minX = minX < region->minX ? minX : region->minX;
+    region->maxX = maxX > region->maxX ? maxX : region->maxX;
+    region->minY = minY < region->minY ? minY : region->minY;
+    region->maxY = maxY > region->maxY ? maxY : region->maxY;
+  }
+}
+
+/**
+ * Writes visible obstacles' walls after the static walls. Returns the new
+ * number of env walls.
+ */
+static uint16_t writeWalls(struct obstacle_set * set) {
+  struct wall * walls = set->env->walls;
+  struct obstacle * obstacle;
+  uint16_t n = set->firstWall;
+  uint8_t i, k;
+
+  for (i = 0; i < set->numObstacles; i++) {
+    obstacle = &set->obstacles[i];
+    if (!obstacle->visible) {
+      continue;
+    }
+    for (k = 0; k < obstacle->numWalls; k++, n++) {
+      walls[n].startX = obstacle->shape[k].startX + obstacle->dx;
+      walls[n].startY = obstacle->shape[k].startY + obstacle->dy;
+      walls[n].endX = obstacle->shape[k].endX + obstacle->dx;
+      walls[n].endY = obstacle->shape[k].endY + obstacle->dy;
+    }
+  }
+
+  return n;
+}
@@ -0,0 +1,81 @@
+/**
+ * File: Obstacles.h
+ * Author: Sarah Masimore
+ * Last Updated Date: 10/18/2026
+ * Description: Moving and appearing obstacles, like a sliding door or a
+ *              pedestrian. Each obstacle is a few walls moved as one along
+ *              a script of keyframes. Visible obstacles' walls sit after the
+ *              track's static walls in env->walls, so collisions and sensors
+ *              see them like any other wall.
+ *
+ *              Each tick, an obstacle that moved, appeared, or went away
+ *              marks a dirty region covering where it was and where it is.
+ *              The track's distance field is updated in just those regions,
+ *              and cars that haven't moved only cast the sensor rays that
+ *              cross one.
+ */
+
+#ifndef OBSTACLES_H
+#define OBSTACLES_H
+
+#include <stdint.h>
+#include "ErrorCodes.h"
+#include "Simulator.h"
+
+#define OBSTACLES_MAX 64
+
+/**
+ * Where an obstacle is at a sim tick. Offsets move the obstacle's shape and
+ * are interpolated between keys; visibility changes at the key.
+ */
+struct obstacle_key {
+	uint16_t tick;
+	int16_t dx; // mm
+	int16_t dy;
+	uint8_t visible;
+};
+
+struct obstacle {
+	// Walls at offset (0, 0). Axis aligned like all walls, and must stay at
+	// x, y >= 0 at every offset.
+	const struct wall * shape;
+	uint8_t numWalls;
+
+	// Keys in tick order. Before the first key the obstacle is at the first,
+	// after the last it stays at the last.
+	const struct obstacle_key * keys;
+	uint8_t numKeys;
+
+	// Set by Obstacles_Init and Obstacles_Step.
+	int32_t dx;
+	int32_t dy;
+	uint8_t visible;
+};
+
+struct obstacle_set {
+	struct environment * env;
+	struct obstacle * obstacles;
+	uint8_t numObstacles;
+	uint16_t firstWall; // env walls before this are static
+	struct dirty_region regions[OBSTACLES_MAX];
+};
+
+/**
+ * Place obstacles at tick 0 after env's static walls. env->walls must have
+ * room for every obstacle's walls after env->numWalls. If env has a distance
+ * field, TrackSDF_EnableUpdates must have been called on it. Returns
+ * E_OVERFLOW for more than OBSTACLES_MAX obstacles or E_BUFFER_TOO_SMALL if
+ * the walls don't fit in maxWalls.
+ */
+ErrorCode_t Obstacles_Init(struct obstacle_set * set, struct environment * env,
+                           struct obstacle * obstacles, uint8_t numObstacles,
+                           uint16_t maxWalls);
+
+/**
+ * Move obstacles to where they are at tick, update env's walls and
+ * distance field, and set env's dirty regions to what changed since the last
+ * step. Call once per sim tick, before collisions and sensors.
+ */
+void Obstacles_Step(struct obstacle_set * set, uint32_t tick);
+
+#endif // OBSTACLES_H
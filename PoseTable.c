@@ -0,0 +1,549 @@
+/********** PoseTable.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host table of precomputed sensor ray distances. See
+  PoseTable.h.
+
+  File layout: header, one uint32 block offset per tile per direction
+  (BLOCK_NOT_MAPPED for tiles the car can't reach), then the blocks. Each
+  block is a block_header and (POSE_TILE + 1)^2 samples, row-major.
+*/
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "PoseTable.h"
+
+#if !defined(HOST_BUILD) && !defined(SIM_THREADED)
+#error "PoseTable_Build casts rays on several threads, define SIM_THREADED"
+#endif
+
+#define POSE_MAGIC 0x31425450 // "PTB1"
+#define BLOCK_NOT_MAPPED 0xFFFFFFFF
+#define TILE_POINTS (POSE_TILE + 1) // points per tile side, edges shared
+#define TILE_SAMPLES (TILE_POINTS * TILE_POINTS)
+#define DELTA_NONE 0xFF
+#define DELTA_MAX (DELTA_NONE - 1)
+#define RAW_NONE 0xFFFF
+#define RAW_MAX (RAW_NONE - 1)
+#define MAX_CELL_MM 128 // keeps bilinear sums within 32 bits
+#define SENSORS_PER_CAST 180 // rays per Simulator_UpdateSensors call
+
+enum block_mode {
+  MODE_NONE, // no wall in sight from any point
+  MODE_DELTA8, // base + (delta << shift), DELTA_NONE if no wall
+  MODE_RAW16, // mm, RAW_NONE if no wall
+};
+
+struct pose_table_header {
+  uint32_t magic;
+  uint32_t trackHash;
+  uint32_t cellMm;
+  uint32_t pointsX; // grid points, tilesX * POSE_TILE + 1
+  uint32_t pointsY;
+  uint32_t tilesX;
+  uint32_t tilesY;
+  uint32_t mappedTiles;
+  uint64_t blocksBytes;
+};
+
+struct block_header {
+  uint8_t mode;
+  uint8_t shift;
+  uint16_t base;
+  uint8_t sameWall[POSE_TILE]; // bit i of row j: cell's corners hit one wall
+};
+
+// Build state shared by the worker threads.
+struct pose_build {
+  struct environment env; // copy without a table, so rays are cast
+  struct pose_table_header header;
+  uint8_t * reachable; // per grid point
+  uint8_t * mapped; // per tile
+  uint8_t ** tileBlocks; // per tile, encoded blocks for all directions
+  uint32_t nextTile;
+  pthread_mutex_t lock;
+};
+
+static uint32_t trackHash(struct environment * env);
+static void findReachable(struct pose_build * build, uint32_t startX,
+                          uint32_t startY);
+static void * buildThread(void * arg);
+static uint32_t encodeBlock(const uint32_t * samples, const uint16_t * hits,
+                            uint8_t * out);
+static uint32_t blockSize(const uint8_t * block);
+static uint32_t getSample(const uint8_t * block, uint32_t k);
+
+/**************PoseTable_Build***************
+ Casts every ray from every grid point reachable from (startX, startY)
+ and writes the compressed table to path. See PoseTable.h.
+*/
+ErrorCode_t PoseTable_Build(struct environment * env, uint32_t startX,
+                            uint32_t startY, uint32_t cellMm,
+                            uint32_t numThreads, const char * path) {
+  struct pose_build build;
+  struct pose_table_header * h = &build.header;
+  pthread_t threads[64];
+  uint32_t * offsets = 0;
+  uint8_t * blocks = 0;
+  uint32_t * dedup = 0; // open addressing, offset of a block, 0 if empty
+  uint32_t numTiles, dedupSize, maxX = 0, maxY = 0, t, d, k;
+  uint64_t blocksCap;
+  ErrorCode_t result = E_SUCCESS;
+  FILE * file;
+
+  if (cellMm == 0 || cellMm > MAX_CELL_MM || numThreads == 0 ||
+      numThreads > 64) {
+    return E_INVALID_PARAM;
+  }
+
+  memset(&build, 0, sizeof(build));
+  build.env = *env;
+  build.env.poseTable = 0;
+  for (k = 0; k < env->numWalls; k++) {
+    struct wall * wall = &env->walls[k];
+    maxX = wall->startX > maxX ? wall->startX : maxX;
+    maxX = wall->endX > maxX ? wall->endX : maxX;
+    maxY = wall->startY > maxY ? wall->startY : maxY;
+    maxY = wall->endY > maxY ? wall->endY : maxY;
+  }
+  h->magic = POSE_MAGIC;
+  h->trackHash = trackHash(env);
+  h->cellMm = cellMm;
+  h->tilesX = (maxX / cellMm + POSE_TILE) / POSE_TILE;
+  h->tilesY = (maxY / cellMm + POSE_TILE) / POSE_TILE;
+  h->pointsX = h->tilesX * POSE_TILE + 1;
+  h->pointsY = h->tilesY * POSE_TILE + 1;
+  numTiles = h->tilesX * h->tilesY;
+
+  build.reachable = calloc((uint64_t)h->pointsX * h->pointsY, 1);
+  build.mapped = calloc(numTiles, 1);
+  build.tileBlocks = calloc(numTiles, sizeof(uint8_t *));
+  if (!build.reachable || !build.mapped || !build.tileBlocks) {
+    result = E_POSE_TABLE_IO;
+    goto done;
+  }
+  findReachable(&build, startX, startY);
+
+  pthread_mutex_init(&build.lock, 0);
+  for (t = 0; t < numThreads; t++) {
+    pthread_create(&threads[t], 0, buildThread, &build);
+  }
+  for (t = 0; t < numThreads; t++) {
+    pthread_join(threads[t], 0);
+  }
+  pthread_mutex_destroy(&build.lock);
+
+  // Lay out blocks, storing each distinct block once.
+  offsets = malloc((uint64_t)numTiles * POSE_DIRECTIONS * sizeof(uint32_t));
+  dedupSize = 1;
+  while (dedupSize < 2 * h->mappedTiles * POSE_DIRECTIONS + 2) {
+    dedupSize <<= 1;
+  }
+  dedup = calloc(dedupSize, sizeof(uint32_t));
+  blocksCap = 1 << 20;
+  blocks = malloc(blocksCap);
+  if (!offsets || !dedup || !blocks) {
+    result = E_POSE_TABLE_IO;
+    goto done;
+  }
+  h->blocksBytes = 2; // offset 0 marks an empty dedup slot
+  memset(blocks, 0, 2);
+  for (t = 0; t < numTiles; t++) {
+    const uint8_t * block = build.tileBlocks[t];
+    for (d = 0; d < POSE_DIRECTIONS; d++) {
+      uint32_t size, hash = 2166136261U, slot;
+      if (!build.mapped[t]) {
+        offsets[t * POSE_DIRECTIONS + d] = BLOCK_NOT_MAPPED;
+        continue;
+      }
+      if (!block) {
+        result = E_POSE_TABLE_IO; // worker ran out of memory
+        goto done;
+      }
+      size = blockSize(block);
+      for (k = 0; k < size; k++) {
+        hash = (hash ^ block[k]) * 16777619U; // FNV-1a
+      }
+      slot = hash & (dedupSize - 1);
+      while (dedup[slot] && memcmp(blocks + dedup[slot], block, size)) {
+        slot = (slot + 1) & (dedupSize - 1);
+      }
+      if (!dedup[slot]) {
+        if (h->blocksBytes + size > blocksCap) {
+          uint8_t * grown = realloc(blocks, blocksCap * 2);
+          if (!grown) {
+            result = E_POSE_TABLE_IO;
+            goto done;
+          }
+          blocks = grown;
+          blocksCap *= 2;
+        }
+        memcpy(blocks + h->blocksBytes, block, size);
+        dedup[slot] = h->blocksBytes;
+        h->blocksBytes += size;
+      }
+      offsets[t * POSE_DIRECTIONS + d] = dedup[slot];
+      block += size;
+    }
+  }
+
+  file = fopen(path, "wb");
+  if (!file ||
+      fwrite(h, sizeof(*h), 1, file) != 1 ||
+      fwrite(offsets, sizeof(uint32_t) * POSE_DIRECTIONS, numTiles, file) !=
+      numTiles ||
+      fwrite(blocks, 1, h->blocksBytes, file) != h->blocksBytes) {
+    result = E_POSE_TABLE_IO;
+  }
+  if (file && fclose(file)) {
+    result = E_POSE_TABLE_IO;
+  }
+
+done:
+  if (build.tileBlocks) {
+    for (t = 0; t < numTiles; t++) {
+      free(build.tileBlocks[t]);
+    }
+  }
+  free(build.reachable);
+  free(build.mapped);
+  free(build.tileBlocks);
+  free(offsets);
+  free(dedup);
+  free(blocks);
+  return result;
+}
+
+/**************PoseTable_Open***************
+ Maps a table written by PoseTable_Build. See PoseTable.h.
+*/
+ErrorCode_t PoseTable_Open(struct pose_table * table, const char * path,
+                           struct environment * env) {
+  const struct pose_table_header * h;
+  struct stat st;
+  uint64_t offsetsBytes;
+  void * map;
+  int fd = open(path, O_RDONLY);
+
+  if (fd < 0) {
+    return E_POSE_TABLE_IO;
+  }
+  if (fstat(fd, &st) || (uint64_t)st.st_size < sizeof(*h)) {
+    close(fd);
+    return E_POSE_TABLE_IO;
+  }
+  map = mmap(0, st.st_size, PROT_READ, MAP_PRIVATE | MAP_POPULATE, fd, 0);
+  close(fd);
+  if (map == MAP_FAILED) {
+    return E_POSE_TABLE_IO;
+  }
+
+  h = map;
+  offsetsBytes = (uint64_t)h->tilesX * h->tilesY * POSE_DIRECTIONS *
+                 sizeof(uint32_t);
+  if (h->magic != POSE_MAGIC || h->trackHash != trackHash(env) ||
+      sizeof(*h) + offsetsBytes + h->blocksBytes != (uint64_t)st.st_size) {
+    munmap(map, st.st_size);
+    return E_POSE_TABLE_MISMATCH;
+  }
+  table->header = h;
+  table->blockOffsets = (const uint32_t *)(h + 1);
+  table->blocks = (const uint8_t *)table->blockOffsets + offsetsBytes;
+  table->mapSize = st.st_size;
+  table->numWalls = env->numWalls;
+  return E_SUCCESS;
+}
+
+/**************PoseTable_Close***************
+ Unmaps a table opened by PoseTable_Open.
+*/
+void PoseTable_Close(struct pose_table * table) {
+  munmap((void *)table->header, table->mapSize);
+  table->header = 0;
+}
+
+/**************PoseTable_Lookup***************
+ Bilinear between the four grid points around (x, y). See PoseTable.h.
+*/
+uint8_t PoseTable_Lookup(struct pose_table * table, uint32_t x, uint32_t y,
+                         uint16_t absDir, uint32_t * distance) {
+  const struct pose_table_header * h = table->header;
+  const struct block_header * block;
+  uint32_t cellMm = h->cellMm;
+  uint32_t i = x / cellMm;
+  uint32_t j = y / cellMm;
+  uint32_t offset, k, d00, d10, d01, d11, tx, ty;
+
+  if (i >= h->pointsX - 1 || j >= h->pointsY - 1) {
+    return 0;
+  }
+  offset = table->blockOffsets[((j / POSE_TILE) * h->tilesX + i / POSE_TILE) *
+                               POSE_DIRECTIONS + absDir];
+  if (offset == BLOCK_NOT_MAPPED) {
+    return 0;
+  }
+  block = (const struct block_header *)(table->blocks + offset);
+  if (block->mode == MODE_NONE) {
+    *distance = MAX_U32INT;
+    return 1;
+  }
+
+  // Corners that see different walls have an edge between them.
+  if (!(block->sameWall[j % POSE_TILE] & (1 << (i % POSE_TILE)))) {
+    return 0;
+  }
+  k = (j % POSE_TILE) * TILE_POINTS + i % POSE_TILE;
+  d00 = getSample((const uint8_t *)block, k);
+  d10 = getSample((const uint8_t *)block, k + 1);
+  d01 = getSample((const uint8_t *)block, k + TILE_POINTS);
+  d11 = getSample((const uint8_t *)block, k + TILE_POINTS + 1);
+  if (d00 == MAX_U32INT) {
+    *distance = MAX_U32INT; // all four see no wall
+    return 1;
+  }
+
+  tx = x - i * cellMm;
+  ty = y - j * cellMm;
+  *distance = (d00 * (cellMm - tx) * (cellMm - ty) + d10 * tx * (cellMm - ty) +
+               d01 * (cellMm - tx) * ty + d11 * tx * ty +
+               cellMm * cellMm / 2) / (cellMm * cellMm);
+  return 1;
+}
+
+/**************PoseTable_Bytes***************
+ Outputs: size of the mapped file, and of raw 16-bit distances for the
+          same mapped tiles in rawBytes
+*/
+uint64_t PoseTable_Bytes(struct pose_table * table, uint64_t * rawBytes) {
+  *rawBytes = (uint64_t)table->header->mappedTiles * POSE_TILE * POSE_TILE *
+              POSE_DIRECTIONS * sizeof(uint16_t);
+  return table->mapSize;
+}
+
+/**
+ * FNV-1a of the walls, so a table is never used with another track.
+ */
+static uint32_t trackHash(struct environment * env) {
+  uint32_t hash = 2166136261U;
+  const uint8_t * bytes = (const uint8_t *)env->walls;
+  uint32_t k;
+
+  for (k = 0; k < env->numWalls * sizeof(struct wall); k++) {
+    hash = (hash ^ bytes[k]) * 16777619U;
+  }
+  return (hash ^ env->numWalls) * 16777619U;
+}
+
+/**
+ * Flood fills the grid from the point nearest (startX, startY), stepping
+ * between neighboring points that Simulator_HitWall lets the car move
+ * between. Tiles with a cell whose four corners are reachable are mapped.
+ */
+static void findReachable(struct pose_build * build, uint32_t startX,
+                          uint32_t startY) {
+  struct pose_table_header * h = &build->header;
+  uint32_t cellMm = h->cellMm;
+  uint32_t numPoints = h->pointsX * h->pointsY;
+  uint32_t * queue = malloc(numPoints * sizeof(uint32_t));
+  uint32_t head = 0, tail = 0, i, j, n;
+  static const int8_t steps[4][2] = {{1, 0}, {-1, 0}, {0, 1}, {0, -1}};
+
+  // Round up, points on x = 0 or y = 0 are the environment boundary.
+  i = (startX + cellMm - 1) / cellMm;
+  j = (startY + cellMm - 1) / cellMm;
+  if (!queue || i >= h->pointsX || j >= h->pointsY ||
+      Simulator_HitWall(&build->env, startX, startY, i * cellMm, j * cellMm)) {
+    free(queue);
+    return;
+  }
+  build->reachable[j * h->pointsX + i] = 1;
+  queue[tail++] = j * h->pointsX + i;
+
+  while (head < tail) {
+    uint32_t point = queue[head++];
+    i = point % h->pointsX;
+    j = point / h->pointsX;
+    for (n = 0; n < 4; n++) {
+      uint32_t nextI = i + steps[n][0];
+      uint32_t nextJ = j + steps[n][1];
+      uint32_t next = nextJ * h->pointsX + nextI;
+      if (nextI >= h->pointsX || nextJ >= h->pointsY ||
+          build->reachable[next] ||
+          Simulator_HitWall(&build->env, i * cellMm, j * cellMm,
+                            nextI * cellMm, nextJ * cellMm)) {
+        continue;
+      }
+      build->reachable[next] = 1;
+      queue[tail++] = next;
+    }
+  }
+  free(queue);
+
+  for (j = 0; j < h->pointsY - 1; j++) {
+    for (i = 0; i < h->pointsX - 1; i++) {
+      uint8_t * r = &build->reachable[j * h->pointsX + i];
+      if (r[0] && r[1] && r[h->pointsX] && r[h->pointsX + 1] &&
+          !build->mapped[(j / POSE_TILE) * h->tilesX + i / POSE_TILE]) {
+        build->mapped[(j / POSE_TILE) * h->tilesX + i / POSE_TILE] = 1;
+        h->mappedTiles++;
+      }
+    }
+  }
+}
+
+/**
+ * Worker: takes the next mapped tile, casts all rays from its points, and
+ * encodes one block per direction.
+ */
+static void * buildThread(void * arg) {
+  struct pose_build * build = arg;
+  struct pose_table_header * h = &build->header;
+  uint32_t numTiles = h->tilesX * h->tilesY;
+  struct sensor sensors[SENSORS_PER_CAST];
+  uint32_t * dist = malloc(TILE_SAMPLES * POSE_DIRECTIONS * sizeof(uint32_t));
+  uint16_t * hits = malloc(TILE_SAMPLES * POSE_DIRECTIONS * sizeof(uint16_t));
+  struct car car;
+  uint32_t tile, k, d, half;
+
+  memset(sensors, 0, sizeof(sensors));
+  for (k = 0; k < SENSORS_PER_CAST; k++) {
+    sensors[k].dir = k;
+    sensors[k].hitWall = SENSOR_NO_WALL;
+  }
+  memset(&car, 0, sizeof(car));
+  car.numSensors = SENSORS_PER_CAST;
+  car.sensors = sensors;
+
+  while (dist && hits) {
+    uint8_t * out;
+    pthread_mutex_lock(&build->lock);
+    while (build->nextTile < numTiles && !build->mapped[build->nextTile]) {
+      build->nextTile++;
+    }
+    tile = build->nextTile++;
+    pthread_mutex_unlock(&build->lock);
+    if (tile >= numTiles) {
+      break;
+    }
+
+    for (k = 0; k < TILE_SAMPLES; k++) {
+      car.x = ((tile % h->tilesX) * POSE_TILE + k % TILE_POINTS) * h->cellMm;
+      car.y = ((tile / h->tilesX) * POSE_TILE + k / TILE_POINTS) * h->cellMm;
+      for (half = 0; half < POSE_DIRECTIONS / SENSORS_PER_CAST; half++) {
+        car.dir = half * SENSORS_PER_CAST;
+        Simulator_UpdateSensors(&car, &build->env);
+        for (d = 0; d < SENSORS_PER_CAST; d++) {
+          dist[(car.dir + d) * TILE_SAMPLES + k] = sensors[d].val;
+          hits[(car.dir + d) * TILE_SAMPLES + k] = sensors[d].hitWall;
+        }
+      }
+    }
+
+    out = malloc(POSE_DIRECTIONS *
+                 (sizeof(struct block_header) + TILE_SAMPLES * 2));
+    if (!out) {
+      break;
+    }
+    build->tileBlocks[tile] = out;
+    for (d = 0; d < POSE_DIRECTIONS; d++) {
+      out += encodeBlock(&dist[d * TILE_SAMPLES], &hits[d * TILE_SAMPLES], out);
+    }
+  }
+  free(dist);
+  free(hits);
+  return 0;
+}
+
+/**
+ * Encodes one tile-direction block into out and returns its size. hits are
+ * the walls each sample's ray hit, for marking cells that can be
+ * interpolated.
+ */
+static uint32_t encodeBlock(const uint32_t * samples, const uint16_t * hits,
+                            uint8_t * out) {
+  struct block_header * block = (struct block_header *)out;
+  uint32_t min = MAX_U32INT, max = 0, i, j, k, shift = 0;
+  uint8_t * deltas = out + sizeof(*block);
+  uint16_t * raw = (uint16_t *)(out + sizeof(*block));
+
+  for (k = 0; k < TILE_SAMPLES; k++) {
+    if (samples[k] != MAX_U32INT) {
+      min = samples[k] < min ? samples[k] : min;
+      max = samples[k] > max ? samples[k] : max;
+    }
+  }
+  block->shift = 0;
+  block->base = 0;
+  for (j = 0; j < POSE_TILE; j++) {
+    block->sameWall[j] = 0;
+    for (i = 0; i < POSE_TILE; i++) {
+      k = j * TILE_POINTS + i;
+      if (hits[k] == hits[k + 1] && hits[k] == hits[k + TILE_POINTS] &&
+          hits[k] == hits[k + TILE_POINTS + 1]) {
+        block->sameWall[j] |= 1 << i;
+      }
+    }
+  }
+  if (min == MAX_U32INT) {
+    block->mode = MODE_NONE;
+    return blockSize(out);
+  }
+
+  while (((max - min + (1U << shift >> 1)) >> shift) > DELTA_MAX &&
+         shift < POSE_MAX_SHIFT) {
+    shift++;
+  }
+  if (((max - min + (1U << shift >> 1)) >> shift) <= DELTA_MAX &&
+      min <= RAW_MAX) {
+    block->mode = MODE_DELTA8;
+    block->shift = shift;
+    block->base = min;
+    for (k = 0; k < TILE_SAMPLES; k++) {
+      deltas[k] = samples[k] == MAX_U32INT ? DELTA_NONE :
+                  (samples[k] - min + (1U << shift >> 1)) >> shift;
+    }
+    if (TILE_SAMPLES & 1) {
+      deltas[TILE_SAMPLES] = 0; // keep blocks 2 byte aligned
+    }
+  } else {
+    block->mode = MODE_RAW16;
+    for (k = 0; k < TILE_SAMPLES; k++) {
+      raw[k] = samples[k] == MAX_U32INT ? RAW_NONE :
+               samples[k] > RAW_MAX ? RAW_MAX : samples[k];
+    }
+  }
+  return blockSize(out);
+}
+
+/**
+ * Bytes in an encoded block, header included. Always even.
+ */
+static uint32_t blockSize(const uint8_t * block) {
+  const struct block_header * header = (const struct block_header *)block;
+  return sizeof(*header) + (header->mode == MODE_NONE ? 0 :
+         header->mode == MODE_DELTA8 ? (TILE_SAMPLES + 1) & ~1 :
+                                       TILE_SAMPLES * 2);
+}
+
+/**
+ * Sample k of a MODE_DELTA8 or MODE_RAW16 block in mm, MAX_U32INT if the
+ * ray from that point sees no wall.
+ */
+static uint32_t getSample(const uint8_t * block, uint32_t k) {
+  const struct block_header * header = (const struct block_header *)block;
+  const uint8_t * data = block + sizeof(*header);
+
+  if (header->mode == MODE_DELTA8) {
+    return data[k] == DELTA_NONE ? MAX_U32INT :
+           header->base + ((uint32_t)data[k] << header->shift);
+  }
+  return ((const uint16_t *)data)[k] == RAW_NONE ? MAX_U32INT :
+         ((const uint16_t *)data)[k];
+}
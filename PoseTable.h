@@ -0,0 +1,90 @@
+/********** PoseTable.h **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host (Linux) table of precomputed sensor ray distances. On a
+  static track a ray's distance depends only on where it starts and its
+  absolute direction, and directions are whole degrees, so the table holds
+  the exact raycast for every grid point the car can reach and all 360
+  directions. Simulator_UpdateSensors reads it instead of casting rays.
+
+  Grid points are cellMm apart. Points are grouped into tiles of
+  POSE_TILE x POSE_TILE cells, stored per direction as one block that also
+  holds the tile's far edge, so interpolation never leaves the block. A
+  block is either all "no wall", 8-bit deltas from the tile's nearest hit
+  (scaled by up to 2^POSE_MAX_SHIFT mm), or raw 16-bit mm when the spread
+  is too big. Identical blocks are stored once. The file is memory mapped.
+
+  Along a fixed direction, distance to one wall is linear in position, so
+  bilinear interpolation between points that hit the same wall is exact up
+  to quantization. Each block marks the cells whose four corner rays hit
+  the same wall (or all see none). Other cells have a wall edge between
+  their corner rays and aren't interpolated; Lookup returns 0 and the ray
+  is cast as usual.
+*/
+
+#ifndef POSETABLE_H
+#define POSETABLE_H
+
+#include <stdint.h>
+#include "ErrorCodes.h"
+#include "Simulator.h"
+
+// Uncomment to use the table in Simulator_UpdateSensors (host only).
+//#define POSE_TABLE
+
+#define POSE_TILE 8 // cells per tile side, at most 8 (one mask byte per row)
+#define POSE_MAX_SHIFT 2 // 8-bit deltas are in units of up to 4 mm
+#define POSE_DIRECTIONS 360
+
+struct pose_table_header;
+
+struct pose_table {
+  const struct pose_table_header * header;
+  const uint32_t * blockOffsets; // per tile per direction, into blocks
+  const uint8_t * blocks;
+  uint64_t mapSize;
+  uint16_t numWalls; // env walls the table covers, later ones are cast
+};
+
+/**************PoseTable_Build***************
+ Casts every ray from every grid point reachable from (startX, startY)
+ without crossing a wall, spread over numThreads threads, and writes the
+ compressed table to path.
+ Inputs : env, start point, grid spacing mm, threads, output path
+ Outputs: E_SUCCESS, E_INVALID_PARAM, or E_POSE_TABLE_IO
+*/
+ErrorCode_t PoseTable_Build(struct environment * env, uint32_t startX,
+                            uint32_t startY, uint32_t cellMm,
+                            uint32_t numThreads, const char * path);
+
+/**************PoseTable_Open***************
+ Maps a table written by PoseTable_Build. Walls added to env afterwards
+ (moving obstacles) aren't in the table and are tested as usual.
+ Inputs : table to fill, path, env the table must have been built for
+ Outputs: E_SUCCESS, E_POSE_TABLE_IO, or E_POSE_TABLE_MISMATCH if the file
+          is not a table of env's walls
+*/
+ErrorCode_t PoseTable_Open(struct pose_table * table, const char * path,
+                           struct environment * env);
+
+/**************PoseTable_Close***************
+ Unmaps a table opened by PoseTable_Open.
+*/
+void PoseTable_Close(struct pose_table * table);
+
+/**************PoseTable_Lookup***************
+ Inputs : car position mm, absolute ray direction 0 - 359
+ Outputs: 1 and the distance (MAX_U32INT if no wall in sight), or 0 if the
+          ray has to be cast
+*/
+uint8_t PoseTable_Lookup(struct pose_table * table, uint32_t x, uint32_t y,
+                         uint16_t absDir, uint32_t * distance);
+
+/**************PoseTable_Bytes***************
+ Outputs: size of the mapped file, and of the same table stored as raw
+          16-bit distances in rawBytes
+*/
+uint64_t PoseTable_Bytes(struct pose_table * table, uint64_t * rawBytes);
+
+#endif // POSETABLE_H
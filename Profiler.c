@@ -0,0 +1,183 @@
+/********** Profiler.c ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Optional instrumentation of interrupt-disabled time and ISR
+  latency using the DWT cycle counter. Enabled by defining PROFILE_CRITICAL
+  in Profiler.h.
+*/
+
+#include <stdint.h>
+#include "Profiler.h"
+
+#ifdef PROFILE_CRITICAL
+
+#include "terminal.h"
+
+struct profile_stat {
+  uint32_t count;
+  uint32_t max;
+  uint64_t total;
+};
+
+static struct profile_stat CriticalStats[NUM_CRITICAL_SITES];
+static struct profile_stat IsrStats[NUM_ISR_STATS];
+
+// Only the outermost critical section is timed, and nothing can preempt it,
+// so one start time is enough.
+static uint32_t CriticalStart;
+
+static char * SiteNames[NUM_CRITICAL_SITES] = {
+  "OS_AddThread alloc",
+  "OS_AddThread ready",
+  "OSAux_Wake",
+  "OS_Signal",
+  "OS_bSignal",
+  "OS_MutexUnlock",
+};
+
+static char * IsrNames[NUM_ISR_STATS] = {
+  "SysTick latency",
+  "Timer5 latency",
+  "Ping holdoff error",
+  "Ping echo error",
+};
+
+static void record(struct profile_stat * stat, uint32_t cycles);
+static void printStats(char * name, struct profile_stat * stat);
+
+/**************Profiler_Init***************
+Description: Enables the DWT cycle counter and clears stats.
+Inputs: none
+Outputs: none
+*/
+void Profiler_Init(void) {
+  DEMCR_R |= DEMCR_TRCENA;
+  DWT_CYCCNT_R = 0;
+  DWT_CTRL_R |= DWT_CTRL_CYCCNTENA;
+  Profiler_Clear();
+}
+
+/**************Profiler_StartCritical***************
+Description: StartCritical, timing the section if interrupts were enabled.
+Inputs: site - call site
+Outputs: previous I bit
+*/
+uint32_t Profiler_StartCritical(CriticalSite_t site) {
+  uint32_t oldState = StartCritical();
+  if (oldState == 0) {
+    CriticalStart = DWT_CYCCNT_R;
+  }
+  return oldState;
+}
+
+/**************Profiler_EndCritical***************
+Description: EndCritical, recording time interrupts were disabled if this 
+  closes the outermost critical section.
+Inputs: site - call site
+        oldState - previous I bit returned by Profiler_StartCritical
+Outputs: none
+*/
+void Profiler_EndCritical(CriticalSite_t site, uint32_t oldState) {
+  if (oldState == 0) {
+    record(&CriticalStats[site], DWT_CYCCNT_R - CriticalStart);
+  }
+  EndCritical(oldState);
+}
+
+/**************Profiler_RecordLatency***************
+Description: Records one ISR latency or timing error sample, in cycles.
+Inputs: stat - which ISR stat
+        cycles - latency in cycles
+Outputs: none
+*/
+void Profiler_RecordLatency(IsrStat_t stat, uint32_t cycles) {
+  uint32_t oldState = StartCritical();
+  record(&IsrStats[stat], cycles);
+  EndCritical(oldState);
+}
+
+/**************Profiler_Cycles***************
+Description: Returns the DWT cycle counter.
+Inputs: none
+Outputs: cycle count
+*/
+uint32_t Profiler_Cycles(void) {
+  return DWT_CYCCNT_R;
+}
+
+/**************Profiler_PrintToTerminal***************
+Description: Prints count, max and average cycles for every critical section
+  and ISR stat.
+Inputs: none
+Outputs: none
+*/
+void Profiler_PrintToTerminal(void) {
+  struct profile_stat stats[NUM_CRITICAL_SITES + NUM_ISR_STATS];
+  int i;
+  uint32_t oldState;
+  
+  // Copy so printing doesn't race with new samples.
+  oldState = StartCritical();
+  for (i = 0; i < NUM_CRITICAL_SITES; i++) {
+    stats[i] = CriticalStats[i];
+  }
+  for (i = 0; i < NUM_ISR_STATS; i++) {
+    stats[NUM_CRITICAL_SITES + i] = IsrStats[i];
+  }
+  EndCritical(oldState);
+  
+  terminal_printString("\r\n----- Interrupts disabled (cycles) -----\r\n");
+  terminal_printString("site,count,max,avg\r\n");
+  for (i = 0; i < NUM_CRITICAL_SITES; i++) {
+    printStats(SiteNames[i], &stats[i]);
+  }
+  
+  terminal_printString("----- ISR latency (cycles) -----\r\n");
+  terminal_printString("isr,count,max,avg\r\n");
+  for (i = 0; i < NUM_ISR_STATS; i++) {
+    printStats(IsrNames[i], &stats[NUM_CRITICAL_SITES + i]);
+  }
+}
+
+/**************Profiler_Clear***************
+Description: Clears all stats.
+Inputs: none
+Outputs: none
+*/
+void Profiler_Clear(void) {
+  int i;
+  uint32_t oldState = StartCritical();
+  for (i = 0; i < NUM_CRITICAL_SITES; i++) {
+    CriticalStats[i].count = 0;
+    CriticalStats[i].max = 0;
+    CriticalStats[i].total = 0;
+  }
+  for (i = 0; i < NUM_ISR_STATS; i++) {
+    IsrStats[i].count = 0;
+    IsrStats[i].max = 0;
+    IsrStats[i].total = 0;
+  }
+  EndCritical(oldState);
+}
+
+static void record(struct profile_stat * stat, uint32_t cycles) {
+  stat->count++;
+  stat->total += cycles;
+  if (cycles > stat->max) {
+    stat->max = cycles;
+  }
+}
+
+static void printStats(char * name, struct profile_stat * stat) {
+  terminal_printString(name);
+  terminal_printString(",");
+  terminal_printValueDec(stat->count);
+  terminal_printString(",");
+  terminal_printValueDec(stat->max);
+  terminal_printString(",");
+  terminal_printValueDec(stat->count ? stat->total / stat->count : 0);
+  terminal_printString("\r\n");
+}
+
+#endif
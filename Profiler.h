@@ -0,0 +1,119 @@
+/********** Profiler.h ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Optional instrumentation of interrupt-disabled time and ISR
+  latency using the DWT cycle counter. Enabled by defining PROFILE_CRITICAL.
+  When disabled, PROFILED_START_CRITICAL/PROFILED_END_CRITICAL compile down
+  to StartCritical/EndCritical and the ISR hooks compile out. Not supported
+  in HOST_BUILD.
+*/
+
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <stdint.h>
+
+// Uncomment to profile critical sections and ISR latency. Adds a "prof" 
+// terminal command.
+//#define PROFILE_CRITICAL
+
+// Core debug registers, not in tm4c123gh6pm.h. The cycle counter is also
+// used by OSasm.s for per-thread CPU accounting.
+#define DEMCR_R                 (*((volatile uint32_t *)0xE000EDFC))
+#define DEMCR_TRCENA            0x01000000  // Enable DWT
+#define DWT_CTRL_R              (*((volatile uint32_t *)0xE0001000))
+#define DWT_CTRL_CYCCNTENA      0x00000001  // Enable cycle counter
+#define DWT_CYCCNT_R            (*((volatile uint32_t *)0xE0001004))
+
+#if defined(PROFILE_CRITICAL) && defined(HOST_BUILD)
+#error "PROFILE_CRITICAL needs the DWT cycle counter, not available on host"
+#endif
+
+// Critical section call sites. Keep in sync with SiteNames in Profiler.c.
+typedef enum CriticalSite {
+  CS_ADD_THREAD_ALLOC,
+  CS_ADD_THREAD_READY,
+  CS_WAKE,
+  CS_SIGNAL,
+  CS_BSIGNAL,
+  CS_MUTEX_UNLOCK,
+  NUM_CRITICAL_SITES
+} CriticalSite_t;
+
+// ISR latency stats. Keep in sync with IsrNames in Profiler.c.
+typedef enum IsrStat {
+  ISR_SYSTICK,       // SysTick pend to OSAux_Wake
+  ISR_TIMER5,        // Timer5 timeout to Timer5A_Handler
+  ISR_PING_HOLDOFF,  // Ping holdoff error, GPIOPortA_Handler to TimerxA_Handler
+  ISR_PING_ECHO,     // Ping echo pulse width error
+  NUM_ISR_STATS
+} IsrStat_t;
+
+#ifdef PROFILE_CRITICAL
+
+#define PROFILED_START_CRITICAL(site) Profiler_StartCritical(site)
+#define PROFILED_END_CRITICAL(site, oldState) \
+  Profiler_EndCritical(site, oldState)
+
+/**************Profiler_Init***************
+Description: Enables the DWT cycle counter and clears stats.
+Inputs: none
+Outputs: none
+*/
+void Profiler_Init(void);
+
+/**************Profiler_StartCritical***************
+Description: StartCritical, timing the section if interrupts were enabled.
+Inputs: site - call site
+Outputs: previous I bit
+*/
+uint32_t Profiler_StartCritical(CriticalSite_t site);
+
+/**************Profiler_EndCritical***************
+Description: EndCritical, recording time interrupts were disabled if this 
+  closes the outermost critical section.
+Inputs: site - call site
+        oldState - previous I bit returned by Profiler_StartCritical
+Outputs: none
+*/
+void Profiler_EndCritical(CriticalSite_t site, uint32_t oldState);
+
+/**************Profiler_RecordLatency***************
+Description: Records one ISR latency or timing error sample, in cycles.
+Inputs: stat - which ISR stat
+        cycles - latency in cycles
+Outputs: none
+*/
+void Profiler_RecordLatency(IsrStat_t stat, uint32_t cycles);
+
+/**************Profiler_Cycles***************
+Description: Returns the DWT cycle counter.
+Inputs: none
+Outputs: cycle count
+*/
+uint32_t Profiler_Cycles(void);
+
+/**************Profiler_PrintToTerminal***************
+Description: Prints count, max and average cycles for every critical section
+  and ISR stat.
+Inputs: none
+Outputs: none
+*/
+void Profiler_PrintToTerminal(void);
+
+/**************Profiler_Clear***************
+Description: Clears all stats.
+Inputs: none
+Outputs: none
+*/
+void Profiler_Clear(void);
+
+#else
+
+#define PROFILED_START_CRITICAL(site) StartCritical()
+#define PROFILED_END_CRITICAL(site, oldState) EndCritical(oldState)
+
+#endif
+
+#endif
@@ -0,0 +1,133 @@
+/**
+ * File: Race.c
+ * Author: Sarah Masimore
+ * Last Updated Date: 10/18/2026
+ * Description: Checkpoint gates, laps, and sector timing. See Race.h.
+ */
+
+#include "Race.h"
+
+static uint8_t crossGate(const struct gate * gate, int64_t px, int64_t py,
+                         int64_t qx, int64_t qy, int8_t sign,
+                         uint32_t tickStart, uint32_t tickUs,
+                         uint32_t * time);
+
+/**
+ * Start race with the car before gates[0] at time 0.
+ */
+void Race_Init(struct race * race, const struct gate * gates,
+               uint8_t numGates, uint8_t numLaps) {
+  race->gates = gates;
+  race->numGates = numGates;
+  race->numLaps = numLaps;
+  race->nextGate = 0;
+  race->lapsDone = 0;
+  race->wrongWay = 0;
+  race->lapStart = 0;
+  race->sectorStart = 0;
+  race->prevLapStart = 0;
+  race->prevSectorStart = 0;
+  race->split.event = RACE_NONE;
+}
+
+/**
+ * Check the car's move this tick against the next gate and the last one.
+ */
+enum race_event Race_Step(struct race * race, uint32_t prevX, uint32_t prevY,
+                          uint32_t x, uint32_t y, uint32_t tickStart,
+                          uint32_t tickUs) {
+  struct race_split * split = &race->split;
+  uint8_t last = race->nextGate ? race->nextGate - 1 : race->numGates - 1;
+  uint32_t time;
+
+  if (race->numGates == 0 || race->lapsDone == race->numLaps) {
+    return RACE_NONE;
+  }
+
+  if (crossGate(&race->gates[race->nextGate], prevX, prevY, x, y, 1,
+                tickStart, tickUs, &time)) {
+    split->gate = race->nextGate;
+    split->lap = race->lapsDone + 1;
+    split->time = time;
+    split->lapTime = time - race->lapStart;
+    split->sectorTime = time - race->sectorStart;
+    split->event = RACE_SECTOR;
+    race->prevSectorStart = race->sectorStart;
+    race->sectorStart = time;
+    race->wrongWay = 0;
+    race->nextGate++;
+    if (race->nextGate == race->numGates) {
+      race->nextGate = 0;
+      race->lapsDone++;
+      race->prevLapStart = race->lapStart;
+      race->lapStart = time;
+      split->event = race->lapsDone == race->numLaps ? RACE_FINISHED :
+                                                       RACE_LAP;
+    }
+    return split->event;
+  }
+
+  // Backing over the last gate undoes it, so it counts again when the car
+  // turns around and crosses it going the right way. Only one gate can be
+  // undone, since only the one sector and lap start before it are kept.
+  if (!race->wrongWay && crossGate(&race->gates[last], prevX, prevY, x, y,
+                                   -1, tickStart, tickUs, &time)) {
+    if (race->nextGate == 0 && race->lapsDone == 0) {
+      // Backed over the start/finish line before the first lap, nothing
+      // to undo.
+      race->wrongWay = 1;
+    } else {
+      if (race->nextGate == 0) {
+        race->lapsDone--;
+        race->lapStart = race->prevLapStart;
+      }
+      race->nextGate = last;
+      race->sectorStart = race->prevSectorStart;
+      race->wrongWay = 1;
+    }
+    split->gate = last;
+    split->lap = race->lapsDone + 1;
+    split->time = time;
+    split->lapTime = time - race->lapStart;
+    split->sectorTime = 0;
+    split->event = RACE_WRONG_WAY;
+    return RACE_WRONG_WAY;
+  }
+
+  return RACE_NONE;
+}
+
+/**
+ * Whether the move from p to q crosses gate going from its right side to
+ * its left (sign 1) or the other way (sign -1). If so, time is when, taking
+ * the car's speed as constant over the tick.
+ *
+ * Sides are the sign of the cross product of the gate with the point, and
+ * the move crosses the gate's segment, not just its line, if the gate's
+ * ends are on opposite sides of the move. Ending exactly on a gate counts
+ * as its left side.
+ */
+static uint8_t crossGate(const struct gate * gate, int64_t px, int64_t py,
+                         int64_t qx, int64_t qy, int8_t sign,
+                         uint32_t tickStart, uint32_t tickUs,
+                         uint32_t * time) {
+  int64_t gx = (int64_t)gate->endX - gate->startX;
+  int64_t gy = (int64_t)gate->endY - gate->startY;
+  int64_t mx = qx - px;
+  int64_t my = qy - py;
+  int64_t sideP = gx * (py - gate->startY) - gy * (px - gate->startX);
+  int64_t sideQ = gx * (qy - gate->startY) - gy * (qx - gate->startX);
+  int64_t sideStart = mx * (gate->startY - py) - my * (gate->startX - px);
+  int64_t sideEnd = mx * (gate->endY - py) - my * (gate->endX - px);
+
+  if (sign > 0 ? sideP >= 0 || sideQ < 0 : sideP < 0 || sideQ >= 0) {
+    return 0;
+  }
+  if ((sideStart > 0 && sideEnd > 0) || (sideStart < 0 && sideEnd < 0)) {
+    return 0;
+  }
+
+  // sideP and sideQ have opposite signs, so this is within the tick.
+  *time = tickStart + (uint32_t)((int64_t)tickUs * sideP / (sideP - sideQ));
+  return 1;
+}
@@ -0,0 +1,87 @@
+/**
+ * File: Race.h
+ * Author: Sarah Masimore
+ * Last Updated Date: 10/18/2026
+ * Description: Checkpoint gates, laps, and sector timing. A course is a list
+ *              of gates the car must cross in order. Crossing the last gate
+ *              ends a lap and each gate ends a sector, so an open course is
+ *              one lap ending at its finish, and a circuit's last gate is
+ *              its start/finish line with the car starting just past it.
+ *
+ *              Each tick only the next gate is tested, and the gate before
+ *              it for crossing back the wrong way, so the cost doesn't grow
+ *              with the course. Backing over further gates isn't seen,
+ *              nor are they counted again going forward. Crossing times are interpolated along the
+ *              tick's move to the microsecond.
+ */
+
+#ifndef RACE_H
+#define RACE_H
+
+#include <stdint.h>
+
+/**
+ * Segment across the track, from its left edge to its right edge as the car
+ * sees them going the right way. Crossed going the right way when the car
+ * goes from the gate's right side to its left, looking from start to end.
+ */
+struct gate {
+	uint32_t startX;
+	uint32_t startY;
+	uint32_t endX;
+	uint32_t endY;
+};
+
+enum race_event {
+	RACE_NONE,
+	RACE_SECTOR, // crossed a gate, sector done
+	RACE_LAP, // crossed the last gate, lap done
+	RACE_FINISHED, // last lap done
+	RACE_WRONG_WAY // crossed back over the last gate crossed
+};
+
+/**
+ * When a gate was crossed. Times in us from the race start.
+ */
+struct race_split {
+	enum race_event event;
+	uint8_t lap; // 1 is the first lap
+	uint8_t gate;
+	uint32_t time;
+	uint32_t lapTime; // since the lap started, set for every gate
+	uint32_t sectorTime; // since the gate before, 0 for RACE_WRONG_WAY
+};
+
+struct race {
+	const struct gate * gates;
+	uint8_t numGates;
+	uint8_t numLaps;
+
+	// Set by Race_Step.
+	uint8_t nextGate;
+	uint8_t lapsDone;
+	uint8_t wrongWay; // crossed back and not yet crossed forward again
+	uint32_t lapStart;
+	uint32_t sectorStart;
+	uint32_t prevLapStart; // restored if the car backs over a gate
+	uint32_t prevSectorStart;
+	struct race_split split; // last event
+};
+
+/**
+ * Start race with the car before gates[0] at time 0.
+ */
+void Race_Init(struct race * race, const struct gate * gates,
+               uint8_t numGates, uint8_t numLaps);
+
+/**
+ * Check the car's move this tick, from (prevX, prevY) to (x, y) over
+ * tickUs starting at tickStart, against the next gate and the last one.
+ * Returns what happened and, unless RACE_NONE, fills race->split. At most
+ * one gate is counted per tick.
+ */
+enum race_event Race_Step(struct race * race, uint32_t prevX, uint32_t prevY,
+                          uint32_t x, uint32_t y, uint32_t tickStart,
+                          uint32_t tickUs);
+
+#endif // RACE_H
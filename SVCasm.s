@@ -12,6 +12,15 @@ SVC_Table
         
         IMPORT OS_Sleep_SVC
     DCD OS_Sleep_SVC                ; SVC 2
+        
+        IMPORT OS_Wait_SVC
+    DCD OS_Wait_SVC                 ; SVC 3
+        
+        IMPORT OS_bWait_SVC
+    DCD OS_bWait_SVC                ; SVC 4
+        
+        IMPORT OS_MutexLock_SVC
+    DCD OS_MutexLock_SVC            ; SVC 5
             
 SVC_Handler                        ; This should NOT be called from another ISR
                                 ; There's no point to that, anyway...
@@ -10,12 +10,14 @@ Description: Handles service calls (those which are written in C)
 #include "OS.h"
 #include "terminal.h"
 #include "getHighest.h"
+#include "OSAux.h"
 
 
 extern TCB_t* ReadyThreads[NUM_PRIORITY_LEVELS];
 extern uint32_t priorityOccupied;
 
 extern TCB_t * SleepThreads;
+extern TCB_t * InactiveThreads;
 
 extern TCB_t TCBs[10];
 
@@ -46,6 +48,60 @@ void removeActiveThread(void){
   }
 }
 
+/******** blockActiveThread ************
+ Moves the active thread from the ready list to a semaphore's blocked list
+ Inputs: semaPt - semaphore to block on
+ Outputs: none
+*/
+static void blockActiveThread(Sema4Type *semaPt){
+  removeActiveThread();
+  CS_Ignore = 1;
+  OSAux_BlockedInsert(semaPt, Current_Thread);
+}
+
+/**************OS_Wait_SVC_C***************
+ Implements counting semaphore blocking
+ Inputs : semaPt - pointer to the semaphore to check
+ Outputs: None
+*/
+void OS_Wait_SVC_C(Sema4Type *semaPt){
+  semaPt->Value--;
+  if(semaPt->Value < 0){
+    blockActiveThread(semaPt);
+  }
+}
+
+/**************OS_bWait_SVC_C***************
+ Implements binary semaphore blocking
+ Inputs : semaPt - pointer to the semaphore to check
+ Outputs: None
+*/
+void OS_bWait_SVC_C(Sema4Type *semaPt){
+  if(semaPt->Value > 0){
+    semaPt->Value = 0;
+  }
+  else{
+    blockActiveThread(semaPt);
+  }
+}
+
+/**************OS_MutexLock_SVC_C***************
+ Implements mutex blocking with priority inheritance
+ Inputs : semaPt - pointer to the mutex
+ Outputs: None
+*/
+void OS_MutexLock_SVC_C(Sema4Type *semaPt){
+  if(semaPt->Value > 0){
+    semaPt->Value = 0;
+    semaPt->owner = Current_Thread;
+    OSAux_HoldMutex(Current_Thread, semaPt);
+  }
+  else{
+    blockActiveThread(semaPt);
+    OSAux_InheritPriority(semaPt, Current_Thread->priority);
+  }
+}
+
 /******** OS_Transfer_SVC_C ************
  Transfers the currently active TCB to the specified linked list
  Inputs : LL_Pt - a pointer to the linked list
@@ -54,6 +110,11 @@ void removeActiveThread(void){
 void OS_Transfer_SVC_C(TCB_t** LL_Pt){
   removeActiveThread();
   
+  // Killed, context is already packed so the stack can go back to the pool.
+  if(LL_Pt == &InactiveThreads){
+    OSAux_FreeStack(Current_Thread);
+  }
+  
   CS_Ignore = 1;
   
   if(*LL_Pt != 0){
@@ -75,7 +136,11 @@ void OS_Transfer_SVC_C(TCB_t** LL_Pt){
  Outputs: None
 */
 void OS_Sleep_SVC_C(uint32_t sleepSlices){
-  uint32_t wakeSlice = Systick_Calls + sleepSlices;
+  uint32_t wakeSlice;
+  
+  // Bring Systick_Calls up to date if SysTick is skipping ticks.
+  OSAux_TicklessEnd();
+  wakeSlice = Systick_Calls + sleepSlices;
   
   removeActiveThread();
   Current_Thread->sleepUntil = wakeSlice;
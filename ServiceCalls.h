@@ -28,12 +28,29 @@ void OS_Transfer_SVC_C(TCB_t** LL_Pt);
 void OS_Sleep_SVC_C(uint32_t sleepSlices);
 
 /**************OS_Wait_SVC_C***************
- Implements counting and binary semaphore blocking
-		If semaphore > 0, decrement and return
-		If semaphore == 0, block the calling thread
+ Implements counting semaphore blocking
+		Decrement semaphore, block the calling thread if it is now negative
  Inputs : semaPt - pointer to the semaphore to check
  Outputs: None
 */
-void OS_xWait_SVC_C(Sema4Type *semaPt);
+void OS_Wait_SVC_C(Sema4Type *semaPt);
+
+/**************OS_bWait_SVC_C***************
+ Implements binary semaphore blocking
+		If semaphore is 1, clear and return
+		If semaphore is 0, block the calling thread
+ Inputs : semaPt - pointer to the semaphore to check
+ Outputs: None
+*/
+void OS_bWait_SVC_C(Sema4Type *semaPt);
+
+/**************OS_MutexLock_SVC_C***************
+ Implements mutex blocking with priority inheritance
+		If mutex is free, take ownership and return
+		Otherwise, block the calling thread and raise the owner's priority
+ Inputs : semaPt - pointer to the mutex
+ Outputs: None
+*/
+void OS_MutexLock_SVC_C(Sema4Type *semaPt);
 
 #endif
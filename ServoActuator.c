@@ -7,7 +7,7 @@
  
 #include "ServoActuator.h"
 #include "Simulator.h"
-#include "ADC.h"
+#include "ActuatorTrace.h"
 
 // Calibration constants for actuator pins directly into test controller w/
 // hw actuators running in parallel. SERVO_MAX_DUTY and SERVO_MIN_DUTY require
@@ -29,7 +29,7 @@ static uint16_t getDirectionFromDutyVal(uint16_t duty_val);
  * Initializes ADC channel for reading servo duty to determine car direction.
  */
 void ServoActuator_Init(void) {
-  ADC_Open(SERVO_ADC_CHANNEL);
+  ActuatorTrace_Open(SERVO_ADC_CHANNEL);
 }
 
 /**
@@ -48,7 +48,7 @@ uint16_t ServoActuator_GetDirection(void) {
  * Gets duty of servo using ADC. Returns 0 - 1000 (res of .1%).
  */
 static uint16_t getDuty(void) {
-  uint16_t adc_val = ADC_In(SERVO_ADC_CHANNEL);
+  uint16_t adc_val = ActuatorTrace_In(SERVO_ADC_CHANNEL);
   
   return adc_val * 1000 / 4096;
 }
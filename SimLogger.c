@@ -1,7 +1,7 @@
 /**  
  * File: SimLogger.h
  * Author: Sarah Masimore
- * Last Updated Date: 03/14/2018
+ * Last Updated Date: 10/18/2026
  * Description: Log for logging each sim event. Prints results to UART.
  */
  
@@ -9,9 +9,8 @@
 #include "SimLogger.h"
 #include "Simulator.h"
 #include "terminal.h"
-
-uint32_t StartCritical(void); 
-void EndCritical(uint32_t oldState);
+#include "LineBuilder.h"
+#include "OS.h"
 
 struct row {
   uint32_t numTicks;
@@ -31,16 +30,31 @@ struct row {
 struct row SimLog[MAX_NUM_TICKS];
 uint16_t NextRow = 0;
 
+#define MAX_SPLITS 32
+static struct race_split Splits[MAX_SPLITS];
+static uint16_t NumSplits = 0;
+
+// Protects SimLog, NextRow, Splits and NumSplits. A mutex rather than a critical section so
+// interrupts stay enabled while rows are copied.
+Sema4Type SimLogMutex;
+
+/**
+ * Init SimLogger's mutex.
+ */
+void SimLogger_Init(void) {
+  OS_InitSemaphore(&SimLogMutex, 1);
+}
+
 /**
  * Log a row to the SimLogger.
  */
 void SimLogger_LogRow(struct car * car, uint32_t numTicks) {
   struct row row;
   
-  uint32_t oldIntrState = StartCritical();
+  OS_MutexLock(&SimLogMutex);
 
   if (NextRow == MAX_NUM_TICKS) {
-    EndCritical(oldIntrState);
+    OS_MutexUnlock(&SimLogMutex);
     return;
   }
   
@@ -59,11 +73,37 @@ void SimLogger_LogRow(struct car * car, uint32_t numTicks) {
   
   SimLog[NextRow++] = row;
   
-  EndCritical(oldIntrState);
+  OS_MutexUnlock(&SimLogMutex);
+}
+
+/**
+ * Log a gate crossing.
+ */
+void SimLogger_LogSplit(const struct race_split * split) {
+  OS_MutexLock(&SimLogMutex);
+  if (NumSplits < MAX_SPLITS) {
+    Splits[NumSplits++] = *split;
+  }
+  OS_MutexUnlock(&SimLogMutex);
 }
 
+// Used by SimLogger_PrintToTerminal, static to keep it off the caller's stack.
+static struct line_builder RowLine;
+
 /**
- * Print log to UART.
+ * Append a sensor value to a row, MAX if out of range.
+ */
+static void appendSensor(struct line_builder *line, uint32_t val) {
+  LineBuilder_AppendString(line, ",");
+  if (val > 1500) {
+    LineBuilder_AppendString(line, "MAX");
+  } else {
+    LineBuilder_AppendUDec(line, val);
+  }
+}
+
+/**
+ * Print log to UART. Each row is built in RowLine and output at once.
  */
 void SimLogger_PrintToTerminal(void) {
   struct row row;
@@ -74,62 +114,49 @@ void SimLogger_PrintToTerminal(void) {
   
   for (i = 0; i < NextRow; i++) {
     row = SimLog[i];
-    terminal_printValueDec(row.numTicks);
-    terminal_printString(",");
-    terminal_printValueDec(row.carX);
-    terminal_printString(",");
-    terminal_printValueDec(row.carY);
-    terminal_printString(",");
-    if (row.carV < 0) {
-      terminal_printString("-");
-      terminal_printValueDec(row.carV * -1);
-    } else {
-      terminal_printValueDec(row.carV);
-    }
-    terminal_printString(",");
-    terminal_printValueDec(row.carDir);
-    terminal_printString(",");
-    if (row.sensor0 > 1500) {
-      terminal_printString("MAX");
-    } else {
-      terminal_printValueDec(row.sensor0);
-    }
-    terminal_printString(",");
-    if (row.sensor1 > 1500) {
-      terminal_printString("MAX");
-    } else {
-      terminal_printValueDec(row.sensor1);
-    }
-    terminal_printString(",");
-    if (row.sensor2 > 1500) {
-      terminal_printString("MAX");
-    } else {
-      terminal_printValueDec(row.sensor2);
-    }
-    terminal_printString(",");
-    if (row.sensor3 > 1500) {
-      terminal_printString("MAX");
-    } else {
-      terminal_printValueDec(row.sensor3);
-    }
-    terminal_printString(",");
-    if (row.sensor4 > 1500) {
-      terminal_printString("MAX");
-    } else {
-      terminal_printValueDec(row.sensor4);
-    }
-    terminal_printString(",");
-    if (row.sensor5 > 1500) {
-      terminal_printString("MAX");
-    } else {
-      terminal_printValueDec(row.sensor5);
-    }
-    terminal_printString(",");
-    if (row.sensor6 > 1500) {
-      terminal_printString("MAX");
-    } else {
-      terminal_printValueDec(row.sensor6);
-    }
-    terminal_printString("\r\n");
+    LineBuilder_Clear(&RowLine);
+    LineBuilder_AppendUDec(&RowLine, row.numTicks);
+    LineBuilder_AppendString(&RowLine, ",");
+    LineBuilder_AppendUDec(&RowLine, row.carX);
+    LineBuilder_AppendString(&RowLine, ",");
+    LineBuilder_AppendUDec(&RowLine, row.carY);
+    LineBuilder_AppendString(&RowLine, ",");
+    LineBuilder_AppendDec(&RowLine, row.carV);
+    LineBuilder_AppendString(&RowLine, ",");
+    LineBuilder_AppendUDec(&RowLine, row.carDir);
+    appendSensor(&RowLine, row.sensor0);
+    appendSensor(&RowLine, row.sensor1);
+    appendSensor(&RowLine, row.sensor2);
+    appendSensor(&RowLine, row.sensor3);
+    appendSensor(&RowLine, row.sensor4);
+    appendSensor(&RowLine, row.sensor5);
+    appendSensor(&RowLine, row.sensor6);
+    LineBuilder_AppendString(&RowLine, "\r\n");
+    terminal_printLine(&RowLine);
+  }
+  
+  if (NumSplits == 0) {
+    return;
+  }
+  terminal_printString("\r\n----- Race Splits ----- \r\n");
+  terminal_printString("event,lap,gate,time us,lap us,sector us\r\n");
+  for (i = 0; i < NumSplits; i++) {
+    LineBuilder_Clear(&RowLine);
+    LineBuilder_AppendString(&RowLine, 
+      Splits[i].event == RACE_WRONG_WAY ? "WRONG WAY" :
+      Splits[i].event == RACE_SECTOR ? "SECTOR" :
+      Splits[i].event == RACE_LAP ? "LAP" : "FINISH");
+    LineBuilder_AppendString(&RowLine, ",");
+    LineBuilder_AppendUDec(&RowLine, Splits[i].lap);
+    LineBuilder_AppendString(&RowLine, ",");
+    LineBuilder_AppendUDec(&RowLine, Splits[i].gate);
+    LineBuilder_AppendString(&RowLine, ",");
+    LineBuilder_AppendUDec(&RowLine, Splits[i].time);
+    LineBuilder_AppendString(&RowLine, ",");
+    LineBuilder_AppendUDec(&RowLine, Splits[i].lapTime);
+    LineBuilder_AppendString(&RowLine, ",");
+    LineBuilder_AppendUDec(&RowLine, Splits[i].sectorTime);
+    LineBuilder_AppendString(&RowLine, "\r\n");
+    terminal_printLine(&RowLine);
   }
 }
@@ -1,18 +1,29 @@
 /**	
  * File: SimLogger.h
  * Author: Sarah Masimore
- * Last Updated Date: 03/14/2018
+ * Last Updated Date: 10/18/2026
  * Description: Log for logging each sim event. Prints results to UART.
  */
 
 #include <stdint.h>
 #include "Simulator.h"
+#include "Race.h"
+
+/**
+ * Init SimLogger's mutex. Must be called before OS_Launch.
+ */
+void SimLogger_Init(void);
 
 /**
  * Log a row to the SimLogger.
  */
 void SimLogger_LogRow(struct car * car, uint32_t numTicks);
 
+/**
+ * Log a gate crossing. Splits are printed after the rows.
+ */
+void SimLogger_LogSplit(const struct race_split * split);
+
 /**
  * Print log to UART.
  */
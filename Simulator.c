@@ -9,12 +9,43 @@
 #include "Simulator.h"
 #include "TrigLookup.h"
 #include "isqrt.h"
+#include "TrackSDF.h"
+#include "PoseTable.h"
+
+// Uncomment to check cached sensor results against a full scan of every wall.
+//#define VERIFY_SENSOR_CACHE
+
+#ifdef VERIFY_SENSOR_CACHE
+#include "terminal.h"
+#endif
+
+// Raycasting stats, used to measure effect of sensor hit caching.
+SIM_STAT uint32_t NumRaysCast = 0;
+SIM_STAT uint32_t NumWallTests = 0;
 
 uint8_t getSegmentIntersection(int32_t p0_x, int32_t p0_y, int32_t p1_x, 
                                int32_t p1_y, int32_t p2_x, int32_t p2_y, 
                                int32_t p3_x, int32_t p3_y, int32_t *i_x, 
                                int32_t *i_y);
 int32_t getDistanceBetweenPoints(int32_t x0, int32_t y0, int32_t x1, int32_t y1);
+static void moveAlongArc(struct car * car, int64_t dist, int64_t turn);
+static uint32_t roundFinePos(int32_t fine);
+static uint32_t roundFineDir(uint32_t fine);
+static uint32_t wrapFineDir(int64_t fine);
+static int32_t sinFine(uint32_t dir);
+static int32_t cosFine(uint32_t dir);
+static uint8_t sensorCacheUsable(struct car * car);
+static uint8_t rayCrossesDirty(struct car * car, struct sensor * sensor, 
+                               uint16_t absDir, struct environment * env);
+static uint8_t wallCanBeCloser(struct car * car, struct wall * wall, 
+                               uint32_t minDistance);
+static uint8_t getSensorDistanceToWall(struct car * car, int32_t endX, 
+                                       int32_t endY, struct wall * wall, 
+                                       uint32_t * distance);
+#ifdef VERIFY_SENSOR_CACHE
+static uint32_t getFullScanDistance(struct car * car, struct environment * env,
+                                    int32_t endX, int32_t endY);
+#endif
 
 /**
  * Based on velocity, direction, and sim_freq update car's position.
@@ -22,9 +53,16 @@ int32_t getDistanceBetweenPoints(int32_t x0, int32_t y0, int32_t x1, int32_t y1)
  * Simulator_HitWall.
  */
 void Simulator_MoveCar(struct car * car, uint32_t timePassedMs) {
+#if defined(DIFF_DRIVE)
+  Simulator_MoveCarDiff(car, timePassedMs);
+}
+#elif defined(BICYCLE_MODEL)
+  Simulator_MoveCarArc(car, timePassedMs);
+}
+#else
   uint8_t fwd = car->vel > 0;
   uint32_t vel = fwd ? car->vel : car->vel * -1;
-  uint32_t dir = fwd ? car->dir : (car->dir > 180 ? car->dir - 180 : car->dir + 180);
+  uint32_t dir = fwd ? car->dir : (car->dir >= 180 ? car->dir - 180 : car->dir + 180);
   uint32_t x = car->x;
   uint32_t y = car->y;
   int32_t hyp = vel * timePassedMs / 1000; // get distance traveled (hypoteneuse)
@@ -44,19 +82,173 @@ void Simulator_MoveCar(struct car * car, uint32_t timePassedMs) {
     car->y = car->y + deltaY;
   }
 }
+#endif
+
+/**
+ * Bicycle model. Heading changes at rate vel * tan(steer) / WHEELBASE_MM,
+ * so over the step the car turns by dist * tan(steer) / wheelbase.
+ */
+void Simulator_MoveCarArc(struct car * car, uint32_t timePassedMs) {
+  int32_t steer = car->steer;
+  int32_t tanSteer; // TRIG_SCALE
+  int64_t dist, turn;
+  
+  if (steer > MAX_STEER_DEG) {
+    steer = MAX_STEER_DEG;
+  } else if (steer < -MAX_STEER_DEG) {
+    steer = -MAX_STEER_DEG;
+  }
+  tanSteer = SinLookup[steer < 0 ? -steer : steer] * TRIG_SCALE / 
+             CosLookup[steer < 0 ? -steer : steer];
+  tanSteer = steer < 0 ? -tanSteer : tanSteer;
+  
+  // Distance along the arc, fine mm, negative if going backwards.
+  dist = (int64_t)car->vel * timePassedMs * (1 << POSE_FRAC_BITS);
+  dist = (dist + (dist < 0 ? -500 : 500)) / 1000;
+  
+  // Turn, Q24 radians: dist * tan / wheelbase.
+  turn = dist * tanSteer * (1 << (24 - POSE_FRAC_BITS)) / 
+         ((int64_t)TRIG_SCALE * WHEELBASE_MM);
+  
+  moveAlongArc(car, dist, turn);
+}
+
+/**
+ * Differential drive. The center moves at the mean wheel velocity and the 
+ * car turns by the difference over TRACK_WIDTH_MM.
+ */
+void Simulator_MoveCarDiff(struct car * car, uint32_t timePassedMs) {
+  int64_t dist, turn;
+  
+  // Distance along the arc, fine mm: (left + right) / 2 * ms / 1000.
+  dist = ((int64_t)car->velLeft + car->velRight) * timePassedMs * 
+         (1 << POSE_FRAC_BITS);
+  dist = (dist + (dist < 0 ? -1000 : 1000)) / 2000;
+  
+  // Turn, Q24 radians: (right - left) * ms / 1000 / track width.
+  turn = ((int64_t)car->velRight - car->velLeft) * timePassedMs * (1 << 24);
+  turn /= 1000 * TRACK_WIDTH_MM;
+  
+  moveAlongArc(car, dist, turn);
+}
+
+/**
+ * Moves car dist along an arc turning it by turn. The arc's chord has 
+ * length dist * sin(turn/2) / (turn/2) and points along the heading halfway
+ * through the turn, which covers straight moves (turn = 0) without dividing
+ * by the radius. sin(x)/x is a short series, good to 1e-7 for turns up to 
+ * 180 degrees a step.
+ *
+ * dist is in fine mm, negative if going backwards, and turn is Q24 radians,
+ * positive to the left. Pose is kept in 1/4096 mm and 1/2^20 degree, and 
+ * sin and cos are interpolated between lookup entries. Callers round dist,
+ * not truncate it, so 1 ms steps don't drift.
+ */
+static void moveAlongArc(struct car * car, int64_t dist, int64_t turn) {
+  int64_t halfSq, sinc, chord, turnDir;
+  uint32_t midDir;
+  
+  // Restart the fine pose if x, y, or dir were changed by anything else.
+  if (car->x != roundFinePos(car->fineX) || car->y != roundFinePos(car->fineY) ||
+      car->dir != roundFineDir(car->fineDir)) {
+    car->fineX = car->x << POSE_FRAC_BITS;
+    car->fineY = car->y << POSE_FRAC_BITS;
+    car->fineDir = car->dir << DIR_FRAC_BITS;
+  }
+  
+  // sin(h) / h for h = turn / 2: 1 - x/6 (1 - x/20 (1 - x/42 (1 - x/72))), 
+  // x = h^2.
+  halfSq = (turn / 2) * (turn / 2) >> 24;
+  sinc = (1 << 24) - halfSq / 72;
+  sinc = (1 << 24) - (halfSq * sinc >> 24) / 42;
+  sinc = (1 << 24) - (halfSq * sinc >> 24) / 20;
+  sinc = (1 << 24) - (halfSq * sinc >> 24) / 6;
+  chord = dist * sinc >> 24;
+  
+  // Q24 radians to fine degrees: * 180 / pi * 2^DIR_FRAC_BITS / 2^24, where
+  // 3754936 is 180 / pi * 2^16.
+  turnDir = (turn * 3754936 + (1LL << (39 - DIR_FRAC_BITS))) >> 
+            (40 - DIR_FRAC_BITS);
+  midDir = wrapFineDir((int64_t)car->fineDir + turnDir / 2);
+  
+  car->fineX += chord * cosFine(midDir) / TRIG_SCALE;
+  car->fineY += chord * sinFine(midDir) / TRIG_SCALE;
+  car->fineDir = wrapFineDir((int64_t)car->fineDir + turnDir);
+  
+  car->x = roundFinePos(car->fineX);
+  car->y = roundFinePos(car->fineY);
+  car->dir = roundFineDir(car->fineDir);
+}
+
+/**
+ * Fine position to mm. Negative positions clamp to 0, like 
+ * Simulator_MoveCar's straight moves.
+ */
+static uint32_t roundFinePos(int32_t fine) {
+  return fine < 0 ? 0 : (fine + (1 << (POSE_FRAC_BITS - 1))) >> POSE_FRAC_BITS;
+}
+
+/**
+ * Fine direction to whole degrees, 0 - 359.
+ */
+static uint32_t roundFineDir(uint32_t fine) {
+  uint32_t dir = (fine + (1 << (DIR_FRAC_BITS - 1))) >> DIR_FRAC_BITS;
+  return dir >= 360 ? dir - 360 : dir;
+}
+
+/**
+ * Any fine direction to 0 - 360 degrees.
+ */
+static uint32_t wrapFineDir(int64_t fine) {
+  int64_t full = (int64_t)360 << DIR_FRAC_BITS;
+  fine %= full;
+  return fine < 0 ? fine + full : fine;
+}
+
+/**
+ * Sin of a fine direction, TRIG_SCALE, linear between whole degrees.
+ * Within 1e-4 of exact, about the table's own rounding.
+ */
+static int32_t sinFine(uint32_t dir) {
+  uint32_t deg = dir >> DIR_FRAC_BITS;
+  int32_t frac = dir & ((1 << DIR_FRAC_BITS) - 1);
+  int32_t a = SinLookup[deg];
+  int32_t b = SinLookup[deg == 359 ? 0 : deg + 1];
+  return a + ((b - a) * frac >> DIR_FRAC_BITS);
+}
+
+static int32_t cosFine(uint32_t dir) {
+  uint32_t deg = dir >> DIR_FRAC_BITS;
+  int32_t frac = dir & ((1 << DIR_FRAC_BITS) - 1);
+  int32_t a = CosLookup[deg];
+  int32_t b = CosLookup[deg == 359 ? 0 : deg + 1];
+  return a + ((b - a) * frac >> DIR_FRAC_BITS);
+}
 
 /**
  * Based on previous and next location, determine if hit wall.
+ *
+ * With a distance field, a move can only cross a wall if some wall is within
+ * half the move's length of its midpoint, so usually one lookup is enough.
+ * Walls are only scanned when the field can't rule that out.
  */
 uint8_t Simulator_HitWall(struct environment * env, uint32_t prevX, 
                           uint32_t prevY, uint32_t nextX, uint32_t nextY) {
   int j;
   struct wall * wall;
+  int32_t intrsX, intrsY; // unused, getSegmentIntersection always stores
   
   // Hit boundary of environment.
   if (nextX == 0 || nextY == 0) {
     return 1;
   }
+  
+  // +2 covers rounding of the midpoint and the length.
+  if (env->sdf && TrackSDF_IsClear(env->sdf, (prevX + nextX) / 2, 
+      (prevY + nextY) / 2, 
+      getDistanceBetweenPoints(prevX, prevY, nextX, nextY) / 2 + 2)) {
+    return 0;
+  }
                             
   for (j = 0; j < env->numWalls; j++) {
     wall = &env->walls[j];
@@ -64,7 +256,7 @@ uint8_t Simulator_HitWall(struct environment * env, uint32_t prevX,
     // If segments intersect, calculate distance and maybe update minDistance.
     if (getSegmentIntersection(prevX, prevY, nextX, nextY, wall->startX, 
                                wall->startY, wall->endX, wall->endY, 
-                               0, 0)) {
+                               &intrsX, &intrsY)) {
       return 1;
     }
   }
@@ -79,18 +271,36 @@ uint8_t Simulator_HitWall(struct environment * env, uint32_t prevX,
  *
  * To determine if sensor line of sight intersects with a wall, loops through
  * each wall per sensor. Assumes max line of sight of MAX_SENSOR_LINE_OF_SIGHT.
+ *
+ * Most ticks a sensor hits the same wall it hit last tick, so that wall is
+ * tested first. Any wall whose bounding box is at least as far from the car
+ * as the current closest hit can't lower the min distance and is skipped, so
+ * results match a full scan exactly. If the car hasn't moved or turned, 
+ * only rays crossing a dirty region (walls that moved this tick) are cast
+ * again. 0 is returned if there were none.
+ *
+ * With POSE_TABLE, rays the environment's pose table covers are looked up
+ * instead of cast. Walls added after the table was opened are still tested.
  */
-void Simulator_UpdateSensors(struct car * car, struct environment * env) {
+uint8_t Simulator_UpdateSensors(struct car * car, struct environment * env) {
   // Loop through sensors. Based on their type and distance from nearest
   // wall in its path, update value in struct sensor.
-  uint8_t i, j;
+  uint8_t i;
+  uint16_t j;
   struct sensor * sensor;
   uint16_t absDir;
-  int32_t endX, endY, intrsX, intrsY;
-  struct wall * wall;
+  int32_t endX, endY;
   uint32_t distance;
   uint32_t minDistance;
-  uint8_t wallInSight;
+  uint16_t hitWall, testedWall;
+  uint8_t useCache = sensorCacheUsable(car);
+  uint8_t moved = !useCache || car->x != car->sensorX || 
+                  car->y != car->sensorY || car->dir != car->sensorDir;
+  uint8_t updated = 0;
+  
+  if (!moved && env->numDirty == 0) {
+    return 0;
+  }
   
   for (i = 0; i < car->numSensors; i++) {
     sensor = &car->sensors[i];
@@ -99,35 +309,228 @@ void Simulator_UpdateSensors(struct car * car, struct environment * env) {
       absDir -= 360;
     }
     
+    if (!moved && !rayCrossesDirty(car, sensor, absDir, env)) {
+      continue;
+    }
+    updated = 1;
+    
     // This can result in negative values, but this is ok since any negative
     // points on the line of sight will not intersect with walls.
     endY = car->y + SinLookup[absDir]*MAX_SENSOR_LINE_OF_SIGHT/TRIG_SCALE;
     endX = car->x + CosLookup[absDir]*MAX_SENSOR_LINE_OF_SIGHT/TRIG_SCALE;
+    
+#ifdef POSE_TABLE
+    // Keep hitWall as is, it's still a good candidate if the ray is cast.
+    if (env->poseTable && PoseTable_Lookup(env->poseTable, car->x, car->y, 
+                                           absDir, &sensor->val)) {
+      for (j = env->poseTable->numWalls; j < env->numWalls; j++) {
+        if (getSensorDistanceToWall(car, endX, endY, &env->walls[j], 
+                                    &distance) && distance < sensor->val) {
+          sensor->val = distance;
+        }
+      }
+      continue;
+    }
+#endif
 
     // Set minDistance to max int32
     minDistance = MAX_U32INT;
-    wallInSight = 0;
+    hitWall = SENSOR_NO_WALL;
+    testedWall = SENSOR_NO_WALL;
+    NumRaysCast++;
+    
+    // Test last hit wall first so most other walls can be skipped.
+    if (useCache && sensor->hitWall < env->numWalls) {
+      testedWall = sensor->hitWall;
+      if (getSensorDistanceToWall(car, endX, endY, &env->walls[testedWall], 
+                                  &distance)) {
+        minDistance = distance;
+        hitWall = testedWall;
+      }
+    }
+    
     for (j = 0; j < env->numWalls; j++) {
-      wall = &env->walls[j];
+      if (j == testedWall || (hitWall != SENSOR_NO_WALL && 
+          !wallCanBeCloser(car, &env->walls[j], minDistance))) {
+        continue;
+      }
       
       // If segments intersect, calculate distance and maybe update minDistance.
-      if (getSegmentIntersection(car->x, car->y, endX, endY, wall->startX, 
-                                 wall->startY, wall->endX, wall->endY, 
-                                 &intrsX, &intrsY)) {
-        distance =  getDistanceBetweenPoints(car->x, car->y, intrsX, intrsY);
-        if (distance < minDistance) {
-          minDistance = distance;
-        }
-        wallInSight = 1;
+      if (getSensorDistanceToWall(car, endX, endY, &env->walls[j], 
+                                  &distance) && distance < minDistance) {
+        minDistance = distance;
+        hitWall = j;
       }
     }
     
-    if (wallInSight) {
-      sensor->val = minDistance;
-    } else {
-      sensor->val = MAX_U32INT;
+#ifdef VERIFY_SENSOR_CACHE
+    if (minDistance != getFullScanDistance(car, env, endX, endY)) {
+      terminal_printString("Error: Sensor cache mismatch\r\n");
+    }
+#endif
+    
+    // minDistance is still MAX_U32INT if no wall in sight.
+    sensor->val = minDistance;
+    sensor->hitWall = hitWall;
+  }
+  
+  car->sensorX = car->x;
+  car->sensorY = car->y;
+  car->sensorDir = car->dir;
+  car->sensorCacheValid = 1;
+  return updated;
+}
+
+/**
+ * Returns 1 if the sensor's ray, from the car up to the wall it hit last
+ * update, passes through a dirty region. Only those rays can see a different
+ * closest wall: one appeared in front of the hit, or the hit wall itself 
+ * moved. Tested with the ray's bounding box, so a few rays that didn't need
+ * it may be cast again.
+ */
+static uint8_t rayCrossesDirty(struct car * car, struct sensor * sensor, 
+                               uint16_t absDir, struct environment * env) {
+  uint32_t length = sensor->val < MAX_SENSOR_LINE_OF_SIGHT ? sensor->val : 
+                                                             MAX_SENSOR_LINE_OF_SIGHT;
+  int32_t endX = car->x + CosLookup[absDir]*(int32_t)length/TRIG_SCALE;
+  int32_t endY = car->y + SinLookup[absDir]*(int32_t)length/TRIG_SCALE;
+  int32_t minX = (endX < (int32_t)car->x ? endX : car->x) - SENSOR_DIRTY_PAD_MM;
+  int32_t maxX = (endX < (int32_t)car->x ? car->x : endX) + SENSOR_DIRTY_PAD_MM;
+  int32_t minY = (endY < (int32_t)car->y ? endY : car->y) - SENSOR_DIRTY_PAD_MM;
+  int32_t maxY = (endY < (int32_t)car->y ? car->y : endY) + SENSOR_DIRTY_PAD_MM;
+  const struct dirty_region * region;
+  uint8_t k;
+  
+  for (k = 0; k < env->numDirty; k++) {
+    region = &env->dirty[k];
+    if ((int32_t)region->minX <= maxX && (int32_t)region->maxX >= minX && 
+        (int32_t)region->minY <= maxY && (int32_t)region->maxY >= minY) {
+      return 1;
+    }
+  }
+  
+  return 0;
+}
+
+/**
+ * Returns 1 if the car's pose is close enough to the pose sensors were last
+ * updated at for each sensor's last hit wall to be a useful first candidate.
+ * Conservative: any large jump (e.g. car reset) drops the cache.
+ */
+static uint8_t sensorCacheUsable(struct car * car) {
+  uint32_t moveX, moveY, turn;
+  
+  if (!car->sensorCacheValid) {
+    return 0;
+  }
+  
+  moveX = car->x > car->sensorX ? car->x - car->sensorX : car->sensorX - car->x;
+  moveY = car->y > car->sensorY ? car->y - car->sensorY : car->sensorY - car->y;
+  turn = car->dir > car->sensorDir ? car->dir - car->sensorDir : 
+                                     car->sensorDir - car->dir;
+  if (turn > 180) {
+    turn = 360 - turn;
+  }
+  
+  return moveX <= SENSOR_CACHE_MAX_MOVE_MM && 
+         moveY <= SENSOR_CACHE_MAX_MOVE_MM && 
+         turn <= SENSOR_CACHE_MAX_TURN_DEG;
+}
+
+/**
+ * Returns 1 if any point on the wall could be less than minDistance from the
+ * car. Intersections always lie within the wall's bounding box and isqrt is
+ * monotonic, so a box at least minDistance away can never produce a smaller
+ * distance.
+ */
+static uint8_t wallCanBeCloser(struct car * car, struct wall * wall, 
+                               uint32_t minDistance) {
+  uint32_t minX = wall->startX < wall->endX ? wall->startX : wall->endX;
+  uint32_t maxX = wall->startX < wall->endX ? wall->endX : wall->startX;
+  uint32_t minY = wall->startY < wall->endY ? wall->startY : wall->endY;
+  uint32_t maxY = wall->startY < wall->endY ? wall->endY : wall->startY;
+  uint32_t dx = 0;
+  uint32_t dy = 0;
+  
+  if (car->x < minX) {
+    dx = minX - car->x;
+  } else if (car->x > maxX) {
+    dx = car->x - maxX;
+  }
+  
+  if (car->y < minY) {
+    dy = minY - car->y;
+  } else if (car->y > maxY) {
+    dy = car->y - maxY;
+  }
+  
+  // Checked separately first so the squares below can't overflow.
+  if (dx >= minDistance || dy >= minDistance) {
+    return 0;
+  }
+  
+  if (minDistance > 0xFFFF) {
+    return 1;
+  }
+  
+  return dx * dx + dy * dy < minDistance * minDistance;
+}
+
+/**
+ * Returns 1 and stores distance from car to wall if sensor line of sight
+ * from car to (endX, endY) intersects wall.
+ */
+static uint8_t getSensorDistanceToWall(struct car * car, int32_t endX, 
+                                       int32_t endY, struct wall * wall, 
+                                       uint32_t * distance) {
+  int32_t intrsX, intrsY;
+  
+  NumWallTests++;
+  if (getSegmentIntersection(car->x, car->y, endX, endY, wall->startX, 
+                             wall->startY, wall->endX, wall->endY, 
+                             &intrsX, &intrsY)) {
+    *distance = getDistanceBetweenPoints(car->x, car->y, intrsX, intrsY);
+    return 1;
+  }
+  
+  return 0;
+}
+
+#ifdef VERIFY_SENSOR_CACHE
+/**
+ * Original full scan over every wall, used to check cached results.
+ */
+static uint32_t getFullScanDistance(struct car * car, struct environment * env,
+                                    int32_t endX, int32_t endY) {
+  uint16_t j;
+  int32_t intrsX, intrsY;
+  uint32_t distance;
+  uint32_t minDistance = MAX_U32INT;
+  struct wall * wall;
+  
+  for (j = 0; j < env->numWalls; j++) {
+    wall = &env->walls[j];
+    if (getSegmentIntersection(car->x, car->y, endX, endY, wall->startX, 
+                               wall->startY, wall->endX, wall->endY, 
+                               &intrsX, &intrsY)) {
+      distance = getDistanceBetweenPoints(car->x, car->y, intrsX, intrsY);
+      if (distance < minDistance) {
+        minDistance = distance;
+      }
     }
   }
+  
+  return minDistance;
+}
+#endif
+
+/**
+ * Signed divide with Cortex-M4 SDIV semantics: dividing by zero gives 0 
+ * rather than trapping, so vertical and horizontal sensors behave the same 
+ * on host as on target.
+ */
+static int32_t sdiv(int32_t n, int32_t d) {
+  return d == 0 ? 0 : n / d;
 }
 
 /**
@@ -145,7 +548,7 @@ uint8_t getSegmentIntersection(int32_t s0_x, int32_t s0_y, int32_t s1_x,
   int32_t x_intrs, y_intrs;
   
   // Scaled up 1000x for fixed point math
-  int32_t sensorSlope = (s1_y - s0_y) * 1000 / (s1_x - s0_x);
+  int32_t sensorSlope = sdiv((s1_y - s0_y) * 1000, s1_x - s0_x);
   int32_t sensorYIntersect = s0_y - sensorSlope * s0_x / 1000;
   uint8_t isVerticalSensor = (s1_x - s0_x) == 0;
   
@@ -163,7 +566,7 @@ uint8_t getSegmentIntersection(int32_t s0_x, int32_t s0_y, int32_t s1_x,
       }
       
       // Get sensor's x when at w0_y
-      x_intrs = (w0_y - sensorYIntersect) * 1000 / sensorSlope;
+      x_intrs = sdiv((w0_y - sensorYIntersect) * 1000, sensorSlope);
       
       // Check if x in wall
       if ((x_intrs >= w0_x && x_intrs <= w1_x) || 
@@ -21,10 +21,46 @@
 #define MIN_32INT 1 << 31
 #define MAX_32INT ~(1 << 31)
 
+// Sensor hit caching. If the car moves or turns more than this between
+// updates, each sensor's previously hit wall is no longer used as a candidate.
+#define SENSOR_NO_WALL 0xFFFF
+#define SENSOR_CACHE_MAX_MOVE_MM 500
+#define SENSOR_CACHE_MAX_TURN_DEG 45
+// Rays are checked against dirty regions up to their last hit, padded for 
+// rounding of the hit distance.
+#define SENSOR_DIRTY_PAD_MM 8
+
+// Uncomment to move the car along the circular arc its front wheel angle
+// and wheelbase give (bicycle model), instead of turning by the servo angle
+// each tick and then moving straight.
+//#define BICYCLE_MODEL
+#define WHEELBASE_MM 260 // 1/10 scale racecar
+#define MAX_STEER_DEG 45
+
+// Uncomment to steer by left and right wheel velocities (differential 
+// drive) instead of the servo. Also moves the car along exact arcs.
+//#define DIFF_DRIVE
+#define TRACK_WIDTH_MM 170 // between wheel centers
+#define POSE_FRAC_BITS 12 // fine x, y are mm / 2^12
+#define DIR_FRAC_BITS 20 // fine dir is degrees / 2^20
+
+#define LIVE_DATA_SENSORS 7 // Keep this in sync with HILMain NUM_SENSORS
+
+// Raycasting stats are per thread on host, where several threads may 
+// simulate at once (tools/Sweep, PoseTable_Build).
+#if defined(HOST_BUILD) || defined(SIM_THREADED)
+#define SIM_STAT _Thread_local
+#else
+#define SIM_STAT
+#endif
+
 
 
 // STRUCTS
 
+struct track_sdf; // TrackSDF.h
+struct pose_table; // PoseTable.h
+
 
 /**
  * Sensor type used to map environment values (e.g. 10 mm away from wall) to
@@ -40,6 +76,7 @@ struct sensor {
   uint32_t dir; // direction in angles, 0 - 360
 	uint32_t val; // distance from nearest wall in path of sensor
 	uint8_t channel; // hardware channel output is on, set by Sensors_Init
+	uint16_t hitWall; // index of wall hit on last update, SENSOR_NO_WALL if none
 };
 
 /**
@@ -59,6 +96,28 @@ struct car {
 	// Sensors and actuators.
 	uint8_t numSensors;
 	struct sensor * sensors;
+	
+	// Pose sensors were last updated at. Used to decide whether each sensor's
+	// last hit wall is still a good first candidate. Zero until first update.
+	uint32_t sensorX;
+	uint32_t sensorY;
+	uint32_t sensorDir;
+	uint8_t sensorCacheValid;
+	
+	// Bicycle model. Front wheel angle in degrees, positive to the left.
+	int16_t steer;
+	
+	// Differential drive. Wheel velocities in mm/s, vel is their mean.
+	int32_t velLeft;
+	int32_t velRight;
+	
+	// Pose kept in finer units by Simulator_MoveCarArc and 
+	// Simulator_MoveCarDiff so small moves add up.
+	// x, y, and dir are these rounded. If anything else changes x, y, or dir
+	// the fine pose restarts from them.
+	int32_t fineX; // mm / 2^POSE_FRAC_BITS
+	int32_t fineY;
+	uint32_t fineDir; // degrees / 2^DIR_FRAC_BITS
 };
 
 /** 
@@ -71,19 +130,45 @@ struct wall {
 	uint32_t endY;	
 };
 
+/**
+ * Area where walls moved, appeared, or went away this sim tick.
+ */
+struct dirty_region {
+	uint32_t minX;
+	uint32_t minY;
+	uint32_t maxX;
+	uint32_t maxY;
+};
+
 /**
  * Environment (track).
  */
 struct environment {
 	uint32_t finishLineY;
-	uint8_t numWalls;
+	uint16_t numWalls;
 	struct wall * walls;
+	struct track_sdf * sdf; // optional distance field of walls, 0 if none
+	struct pose_table * poseTable; // host ray distance table, 0 if none
+	const struct dirty_region * dirty; // set by Obstacles_Step, see Obstacles.h
+	uint8_t numDirty;
+};
+
+/**
+ * Stages of a sim tick, timed for live data.
+ */
+enum sim_stage {
+	STAGE_ACTUATORS,
+	STAGE_MOVE,
+	STAGE_COLLISION,
+	STAGE_SENSORS,
+	NUM_SIM_STAGES
 };
 
 /**
  * Struct to hold data for printing while sim is running.
  */
 struct live_data {
+	uint16_t seq; // one per frame put, so gaps show frames lost
 	uint32_t time;
 	uint32_t x;	
 	uint32_t y;
@@ -92,15 +177,40 @@ struct live_data {
 	uint16_t servoDuty;
 	uint16_t motorPB7Duty;
 	uint16_t motorPB6Duty;
+	uint16_t sensors[LIVE_DATA_SENSORS]; // sensor vals, capped at 0xFFFF
+	uint32_t stageCycles[NUM_SIM_STAGES]; // of the previous sim tick
 };
 
+// GLOBALS
+
+// Rays cast and walls tested by Simulator_UpdateSensors
+extern SIM_STAT uint32_t NumRaysCast;
+extern SIM_STAT uint32_t NumWallTests;
+
 // FUNCTIONS
 
 /**
- * Based on velocity, direction, and sim_freq update car's position.
+ * Based on velocity, direction, and sim_freq update car's position. With
+ * BICYCLE_MODEL, this is Simulator_MoveCarArc, and with DIFF_DRIVE 
+ * Simulator_MoveCarDiff.
  */
 void Simulator_MoveCar(struct car * car, uint32_t timePassedMs);
 
+/**
+ * Bicycle model: move the car along the circular arc set by its velocity,
+ * steer angle, and WHEELBASE_MM, turning it to face along the arc's end.
+ * Exact for any time step the steer angle is held over, up to fixed point
+ * rounding.
+ */
+void Simulator_MoveCarArc(struct car * car, uint32_t timePassedMs);
+
+/**
+ * Differential drive: move the car along the circular arc set by its left
+ * and right wheel velocities and TRACK_WIDTH_MM. Exact for any time step 
+ * the wheel velocities are held over, up to fixed point rounding.
+ */
+void Simulator_MoveCarDiff(struct car * car, uint32_t timePassedMs);
+
 /**
  * Based on previous and next location, determine if hit wall.
  */
@@ -110,8 +220,11 @@ uint8_t Simulator_HitWall(struct environment * env, uint32_t prevX,
 /**
  * Update sensor values relative to environment. For each sensor, based on 
  * sensor's direction, car's direction, and car's position determine distance
- * to closest wall.
+ * to closest wall. The wall each sensor hit last update is tested first and
+ * walls that can't be closer than that hit are skipped. If the car hasn't 
+ * moved since the last update, only sensors whose rays cross one of env's
+ * dirty regions are updated. Returns 0 if no sensor value was updated.
  */
-void Simulator_UpdateSensors(struct car * car, struct environment * env);
+uint8_t Simulator_UpdateSensors(struct car * car, struct environment * env);
 
 #endif // SIMULATOR_H
@@ -0,0 +1,135 @@
+/********** StackPool.c ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Thread stacks allocated from fixed size classes. See 
+  StackPool.h.
+*/
+
+#include <stdint.h>
+#include "OS.h"
+#include "StackPool.h"
+#include "terminal.h"
+
+uint32_t StartCritical(void);
+void EndCritical(uint32_t oldState);
+
+// Size class stacks, in words.
+static uint32_t Stacks256[NUM_STACKS_256][256 / 4];
+static uint32_t Stacks512[NUM_STACKS_512][512 / 4];
+static uint32_t Stacks1024[NUM_STACKS_1024][1024 / 4];
+static uint32_t Stacks2048[NUM_STACKS_2048][2048 / 4];
+
+static const uint16_t ClassWords[NUM_STACK_CLASSES] = {
+  256 / 4, 512 / 4, 1024 / 4, 2048 / 4
+};
+
+// Overlaid on the bottom of a free stack, links it to the next free stack
+// of its class.
+struct free_stack {
+  uint32_t guard;
+  struct free_stack * next;
+};
+
+// Head of each class's free list.
+static struct free_stack * FreeStacks[NUM_STACK_CLASSES];
+
+static void initClass(uint8_t class, uint32_t * stacks, uint8_t count);
+static uint8_t getClass(uint16_t words);
+
+/**************StackPool_Init***************
+ Builds the free list for each size class.
+ Inputs : none
+ Outputs: none
+*/
+void StackPool_Init(void) {
+  initClass(0, &Stacks256[0][0], NUM_STACKS_256);
+  initClass(1, &Stacks512[0][0], NUM_STACKS_512);
+  initClass(2, &Stacks1024[0][0], NUM_STACKS_1024);
+  initClass(3, &Stacks2048[0][0], NUM_STACKS_2048);
+}
+
+/**************StackPool_Alloc***************
+ Takes a stack from the smallest class that fits, or a larger class if that
+ one is empty. The stack is painted with STACK_PAINT above the guard.
+ Inputs : bytes - requested stack size
+          words - set to the size of the stack returned, in words
+ Outputs: lowest address of stack, 0 if none left that fit
+*/
+uint32_t * StackPool_Alloc(uint32_t bytes, uint16_t * words) {
+  uint32_t * base = 0;
+  uint8_t class;
+  uint16_t iii;
+  uint32_t oldState;
+  
+  if (bytes > MAX_STACK_BYTES) {
+    return 0;
+  }
+  
+  oldState = StartCritical();
+  for (class = getClass((bytes + 3) / 4); class < NUM_STACK_CLASSES; class++) {
+    if (FreeStacks[class] != 0) {
+      base = (uint32_t *)FreeStacks[class];
+      FreeStacks[class] = FreeStacks[class]->next;
+      break;
+    }
+  }
+  EndCritical(oldState);
+  
+  if (base == 0) {
+    return 0;
+  }
+  
+  // Painted outside the critical section, the stack is ours now.
+  *words = ClassWords[class];
+  base[0] = STACK_GUARD;
+  for (iii = 1; iii < *words; iii++) {
+    base[iii] = STACK_PAINT;
+  }
+  return base;
+}
+
+/**************StackPool_Free***************
+ Returns a stack to its size class.
+ Inputs : base - lowest address of stack, from StackPool_Alloc
+          words - size of stack in words
+ Outputs: none
+*/
+void StackPool_Free(uint32_t * base, uint16_t words) {
+  struct free_stack * stack = (struct free_stack *)base;
+  uint8_t class = getClass(words);
+  uint32_t oldState = StartCritical();
+  stack->guard = STACK_GUARD;
+  stack->next = FreeStacks[class];
+  FreeStacks[class] = stack;
+  EndCritical(oldState);
+}
+
+/**************StackPool_StackOverflow***************
+ Called from Pack_Context when the running thread's guard word has been
+ overwritten. Does not return.
+ Inputs : none
+ Outputs: none
+*/
+void StackPool_StackOverflow(void) {
+  terminal_fatalErrorHandler(E_STACK_OVERFLOW, "Thread stack overflow");
+}
+
+static void initClass(uint8_t class, uint32_t * stacks, uint8_t count) {
+  uint8_t iii;
+  FreeStacks[class] = 0;
+  for (iii = 0; iii < count; iii++) {
+    StackPool_Free(&stacks[iii * ClassWords[class]], ClassWords[class]);
+  }
+}
+
+/**
+ * Returns smallest class holding at least words, NUM_STACK_CLASSES if none.
+ */
+static uint8_t getClass(uint16_t words) {
+  uint8_t class = 0;
+  while (class < NUM_STACK_CLASSES && ClassWords[class] < words) {
+    class++;
+  }
+  return class;
+}
@@ -0,0 +1,60 @@
+/********** StackPool.h ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Thread stacks allocated from fixed size classes. Each class is
+  a free list, so allocate and free are O(1). The lowest word of every stack
+  is a guard, checked on each context switch.
+*/
+#ifndef STACKPOOL_H
+#define STACKPOOL_H
+
+#include <stdint.h>
+
+// Stacks per size class. 14 KB total.
+#define NUM_STACKS_256  8
+#define NUM_STACKS_512  8
+#define NUM_STACKS_1024 4
+#define NUM_STACKS_2048 2
+
+#define NUM_STACK_CLASSES 4
+
+// Largest stack, in bytes.
+#define MAX_STACK_BYTES 2048
+
+// Lowest word of every stack. Overwritten means the thread overflowed.
+#define STACK_GUARD 0xDEADC0DE
+
+/**************StackPool_Init***************
+ Builds the free list for each size class.
+ Inputs : none
+ Outputs: none
+*/
+void StackPool_Init(void);
+
+/**************StackPool_Alloc***************
+ Takes a stack from the smallest class that fits, or a larger class if that
+ one is empty. The stack is painted with STACK_PAINT above the guard.
+ Inputs : bytes - requested stack size
+          words - set to the size of the stack returned, in words
+ Outputs: lowest address of stack, 0 if none left that fit
+*/
+uint32_t * StackPool_Alloc(uint32_t bytes, uint16_t * words);
+
+/**************StackPool_Free***************
+ Returns a stack to its size class.
+ Inputs : base - lowest address of stack, from StackPool_Alloc
+          words - size of stack in words
+ Outputs: none
+*/
+void StackPool_Free(uint32_t * base, uint16_t words);
+
+/**************StackPool_StackOverflow***************
+ Called from Pack_Context when the running thread's guard word has been
+ overwritten. Does not return.
+ Inputs : none
+ Outputs: none
+*/
+void StackPool_StackOverflow(void);
+
+#endif
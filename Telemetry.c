@@ -0,0 +1,221 @@
+/********** Telemetry.c ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Binary live data and actuator trace frames with COBS framing. 
+  See Telemetry.h.
+*/
+
+#include <stdint.h>
+#include "Telemetry.h"
+
+/**
+ * Little endian packing. Byte at a time so it doesn't depend on the host's
+ * byte order or alignment.
+ */
+static uint8_t *put16(uint8_t *pt, uint16_t val) {
+  pt[0] = val;
+  pt[1] = val >> 8;
+  return pt + 2;
+}
+
+static uint8_t *put32(uint8_t *pt, uint32_t val) {
+  pt[0] = val;
+  pt[1] = val >> 8;
+  pt[2] = val >> 16;
+  pt[3] = val >> 24;
+  return pt + 4;
+}
+
+static const uint8_t *get16(const uint8_t *pt, uint16_t *val) {
+  *val = pt[0] | (pt[1] << 8);
+  return pt + 2;
+}
+
+static const uint8_t *get32(const uint8_t *pt, uint32_t *val) {
+  *val = pt[0] | (pt[1] << 8) | ((uint32_t)pt[2] << 16) | 
+    ((uint32_t)pt[3] << 24);
+  return pt + 4;
+}
+
+/**
+ * Byte that makes the payload sum to 0.
+ */
+static uint8_t checksum(const uint8_t *pt, uint16_t len) {
+  uint8_t sum = 0;
+  while (len--) {
+    sum += *pt++;
+  }
+  return -sum;
+}
+
+/**
+ * COBS encode. Each run of non-zero bytes is preceded by a code byte, one
+ * more than the run's length, standing in for the 0 that follows it. Runs 
+ * are at most 254 bytes. Ends with the 0 delimiter.
+ */
+static uint16_t cobsEncode(const uint8_t *in, uint16_t len, uint8_t *out) {
+  uint8_t *code = out;
+  uint8_t *pt = out + 1;
+  uint8_t run = 1;
+  
+  while (len--) {
+    if (*in) {
+      *pt++ = *in;
+      run++;
+    }
+    if (!*in || run == 0xFF) {
+      *code = run;
+      code = pt++;
+      run = 1;
+    }
+    in++;
+  }
+  *code = run;
+  *pt++ = 0;
+  return pt - out;
+}
+
+/**
+ * COBS decode a frame without its delimiter.
+ * Returns decoded length, or -1 if the frame is malformed or too long.
+ */
+static int32_t cobsDecode(const uint8_t *in, uint16_t len, uint8_t *out,
+  uint16_t max) {
+  const uint8_t *end = in + len;
+  uint16_t outLen = 0;
+  uint8_t code;
+  uint8_t i;
+  
+  while (in < end) {
+    code = *in++;
+    if (code == 0 || in + code - 1 > end) {
+      return -1;
+    }
+    for (i = 1; i < code; i++) {
+      if (outLen == max) {
+        return -1;
+      }
+      out[outLen++] = *in++;
+    }
+    // The last run is not followed by a 0.
+    if (code < 0xFF && in < end) {
+      if (outLen == max) {
+        return -1;
+      }
+      out[outLen++] = 0;
+    }
+  }
+  return outLen;
+}
+
+/**
+ * Packs and COBS encodes a live data frame.
+ */
+uint16_t Telemetry_Encode(const struct live_data *data, uint8_t *frame) {
+  uint8_t payload[TELEMETRY_PAYLOAD_BYTES];
+  uint8_t *pt = payload;
+  int i;
+  
+  *pt++ = TELEMETRY_FRAME_LIVE;
+  pt = put16(pt, data->seq);
+  pt = put32(pt, data->time);
+  pt = put32(pt, data->x);
+  pt = put32(pt, data->y);
+  pt = put32(pt, data->vel);
+  pt = put16(pt, data->dir);
+  pt = put16(pt, data->servoDuty);
+  pt = put16(pt, data->motorPB7Duty);
+  pt = put16(pt, data->motorPB6Duty);
+  for (i = 0; i < LIVE_DATA_SENSORS; i++) {
+    pt = put16(pt, data->sensors[i]);
+  }
+  for (i = 0; i < NUM_SIM_STAGES; i++) {
+    pt = put32(pt, data->stageCycles[i]);
+  }
+  *pt = checksum(payload, TELEMETRY_PAYLOAD_BYTES - 1);
+  
+  return cobsEncode(payload, TELEMETRY_PAYLOAD_BYTES, frame);
+}
+
+/**
+ * COBS decodes and unpacks a live data frame.
+ */
+int Telemetry_Decode(const uint8_t *frame, uint16_t len, 
+  struct live_data *data) {
+  uint8_t payload[TELEMETRY_PAYLOAD_BYTES];
+  const uint8_t *pt = payload;
+  uint32_t val;
+  uint16_t half;
+  int i;
+  
+  if (cobsDecode(frame, len, payload, TELEMETRY_PAYLOAD_BYTES) != 
+      TELEMETRY_PAYLOAD_BYTES || 
+      checksum(payload, TELEMETRY_PAYLOAD_BYTES) != 0 ||
+      payload[0] != TELEMETRY_FRAME_LIVE) {
+    return 0;
+  }
+  
+  pt = get16(pt + 1, &data->seq);
+  pt = get32(pt, &data->time);
+  pt = get32(pt, &data->x);
+  pt = get32(pt, &data->y);
+  pt = get32(pt, &val);
+  data->vel = (int32_t)val;
+  pt = get16(pt, &half);
+  data->dir = half;
+  pt = get16(pt, &data->servoDuty);
+  pt = get16(pt, &data->motorPB7Duty);
+  pt = get16(pt, &data->motorPB6Duty);
+  for (i = 0; i < LIVE_DATA_SENSORS; i++) {
+    pt = get16(pt, &data->sensors[i]);
+  }
+  for (i = 0; i < NUM_SIM_STAGES; i++) {
+    pt = get32(pt, &data->stageCycles[i]);
+  }
+  return 1;
+}
+
+/**
+ * Packs and COBS encodes an actuator trace frame.
+ */
+uint16_t Telemetry_EncodeActuator(const struct actuator_sample *sample, 
+  uint8_t *frame) {
+  uint8_t payload[TELEMETRY_ACTUATOR_PAYLOAD_BYTES];
+  uint8_t *pt = payload;
+  int i;
+  
+  *pt++ = TELEMETRY_FRAME_ACTUATOR;
+  pt = put16(pt, sample->numTicks);
+  for (i = 0; i < MAX_TRACE_CHANNELS; i++) {
+    pt = put16(pt, sample->adc[i]);
+  }
+  pt = put32(pt, sample->time);
+  *pt = checksum(payload, TELEMETRY_ACTUATOR_PAYLOAD_BYTES - 1);
+  
+  return cobsEncode(payload, TELEMETRY_ACTUATOR_PAYLOAD_BYTES, frame);
+}
+
+/**
+ * COBS decodes and unpacks an actuator trace frame.
+ */
+int Telemetry_DecodeActuator(const uint8_t *frame, uint16_t len, 
+  struct actuator_sample *sample) {
+  uint8_t payload[TELEMETRY_ACTUATOR_PAYLOAD_BYTES];
+  const uint8_t *pt = payload;
+  int i;
+  
+  if (cobsDecode(frame, len, payload, TELEMETRY_ACTUATOR_PAYLOAD_BYTES) != 
+      TELEMETRY_ACTUATOR_PAYLOAD_BYTES || 
+      checksum(payload, TELEMETRY_ACTUATOR_PAYLOAD_BYTES) != 0 ||
+      payload[0] != TELEMETRY_FRAME_ACTUATOR) {
+    return 0;
+  }
+  
+  pt = get16(pt + 1, &sample->numTicks);
+  for (i = 0; i < MAX_TRACE_CHANNELS; i++) {
+    pt = get16(pt, &sample->adc[i]);
+  }
+  get32(pt, &sample->time);
+  return 1;
+}
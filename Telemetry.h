@@ -0,0 +1,74 @@
+/********** Telemetry.h ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Binary live data frames, an alternative to dataOut's text. 
+  A frame is the live data packed little endian behind a frame type and 
+  sequence number, with a checksum, then COBS encoded and ended with a 0 
+  byte. The receiver resyncs on any 0, and a gap in sequence numbers means 
+  frames were lost. Pure encode/decode, so the host decoder 
+  (tools/TelemetryDecode.c) shares it.
+  Recorded actuator samples (see ActuatorTrace.h) use the same framing.
+*/
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <stdint.h>
+#include "Simulator.h"
+#include "ActuatorTrace.h"
+
+#define TELEMETRY_FRAME_LIVE 0x01
+#define TELEMETRY_FRAME_ACTUATOR 0x02
+
+// type, seq, time, x, y, vel, dir, 3 duties, sensors, stage cycles, checksum
+#define TELEMETRY_PAYLOAD_BYTES (1 + 2 + 4*4 + 2 + 3*2 + \
+  2*LIVE_DATA_SENSORS + 4*NUM_SIM_STAGES + 1)
+
+// COBS adds a byte per 254 bytes of payload, plus the first code byte and 
+// the 0 delimiter.
+#define TELEMETRY_FRAME_BYTES (TELEMETRY_PAYLOAD_BYTES + \
+  TELEMETRY_PAYLOAD_BYTES / 254 + 2)
+
+// type, numTicks, samples, time, checksum
+#define TELEMETRY_ACTUATOR_PAYLOAD_BYTES (1 + 2 + 2*MAX_TRACE_CHANNELS + 4 + 1)
+#define TELEMETRY_ACTUATOR_FRAME_BYTES (TELEMETRY_ACTUATOR_PAYLOAD_BYTES + \
+  TELEMETRY_ACTUATOR_PAYLOAD_BYTES / 254 + 2)
+
+/**************Telemetry_Encode***************
+ Packs and COBS encodes a live data frame.
+ Inputs : data - live data to send
+          frame - TELEMETRY_FRAME_BYTES buffer for the encoded frame
+ Outputs: number of bytes in frame, including the 0 delimiter
+*/
+uint16_t Telemetry_Encode(const struct live_data *data, uint8_t *frame);
+
+/**************Telemetry_Decode***************
+ COBS decodes and unpacks a live data frame.
+ Inputs : frame - encoded frame, without the 0 delimiter
+          len - number of bytes in frame
+          data - set to the live data in the frame
+ Outputs: 1 if frame was a valid live data frame, 0 if not
+*/
+int Telemetry_Decode(const uint8_t *frame, uint16_t len, 
+  struct live_data *data);
+
+/**************Telemetry_EncodeActuator***************
+ Packs and COBS encodes an actuator trace frame.
+ Inputs : sample - recorded actuator sample to send
+          frame - TELEMETRY_ACTUATOR_FRAME_BYTES buffer for the encoded frame
+ Outputs: number of bytes in frame, including the 0 delimiter
+*/
+uint16_t Telemetry_EncodeActuator(const struct actuator_sample *sample, 
+  uint8_t *frame);
+
+/**************Telemetry_DecodeActuator***************
+ COBS decodes and unpacks an actuator trace frame.
+ Inputs : frame - encoded frame, without the 0 delimiter
+          len - number of bytes in frame
+          sample - set to the actuator sample in the frame
+ Outputs: 1 if frame was a valid actuator frame, 0 if not
+*/
+int Telemetry_DecodeActuator(const uint8_t *frame, uint16_t len, 
+  struct actuator_sample *sample);
+
+#endif
@@ -0,0 +1,90 @@
+/********** Trace.c ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Binary trace ring for leveled diagnostics. See Trace.h.
+*/
+
+#include <stdint.h>
+#include "Trace.h"
+
+#if TRACE_LEVEL > TRACE_LEVEL_NONE
+
+#include "terminal.h"
+
+uint32_t StartCritical(void);
+void EndCritical(uint32_t oldState);
+
+extern uint32_t Systick_Calls;
+
+static struct trace_record TraceBuffer[TRACE_BUFFER_SIZE];
+static uint32_t TraceCount = 0;
+
+/**************Trace_Log***************
+Description: Appends a record to the trace ring. Safe from ISRs. Use the 
+  TRACE_* macros instead so disabled levels compile out.
+Inputs: event - event id
+        level - TRACE_LEVEL_*
+        arg0, arg1 - event args
+Outputs: none
+*/
+void Trace_Log(TraceEvent_t event, uint8_t level, uint32_t arg0, 
+  uint32_t arg1) {
+  struct trace_record * record;
+  uint32_t oldState = StartCritical();
+  record = &TraceBuffer[TraceCount % TRACE_BUFFER_SIZE];
+  TraceCount++;
+  record->time = Systick_Calls;
+  record->event = event;
+  record->level = level;
+  record->arg0 = arg0;
+  record->arg1 = arg1;
+  EndCritical(oldState);
+}
+
+/**************Trace_PrintToTerminal***************
+Description: Dumps the trace ring oldest first, one record per line as hex
+  "time event level arg0 arg1".
+Inputs: none
+Outputs: none
+*/
+void Trace_PrintToTerminal(void) {
+  uint32_t i;
+  uint32_t start = 0;
+  struct trace_record * record;
+  
+  if (TraceCount > TRACE_BUFFER_SIZE) {
+    start = TraceCount - TRACE_BUFFER_SIZE;
+  }
+  
+  terminal_printString("\r\n----- Trace (");
+  terminal_printValueDec(TraceCount - start);
+  terminal_printString(" of ");
+  terminal_printValueDec(TraceCount);
+  terminal_printString(") -----\r\n");
+  for (i = start; i < TraceCount; i++) {
+    record = &TraceBuffer[i % TRACE_BUFFER_SIZE];
+    terminal_printValueHex(record->time);
+    terminal_printString(" ");
+    terminal_printValueHex(record->event);
+    terminal_printString(" ");
+    terminal_printValueHex(record->level);
+    terminal_printString(" ");
+    terminal_printValueHex(record->arg0);
+    terminal_printString(" ");
+    terminal_printValueHex(record->arg1);
+    terminal_printString("\r\n");
+  }
+}
+
+/**************Trace_Count***************
+Description: Returns number of records logged since boot, including 
+  overwritten ones.
+Inputs: none
+Outputs: record count
+*/
+uint32_t Trace_Count(void) {
+  return TraceCount;
+}
+
+#endif
@@ -0,0 +1,115 @@
+/********** Trace.h ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Compile-time leveled diagnostics logged as binary records 
+  (event id + 2 args) to a ring buffer, instead of formatting strings to the
+  UART at the call site. Call sites above TRACE_LEVEL compile out entirely.
+  The ring is dumped as hex with Trace_PrintToTerminal and decoded off target
+  using the event table below.
+*/
+
+#ifndef TRACE_H
+#define TRACE_H
+
+#include <stdint.h>
+
+// Levels, matching terminal_printMessage severities.
+#define TRACE_LEVEL_NONE     0
+#define TRACE_LEVEL_CRITICAL 1
+#define TRACE_LEVEL_WARNING  2
+#define TRACE_LEVEL_ADVISORY 3
+#define TRACE_LEVEL_INFO     4
+
+// Highest level compiled in.
+#define TRACE_LEVEL TRACE_LEVEL_WARNING
+
+// Number of records kept. Oldest are overwritten.
+#define TRACE_BUFFER_SIZE 64
+
+// Event ids. Args listed as (arg0, arg1).
+typedef enum TraceEvent {
+  TRACE_TCB_INIT,           // (tid, TCB address)
+  TRACE_OS_INIT_DONE,       // (MAX_THREADS, 0)
+  TRACE_ADD_THREAD,         // (new tid, prev tid << 8 | next tid)
+  TRACE_ADD_THREAD_FAILED,  // (task address, priority)
+  TRACE_NO_STACK,           // (stack bytes requested, priority)
+  TRACE_NO_INACTIVE,        // (new tid, 0)
+  TRACE_MUTEX_NOT_OWNER,    // (Sema4 address, caller tid)
+  TRACE_SHORT_TIME_SLICE,   // (time slice cycles, 0)
+  NUM_TRACE_EVENTS
+} TraceEvent_t;
+
+struct trace_record {
+  uint32_t time;            // Systick_Calls when logged
+  uint8_t event;
+  uint8_t level;
+  uint16_t pad;
+  uint32_t arg0;
+  uint32_t arg1;
+};
+
+#if TRACE_LEVEL >= TRACE_LEVEL_CRITICAL
+#define TRACE_CRITICAL(event, arg0, arg1) \
+  Trace_Log(event, TRACE_LEVEL_CRITICAL, (uint32_t)(uintptr_t)(arg0), \
+            (uint32_t)(uintptr_t)(arg1))
+#else
+#define TRACE_CRITICAL(event, arg0, arg1)
+#endif
+
+#if TRACE_LEVEL >= TRACE_LEVEL_WARNING
+#define TRACE_WARNING(event, arg0, arg1) \
+  Trace_Log(event, TRACE_LEVEL_WARNING, (uint32_t)(uintptr_t)(arg0), \
+            (uint32_t)(uintptr_t)(arg1))
+#else
+#define TRACE_WARNING(event, arg0, arg1)
+#endif
+
+#if TRACE_LEVEL >= TRACE_LEVEL_ADVISORY
+#define TRACE_ADVISORY(event, arg0, arg1) \
+  Trace_Log(event, TRACE_LEVEL_ADVISORY, (uint32_t)(uintptr_t)(arg0), \
+            (uint32_t)(uintptr_t)(arg1))
+#else
+#define TRACE_ADVISORY(event, arg0, arg1)
+#endif
+
+#if TRACE_LEVEL >= TRACE_LEVEL_INFO
+#define TRACE_INFO(event, arg0, arg1) \
+  Trace_Log(event, TRACE_LEVEL_INFO, (uint32_t)(uintptr_t)(arg0), \
+            (uint32_t)(uintptr_t)(arg1))
+#else
+#define TRACE_INFO(event, arg0, arg1)
+#endif
+
+#if TRACE_LEVEL > TRACE_LEVEL_NONE
+
+/**************Trace_Log***************
+Description: Appends a record to the trace ring. Safe from ISRs. Use the 
+  TRACE_* macros instead so disabled levels compile out.
+Inputs: event - event id
+        level - TRACE_LEVEL_*
+        arg0, arg1 - event args
+Outputs: none
+*/
+void Trace_Log(TraceEvent_t event, uint8_t level, uint32_t arg0, 
+  uint32_t arg1);
+
+/**************Trace_PrintToTerminal***************
+Description: Dumps the trace ring oldest first, one record per line as hex
+  "time event level arg0 arg1".
+Inputs: none
+Outputs: none
+*/
+void Trace_PrintToTerminal(void);
+
+/**************Trace_Count***************
+Description: Returns number of records logged since boot, including 
+  overwritten ones.
+Inputs: none
+Outputs: record count
+*/
+uint32_t Trace_Count(void);
+
+#endif
+
+#endif
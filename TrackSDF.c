@@ -0,0 +1,381 @@
+/********** TrackSDF.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Distance field of a track's walls. See TrackSDF.h.
+
+  While building, each cell holds the index of its nearest known wall
+  rather than a distance. Cells near a wall are seeded by walking every
+  wall, then two raster passes (8SSEDT order) offer each cell its
+  neighbors' walls and keep whichever is closer to the cell center. Last,
+  each index is replaced in place by the exact distance to that wall, so
+  no second buffer is needed.
+
+  Updates for moving walls don't propagate: every cell in range of the
+  change takes the min of its static distance and its exact distance to
+  each moving wall near the change. With few moving walls that's cheaper
+  than a rebuild and at least as accurate.
+*/
+
+#include <stdint.h>
+#include "TrackSDF.h"
+#include "isqrt.h"
+
+#define NO_WALL 0xFFFF // while building, cell has no wall candidate yet
+#define MAX_DISTANCE (SDF_FAR - 1)
+
+static void getGridSize(struct environment * env, uint32_t cellMm,
+                        uint32_t * width, uint32_t * height);
+static uint64_t distSqToWall(struct wall * wall, int32_t x, int32_t y);
+static void offerWall(struct environment * env, uint16_t * cell, int32_t x,
+                      int32_t y, uint16_t wallIndex);
+static void propagate(struct track_sdf * sdf, struct environment * env,
+                      int32_t i, int32_t j, int32_t fromI, int32_t fromJ);
+
+/**
+ * TrackSDF_Cells
+ * Input: env and cell size mm
+ * Output: number of cells TrackSDF_Build needs for env
+ */
+uint32_t TrackSDF_Cells(struct environment * env, uint32_t cellMm) {
+  uint32_t width, height;
+  getGridSize(env, cellMm, &width, &height);
+  if (width > 0xFFFF || height > 0xFFFF) {
+    return 0xFFFFFFFF;
+  }
+  return width * height;
+}
+
+/**
+ * TrackSDF_Build
+ * Rasterizes env's walls into sdf. See TrackSDF.h.
+ */
+ErrorCode_t TrackSDF_Build(struct track_sdf * sdf, struct environment * env,
+                           uint16_t * cells, uint32_t maxCells,
+                           uint32_t cellMm) {
+  uint32_t numCells, width, height, n;
+  int32_t i, j;
+  uint16_t k;
+
+  if (cellMm == 0 || cellMm > SDF_MAX_CELL_MM) {
+    return E_INVALID_PARAM;
+  }
+  numCells = TrackSDF_Cells(env, cellMm);
+  if (numCells > maxCells) {
+    return E_BUFFER_TOO_SMALL;
+  }
+
+  getGridSize(env, cellMm, &width, &height);
+  sdf->cellMm = cellMm;
+  sdf->width = width;
+  sdf->height = height;
+  sdf->cells = cells;
+  sdf->staticCells = 0;
+  for (n = 0; n < numCells; n++) {
+    cells[n] = NO_WALL;
+  }
+
+  // Seed every cell a wall passes through and their neighbors, sampling 
+  // twice per cell. Seeding only the cells under a wall loses walls that 
+  // share cells with a closer one, and the passes can't recover them.
+  for (k = 0; k < env->numWalls; k++) {
+    struct wall * wall = &env->walls[k];
+    int32_t dx = (int32_t)wall->endX - (int32_t)wall->startX;
+    int32_t dy = (int32_t)wall->endY - (int32_t)wall->startY;
+    int32_t len = (dx < 0 ? -dx : dx) > (dy < 0 ? -dy : dy) ?
+                  (dx < 0 ? -dx : dx) : (dy < 0 ? -dy : dy);
+    int32_t steps = len * 2 / (int32_t)cellMm + 1;
+    int32_t s, wallI, wallJ;
+    for (s = 0; s <= steps; s++) {
+      wallI = (wall->startX + (int64_t)dx * s / steps) / cellMm;
+      wallJ = (wall->startY + (int64_t)dy * s / steps) / cellMm;
+      for (j = wallJ - 1; j <= wallJ + 1; j++) {
+        for (i = wallI - 1; i <= wallI + 1; i++) {
+          if (i >= 0 && j >= 0 && i < sdf->width && j < sdf->height) {
+            offerWall(env, &cells[j * sdf->width + i], 
+                      i * cellMm + cellMm / 2, j * cellMm + cellMm / 2, k);
+          }
+        }
+      }
+    }
+  }
+
+  // Forward pass, then backward pass.
+  for (j = 0; j < sdf->height; j++) {
+    for (i = 0; i < sdf->width; i++) {
+      propagate(sdf, env, i, j, i - 1, j);
+      propagate(sdf, env, i, j, i - 1, j - 1);
+      propagate(sdf, env, i, j, i, j - 1);
+      propagate(sdf, env, i, j, i + 1, j - 1);
+    }
+    for (i = sdf->width - 2; i >= 0; i--) {
+      propagate(sdf, env, i, j, i + 1, j);
+    }
+  }
+  for (j = sdf->height - 1; j >= 0; j--) {
+    for (i = sdf->width - 1; i >= 0; i--) {
+      propagate(sdf, env, i, j, i + 1, j);
+      propagate(sdf, env, i, j, i + 1, j + 1);
+      propagate(sdf, env, i, j, i, j + 1);
+      propagate(sdf, env, i, j, i - 1, j + 1);
+    }
+    for (i = 1; i < sdf->width; i++) {
+      propagate(sdf, env, i, j, i - 1, j);
+    }
+  }
+
+  // Wall index -> distance.
+  for (j = 0; j < sdf->height; j++) {
+    for (i = 0; i < sdf->width; i++) {
+      uint16_t * cell = &cells[j * sdf->width + i];
+      uint64_t distSq;
+      if (*cell == NO_WALL) {
+        *cell = SDF_FAR;
+        continue;
+      }
+      distSq = distSqToWall(&env->walls[*cell], i * cellMm + cellMm / 2,
+                            j * cellMm + cellMm / 2);
+      *cell = distSq >= (uint64_t)MAX_DISTANCE * MAX_DISTANCE ?
+              MAX_DISTANCE : isqrt(distSq);
+    }
+  }
+
+  return E_SUCCESS;
+}
+
+/**
+ * TrackSDF_EnableUpdates
+ * Keeps the static field and caps cells at rangeMm. See TrackSDF.h.
+ */
+ErrorCode_t TrackSDF_EnableUpdates(struct track_sdf * sdf,
+                                   struct environment * env,
+                                   uint16_t * staticCells, uint32_t rangeMm) {
+  uint32_t n;
+
+  if (rangeMm == 0 || rangeMm >= SDF_FAR) {
+    return E_INVALID_PARAM;
+  }
+
+  sdf->staticCells = staticCells;
+  sdf->staticWalls = env->numWalls;
+  sdf->rangeMm = rangeMm;
+  for (n = 0; n < (uint32_t)sdf->width * sdf->height; n++) {
+    if (sdf->cells[n] > rangeMm) {
+      sdf->cells[n] = rangeMm;
+    }
+    staticCells[n] = sdf->cells[n];
+  }
+  return E_SUCCESS;
+}
+
+/**
+ * TrackSDF_Update
+ * Only cells whose centers are within range of region can have had a moving
+ * wall in range, before or after the change. Moving walls that can be in
+ * range of those cells are gathered once, then each cell is recomputed.
+ */
+void TrackSDF_Update(struct track_sdf * sdf, struct environment * env,
+                     const struct dirty_region * region) {
+  uint16_t near[SDF_UPDATE_WALLS];
+  uint16_t numNear = 0;
+  uint16_t first = sdf->staticWalls;
+  uint16_t last = env->numWalls;
+  uint32_t cellMm = sdf->cellMm;
+  int32_t range = sdf->rangeMm;
+  int32_t minI, maxI, minJ, maxJ, i, j, x, y;
+  uint16_t k;
+
+  if (!sdf->staticCells) {
+    return;
+  }
+
+  // Cells whose centers are within range of region, rounded out.
+  minI = ((int32_t)region->minX - range) / (int32_t)cellMm - 1;
+  maxI = ((int32_t)region->maxX + range) / (int32_t)cellMm + 1;
+  minJ = ((int32_t)region->minY - range) / (int32_t)cellMm - 1;
+  maxJ = ((int32_t)region->maxY + range) / (int32_t)cellMm + 1;
+  minI = minI < 0 ? 0 : minI;
+  minJ = minJ < 0 ? 0 : minJ;
+  maxI = maxI >= sdf->width ? sdf->width - 1 : maxI;
+  maxJ = maxJ >= sdf->height ? sdf->height - 1 : maxJ;
+  if (minI > maxI || minJ > maxJ) {
+    return;
+  }
+
+  // Moving walls within range of those cells. If there are too many to
+  // list, every moving wall is tested per cell.
+  for (k = first; k < last && numNear <= SDF_UPDATE_WALLS; k++) {
+    struct wall * wall = &env->walls[k];
+    int32_t wallMinX = wall->startX < wall->endX ? wall->startX : wall->endX;
+    int32_t wallMaxX = wall->startX < wall->endX ? wall->endX : wall->startX;
+    int32_t wallMinY = wall->startY < wall->endY ? wall->startY : wall->endY;
+    int32_t wallMaxY = wall->startY < wall->endY ? wall->endY : wall->startY;
+    if (wallMaxX + range < minI * (int32_t)cellMm ||
+        wallMinX - range > (maxI + 1) * (int32_t)cellMm ||
+        wallMaxY + range < minJ * (int32_t)cellMm ||
+        wallMinY - range > (maxJ + 1) * (int32_t)cellMm) {
+      continue;
+    }
+    if (numNear < SDF_UPDATE_WALLS) {
+      near[numNear] = k;
+    }
+    numNear++;
+  }
+
+  for (j = minJ; j <= maxJ; j++) {
+    y = j * cellMm + cellMm / 2;
+    for (i = minI; i <= maxI; i++) {
+      uint32_t n = j * sdf->width + i;
+      uint64_t bestSq, distSq;
+      uint16_t best = sdf->staticCells[n];
+      x = i * cellMm + cellMm / 2;
+      bestSq = (uint64_t)best * best;
+      if (numNear <= SDF_UPDATE_WALLS) {
+        for (k = 0; k < numNear; k++) {
+          distSq = distSqToWall(&env->walls[near[k]], x, y);
+          bestSq = distSq < bestSq ? distSq : bestSq;
+        }
+      } else {
+        for (k = first; k < last; k++) {
+          distSq = distSqToWall(&env->walls[k], x, y);
+          bestSq = distSq < bestSq ? distSq : bestSq;
+        }
+      }
+      if (bestSq < (uint64_t)best * best) {
+        best = isqrt(bestSq);
+      }
+      sdf->cells[n] = best;
+    }
+  }
+}
+
+/**
+ * TrackSDF_Clearance
+ * Bilinear between the four surrounding cell centers. Distance to walls is
+ * 1-Lipschitz, so the result is within about 0.71 cell of exact.
+ */
+uint32_t TrackSDF_Clearance(struct track_sdf * sdf, uint32_t x, uint32_t y) {
+  uint32_t cellMm = sdf->cellMm;
+  uint32_t fx, fy, tx, ty, i, j;
+  uint16_t * row;
+
+  if (x >= sdf->width * cellMm || y >= sdf->height * cellMm) {
+    return 0;
+  }
+
+  // Offsets from the center of cell (i, j)
+  fx = x > cellMm / 2 ? x - cellMm / 2 : 0;
+  fy = y > cellMm / 2 ? y - cellMm / 2 : 0;
+  i = fx / cellMm;
+  j = fy / cellMm;
+  tx = fx - i * cellMm;
+  ty = fy - j * cellMm;
+  if (i >= sdf->width - 1u) {
+    i = sdf->width - 2;
+    tx = cellMm;
+  }
+  if (j >= sdf->height - 1u) {
+    j = sdf->height - 2;
+    ty = cellMm;
+  }
+
+  row = &sdf->cells[j * sdf->width + i];
+  return ((row[0] * (cellMm - tx) + row[1] * tx) * (cellMm - ty) +
+          (row[sdf->width] * (cellMm - tx) + row[sdf->width + 1] * tx) * ty) /
+         (cellMm * cellMm);
+}
+
+/**
+ * TrackSDF_IsClear
+ * Input: point and radius in mm
+ * Output: 1 if no wall can be within radius of the point, 0 if one may be
+ */
+uint8_t TrackSDF_IsClear(struct track_sdf * sdf, uint32_t x, uint32_t y,
+                         uint32_t radius) {
+  return TrackSDF_Clearance(sdf, x, y) > radius + TrackSDF_Error(sdf);
+}
+
+/**
+ * TrackSDF_Error
+ * 0.71 cell of interpolation plus rounding of stored and interpolated mm.
+ */
+uint32_t TrackSDF_Error(struct track_sdf * sdf) {
+  return sdf->cellMm * 3 / 4 + 2;
+}
+
+/**
+ * Grid covers (0, 0) to one cell past the furthest wall endpoint, and is at
+ * least 2x2 so there are always four cells to interpolate between.
+ */
+static void getGridSize(struct environment * env, uint32_t cellMm,
+                        uint32_t * width, uint32_t * height) {
+  uint32_t maxX = 0;
+  uint32_t maxY = 0;
+  uint16_t k;
+
+  for (k = 0; k < env->numWalls; k++) {
+    struct wall * wall = &env->walls[k];
+    maxX = wall->startX > maxX ? wall->startX : maxX;
+    maxX = wall->endX > maxX ? wall->endX : maxX;
+    maxY = wall->startY > maxY ? wall->startY : maxY;
+    maxY = wall->endY > maxY ? wall->endY : maxY;
+  }
+  *width = maxX / cellMm + 2;
+  *height = maxY / cellMm + 2;
+}
+
+/**
+ * Squared distance from (x, y) to the closest point on wall.
+ */
+static uint64_t distSqToWall(struct wall * wall, int32_t x, int32_t y) {
+  int64_t dx = (int64_t)wall->endX - wall->startX;
+  int64_t dy = (int64_t)wall->endY - wall->startY;
+  int64_t lenSq = dx * dx + dy * dy;
+  int64_t t = (x - (int64_t)wall->startX) * dx + 
+              (y - (int64_t)wall->startY) * dy;
+  int64_t closestX, closestY;
+
+  if (lenSq == 0 || t <= 0) {
+    closestX = wall->startX;
+    closestY = wall->startY;
+  } else if (t >= lenSq) {
+    closestX = wall->endX;
+    closestY = wall->endY;
+  } else {
+    closestX = wall->startX + dx * t / lenSq;
+    closestY = wall->startY + dy * t / lenSq;
+  }
+
+  return (x - closestX) * (x - closestX) + (y - closestY) * (y - closestY);
+}
+
+/**
+ * Makes wallIndex the cell's candidate if that wall is closer to the cell
+ * center (x, y) than the current one.
+ */
+static void offerWall(struct environment * env, uint16_t * cell, int32_t x,
+                      int32_t y, uint16_t wallIndex) {
+  if (*cell == NO_WALL || (*cell != wallIndex &&
+      distSqToWall(&env->walls[wallIndex], x, y) <
+      distSqToWall(&env->walls[*cell], x, y))) {
+    *cell = wallIndex;
+  }
+}
+
+/**
+ * Offers cell (i, j) the candidate wall of cell (fromI, fromJ).
+ */
+static void propagate(struct track_sdf * sdf, struct environment * env,
+                      int32_t i, int32_t j, int32_t fromI, int32_t fromJ) {
+  uint16_t from;
+
+  if (fromI < 0 || fromJ < 0 || fromI >= sdf->width || fromJ >= sdf->height) {
+    return;
+  }
+  from = sdf->cells[fromJ * sdf->width + fromI];
+  if (from != NO_WALL) {
+    offerWall(env, &sdf->cells[j * sdf->width + i],
+              i * sdf->cellMm + sdf->cellMm / 2,
+              j * sdf->cellMm + sdf->cellMm / 2, from);
+  }
+}
@@ -0,0 +1,112 @@
+/********** TrackSDF.h **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Distance field of a track's walls. A grid of cells, each
+  holding the distance in mm from its center to the nearest wall, built once
+  after the walls are set. Gives O(1) clearance queries (bilinear between
+  cell centers) for near miss metrics and lets Simulator_HitWall skip the
+  wall scan whenever the car is clearly away from every wall.
+
+  Walls are thin segments, so there is no inside/outside and distances are
+  unsigned. Grid origin is (0, 0), matching the environment boundary.
+  Memory is 2 bytes per cell, owned by the caller.
+
+  Walls added to the environment after TrackSDF_EnableUpdates can move
+  (Obstacles.h). Distances are then capped at a range, so a wall only
+  changes cells within that range of it and TrackSDF_Update recomputes just
+  those, starting from a copy of the static walls' field. Another 2 bytes
+  per cell.
+*/
+
+#ifndef TRACKSDF_H
+#define TRACKSDF_H
+
+#include <stdint.h>
+#include "ErrorCodes.h"
+#include "Simulator.h"
+
+// Uncomment to build a distance field of the track at boot (HILMain).
+//#define TRACK_SDF
+
+#define SDF_MAX_CELL_MM 128 // keeps bilinear sums within 32 bits
+#define SDF_FAR 0xFFFF // cell further than 65534 mm from any wall, or no walls
+#define SDF_UPDATE_WALLS 32 // moving walls near one update before testing all
+
+struct track_sdf {
+  uint32_t cellMm;
+  uint16_t width; // cells
+  uint16_t height;
+  uint16_t * cells; // row-major, width * height, mm to nearest wall
+  uint16_t * staticCells; // static walls only, 0 unless updates are enabled
+  uint16_t staticWalls; // env walls at or after this index can move
+  uint16_t rangeMm; // cap on cells with updates enabled
+};
+
+/**
+ * TrackSDF_Build
+ * Rasterizes env's walls into sdf, covering (0, 0) to one cell past the
+ * furthest wall endpoint. Nearest walls are found with two propagation
+ * passes, so building is linear in cells plus wall length.
+ * Input: sdf to fill, env, cell buffer and its size in cells, cell size mm
+ * Output: E_SUCCESS, E_INVALID_PARAM for a bad cell size, or
+ *         E_BUFFER_TOO_SMALL if the track needs more than maxCells
+ */
+ErrorCode_t TrackSDF_Build(struct track_sdf * sdf, struct environment * env,
+                           uint16_t * cells, uint32_t maxCells,
+                           uint32_t cellMm);
+
+/**
+ * TrackSDF_EnableUpdates
+ * Call after TrackSDF_Build, before adding moving walls to env. Keeps the
+ * field of env's walls so far in staticCells (same size as the field) and
+ * caps every cell at rangeMm. Clearance queries and TrackSDF_IsClear radii
+ * beyond rangeMm then fall back to conservative answers.
+ * Input: sdf, env, buffer for static cells, range mm
+ * Output: E_SUCCESS or E_INVALID_PARAM for a range of 0 or SDF_FAR
+ */
+ErrorCode_t TrackSDF_EnableUpdates(struct track_sdf * sdf,
+                                   struct environment * env,
+                                   uint16_t * staticCells, uint32_t rangeMm);
+
+/**
+ * TrackSDF_Update
+ * Recomputes the cells within rangeMm of region from the static field and
+ * env's moving walls. Call after moving walls in region, once for where
+ * they were and where they are now (or one region covering both).
+ * Input: sdf with updates enabled, env, region where walls changed
+ */
+void TrackSDF_Update(struct track_sdf * sdf, struct environment * env,
+                     const struct dirty_region * region);
+
+/**
+ * TrackSDF_Cells
+ * Input: env and cell size mm
+ * Output: number of cells TrackSDF_Build needs for env
+ */
+uint32_t TrackSDF_Cells(struct environment * env, uint32_t cellMm);
+
+/**
+ * TrackSDF_Clearance
+ * Input: point in mm
+ * Output: estimated distance in mm to the nearest wall, within
+ *         TrackSDF_Error of the exact value. 0 outside the grid.
+ */
+uint32_t TrackSDF_Clearance(struct track_sdf * sdf, uint32_t x, uint32_t y);
+
+/**
+ * TrackSDF_IsClear
+ * Input: point and radius in mm
+ * Output: 1 if no wall can be within radius of the point, 0 if one may be
+ */
+uint8_t TrackSDF_IsClear(struct track_sdf * sdf, uint32_t x, uint32_t y,
+                         uint32_t radius);
+
+/**
+ * TrackSDF_Error
+ * Output: bound in mm on |TrackSDF_Clearance - exact distance|. Measured
+ *         worst cases with tools/SdfBench stay within it.
+ */
+uint32_t TrackSDF_Error(struct track_sdf * sdf);
+
+#endif // TRACKSDF_H
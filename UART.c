@@ -27,6 +27,9 @@
 
 // U0Rx (VCP receive) connected to PA0
 // U0Tx (VCP transmit) connected to PA1
+#ifdef HOST_BUILD
+#define _GNU_SOURCE // pseudoterminal functions
+#endif
 #include <stdint.h>
 #include "tm4c123gh6pm.h"
 
@@ -68,19 +71,91 @@ void WaitForInterrupt(void);  // low power mode
 #define FIFOSUCCESS 1         // return value on success
 #define FIFOFAIL    0         // return value on failure
                               // create index implementation FIFO (see FIFO.h)
-AddIndexFifo(Rx, FIFOSIZE, char, FIFOSUCCESS, FIFOFAIL)
-AddIndexFifo(Tx, FIFOSIZE, char, FIFOSUCCESS, FIFOFAIL)
+#ifdef HOST_BUILD
+#include <unistd.h>
+#ifdef UART_PTY
+#include <stdio.h>
+#include <stdlib.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <termios.h>
+#endif
+
+// Host builds (see OSHost.c) use stdin/stdout in place of UART0, or a 
+// pseudoterminal if UART_PTY.
+static int UartInFd = STDIN_FILENO;
+static int UartOutFd = STDOUT_FILENO;
+
+#ifdef UART_PTY
+// Pseudoterminal side the program holds open, so reads and writes on the
+// other side work before anything connects.
+static int UartPtySlave;
+
+// Opens the pseudoterminal and prints its name on stderr. Nonblocking, so 
+// like a real UART, output is dropped while nobody reads it and input waits
+// preemptibly.
+void UART_Init(void){ struct termios raw;
+  int fd = posix_openpt(O_RDWR | O_NOCTTY | O_NONBLOCK);
+  if(fd < 0 || grantpt(fd) < 0 || unlockpt(fd) < 0){
+    fprintf(stderr, "UART: no pseudoterminal, using stdin/stdout\n");
+    return;
+  }
+  UartPtySlave = open(ptsname(fd), O_RDWR | O_NOCTTY);
+  if(UartPtySlave >= 0 && tcgetattr(UartPtySlave, &raw) == 0){
+    cfmakeraw(&raw);
+    tcsetattr(UartPtySlave, TCSANOW, &raw);
+  }
+  fprintf(stderr, "UART on %s\n", ptsname(fd));
+  UartInFd = UartOutFd = fd;
+}
+#else
+void UART_Init(void){
+}
+#endif
+char UART_InChar(void){
+  char letter = 0;
+  while(read(UartInFd, &letter, 1) != 1){};
+  return(letter == LF ? CR : letter);
+}
+void UART_OutChar(char data){
+  UART_OutBuffer(&data, 1);
+}
+void UART_OutBuffer(const char *buf, uint32_t len){ ssize_t sent;
+  while(len > 0){
+    sent = write(UartOutFd, buf, len);
+    if(sent > 0){
+      buf += sent;
+      len -= sent;
+    }
+#ifdef UART_PTY
+    else if(errno == EAGAIN){
+      return;
+    }
+#endif
+  }
+}
+#else
+#include "OS.h"
+// Readers block on RxDataAvailable, signalled by the RX interrupt, so a 
+// thread waiting for input doesn't keep the CPU (see FIFO.h)
+AddBlockingFifo(Rx, FIFOSIZE, char, FIFOSUCCESS, FIFOFAIL)
+// Any thread may output, so Tx has multiple producers (see FIFO.h)
+AddMpscFifo(Tx, FIFOSIZE, char, FIFOSUCCESS, FIFOFAIL)
+
+// Baud rate divisor times 128, at 80 MHz bus clock. IBRD is the integer
+// part and FBRD the fraction in 64ths, rounded.
+#define UART_BRD_X128 ((80000000 * 8) / UART_BAUD)
 
 // Initialize UART0
-// Baud rate is 115200 bits/sec
+// Baud rate is UART_BAUD bits/sec
 void UART_Init(void){
   SYSCTL_RCGCUART_R |= 0x01;            // activate UART0
   SYSCTL_RCGCGPIO_R |= 0x01;            // activate port A
   RxFifo_Init();                        // initialize empty FIFOs
   TxFifo_Init();
   UART0_CTL_R &= ~UART_CTL_UARTEN;      // disable UART
-  UART0_IBRD_R = 43;                    // IBRD = int(80,000,000 / (16 * 115,200)) = int(43.403)
-  UART0_FBRD_R = 26;                    // FBRD = round(0.4028 * 64 ) = 26
+  UART0_IBRD_R = UART_BRD_X128 / 128;  // 115200: IBRD = int(80,000,000 / (16 * 115,200)) = int(43.403)
+  UART0_FBRD_R = ((UART_BRD_X128 % 128) + 1) / 2; // 115200: FBRD = round(0.4028 * 64 ) = 26
                                         // 8 bit word length (no parity bits, one stop bit, FIFOs)
   UART0_LCRH_R = (UART_LCRH_WLEN_8|UART_LCRH_FEN);
   UART0_IFLS_R &= ~0x3F;                // clear TX and RX interrupt FIFO level fields
@@ -119,21 +194,33 @@ void static copySoftwareToHardware(void){
   }
 }
 // input ASCII character from UART
-// spin if RxFifo is empty
+// block if RxFifo is empty
 char UART_InChar(void){
   char letter;
-  while(RxFifo_Get(&letter) == FIFOFAIL){};
+  RxFifo_Get(&letter);
   return(letter);
 }
 // output ASCII character to UART
 // spin if TxFifo is full
 void UART_OutChar(char data){
 	//if(TxFifo_Put(data) == FIFOFAIL) return;
-  while(TxFifo_Put(data) == FIFOFAIL){};
+  while(TxFifo_Put(&data) == FIFOFAIL){};
   UART0_IM_R &= ~UART_IM_TXIM;          // disable TX FIFO interrupt
   copySoftwareToHardware();
   UART0_IM_R |= UART_IM_TXIM;           // enable TX FIFO interrupt
 }
+// output len characters to UART, enqueued in as few FIFO puts as fit
+// spin while TxFifo is full
+void UART_OutBuffer(const char *buf, uint32_t len){ uint32_t sent;
+  while(len > 0){
+    sent = TxFifo_PutN(buf, len);
+    buf += sent;
+    len -= sent;
+    UART0_IM_R &= ~UART_IM_TXIM;        // disable TX FIFO interrupt
+    copySoftwareToHardware();
+    UART0_IM_R |= UART_IM_TXIM;         // enable TX FIFO interrupt
+  }
+}
 // at least one of three things has happened:
 // hardware TX FIFO goes from 3 to 2 or less items
 // hardware RX FIFO goes from 1 to 2 or more items
@@ -158,6 +245,7 @@ void UART0_Handler(void){
     copyHardwareToSoftware();
   }
 }
+#endif
 
 //------------UART_OutString------------
 // Output String (NULL termination)
@@ -34,6 +34,14 @@
 #define SP   0x20
 #define DEL  0x7F
 
+// Bits/sec. Binary telemetry (see Telemetry.h) at 1 kHz needs 1000000, which
+// the host end of the link must also be set to.
+#define UART_BAUD 115200
+
+// Host builds only: uncomment to put the UART on a pseudoterminal instead of
+// stdin/stdout. Its name is printed on stderr at UART_Init.
+//#define UART_PTY
+
 //------------UART_Init------------
 // Initialize the UART for 115,200 baud rate (assuming 50 MHz clock),
 // 8 bit word length, no parity bits, one stop bit, FIFOs enabled
@@ -53,6 +61,12 @@ char UART_InChar(void);
 // Output: none
 void UART_OutChar(char data);
 
+//------------UART_OutBuffer------------
+// Output a block of characters with bulk FIFO puts
+// Input: buf is the characters to transfer, len is the number of them
+// Output: none
+void UART_OutBuffer(const char *buf, uint32_t len);
+
 //------------UART_OutString------------
 // Output String (NULL termination)
 // Input: pointer to a NULL-terminated string to be transferred
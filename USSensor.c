@@ -1,7 +1,7 @@
 /**  
  * File: USSensor.c
  * Author: Sarah Masimore
- * Last Updated Date: 05/06/2018
+ * Last Updated Date: 10/18/2026
  * Description: Manages init'ing and updating Ultrasonic Ping sensor ports and 
  *              pins.
  */
@@ -9,6 +9,7 @@
  #include "tm4c123gh6pm.h"
  #include "USSensor.h"
  #include "terminal.h"
+ #include "Profiler.h"
 
 #define NUM_US_CHANNELS 3
 
@@ -20,7 +21,19 @@
 
 uint32_t CurPingPeriod[NUM_US_CHANNELS] = {0, 0, 0};
 
-static uint32_t getPeriodFromPingSensorVal(uint32_t val);
+#ifdef PROFILE_CRITICAL
+// Cycle count of the last edge on each channel, used to measure how late the
+// holdoff and echo edges land compared to the period they were scheduled for.
+static uint32_t PingMark[NUM_US_CHANNELS];
+static void profilePingEdge(uint8_t channel, IsrStat_t stat, 
+  uint32_t expected);
+#define PING_MARK(channel) PingMark[channel] = Profiler_Cycles()
+#define PING_CHECK(channel, stat, expected) \
+  profilePingEdge(channel, stat, expected)
+#else
+#define PING_MARK(channel)
+#define PING_CHECK(channel, stat, expected)
+#endif
 
 /**
  * Initialize 3 ultrasonic ping sensors by init'ing 3 GPIO pins and 3 timers.
@@ -141,13 +154,13 @@ void USSensor_Init(struct sensor * sensor) {
  * from robot.
  */
 void USSensor_UpdateOutput(struct sensor * sensor) {
-  CurPingPeriod[sensor->channel] = getPeriodFromPingSensorVal(sensor->val);
+  CurPingPeriod[sensor->channel] = USSensor_PeriodFromMM(sensor->val);
 }
  
 /**
  * Calculates period in cycles to elapse before sending response.
  */
-static uint32_t getPeriodFromPingSensorVal(uint32_t val) {
+uint32_t USSensor_PeriodFromMM(uint32_t val) {
   return CLOCK_FREQ / MACH_MM_PER_SECOND * val * 2;
 }
 
@@ -157,6 +170,7 @@ static uint32_t getPeriodFromPingSensorVal(uint32_t val) {
 void GPIOPortA_Handler(void){
   // PA3
   if(GPIO_PORTA_RIS_R&0x8){
+    PING_MARK(0);
     // Acknowledge
     GPIO_PORTA_ICR_R = 0x8;
     GPIO_PORTA_IM_R &= ~0x8; // Disarm interrupt
@@ -167,6 +181,7 @@ void GPIOPortA_Handler(void){
   
   // PA4
   } else if (GPIO_PORTA_RIS_R&0x10){
+    PING_MARK(1);
     // Acknowledge
     GPIO_PORTA_ICR_R = 0x10;
     GPIO_PORTA_IM_R &= ~0x10; // Disarm interrupt
@@ -177,6 +192,7 @@ void GPIOPortA_Handler(void){
  
   // PA5
   } else if (GPIO_PORTA_RIS_R&0x20){
+    PING_MARK(2);
     // Acknowledge
     GPIO_PORTA_ICR_R = 0x20;
     GPIO_PORTA_IM_R &= ~0x20; // Disarm interrupt
@@ -199,6 +215,8 @@ void Timer0A_Handler(void){
 
   // Start sending high signal to racecar's Ping input pin
   if (sendHigh) {
+    PING_CHECK(0, ISR_PING_HOLDOFF, PING_HOLDOFF_T);
+    
     // Flip pin to output
     GPIO_PORTA_DIR_R |= 0x8; // Set as output
     GPIO_PORTA_DATA_R |= 0x8; // Send high signal
@@ -209,6 +227,8 @@ void Timer0A_Handler(void){
     
     sendHigh = 0;
   } else {
+    PING_CHECK(0, ISR_PING_ECHO, CurPingPeriod[0]);
+    
     // Stop sending high
     GPIO_PORTA_DIR_R &= ~0x8; // Set as input
     GPIO_PORTA_DATA_R &= ~0x8; // Set low
@@ -236,6 +256,8 @@ void Timer1A_Handler(void){
 
   // Start sending high signal to racecar's Ping input pin
   if (sendHigh) {
+    PING_CHECK(1, ISR_PING_HOLDOFF, PING_HOLDOFF_T);
+    
     // Flip pin to output
     GPIO_PORTA_DIR_R |= 0x10; // Set as output
     GPIO_PORTA_DATA_R |= 0x10; // Send high signal
@@ -246,6 +268,8 @@ void Timer1A_Handler(void){
     
     sendHigh = 0;
   } else {
+    PING_CHECK(1, ISR_PING_ECHO, CurPingPeriod[1]);
+    
     // Stop sending high
     GPIO_PORTA_DIR_R &= ~0x10; // Set as input
     GPIO_PORTA_DATA_R &= ~0x10; // Set low
@@ -273,6 +297,8 @@ void Timer2A_Handler(void){
 
   // Start sending high signal to racecar's Ping input pin
   if (sendHigh) {
+    PING_CHECK(2, ISR_PING_HOLDOFF, PING_HOLDOFF_T);
+    
     // Flip pin to output
     GPIO_PORTA_DIR_R |= 0x20; // Set as output
     GPIO_PORTA_DATA_R |= 0x20; // Send high signal
@@ -283,6 +309,8 @@ void Timer2A_Handler(void){
     
     sendHigh = 0;
   } else {
+    PING_CHECK(2, ISR_PING_ECHO, CurPingPeriod[2]);
+    
     // Stop sending high
     GPIO_PORTA_DIR_R &= ~0x20; // Set as input
     GPIO_PORTA_DATA_R &= ~0x20; // Set low
@@ -297,3 +325,17 @@ void Timer2A_Handler(void){
     sendHigh = 1;
   }
 }
+
+#ifdef PROFILE_CRITICAL
+/**
+ * Records how many cycles past its scheduled time this edge landed, and marks
+ * it as the start of the next period.
+ */
+static void profilePingEdge(uint8_t channel, IsrStat_t stat, 
+  uint32_t expected) {
+  uint32_t now = Profiler_Cycles();
+  uint32_t actual = now - PingMark[channel];
+  Profiler_RecordLatency(stat, actual > expected ? actual - expected : 0);
+  PingMark[channel] = now;
+}
+#endif
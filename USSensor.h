@@ -1,7 +1,7 @@
 /**	
  * File: USSensor.h
  * Author: Sarah Masimore
- * Last Updated Date: 04/19/2018
+ * Last Updated Date: 10/18/2026
  * Description: Manages init'ing and updating Ultrasonic Ping sensor ports and 
  *              pins.
  */
@@ -11,3 +11,9 @@
 void USSensor_Init(struct sensor * sensor);
 
 void USSensor_UpdateOutput(struct sensor * sensor);
+
+/**
+ * Echo period in bus cycles USSensor_UpdateOutput sends for a sensor val in
+ * mm.
+ */
+uint32_t USSensor_PeriodFromMM(uint32_t val);
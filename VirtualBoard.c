@@ -0,0 +1,299 @@
+/********** VirtualBoard.c ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host stand-in for the board and racecar. See VirtualBoard.h.
+  
+  Register blocks are plain memory, so the board does what the hardware 
+  would after each interrupt handler returns: clears flags written to the 
+  ICR registers, starts or stops timers by their CTL enable, and watches 
+  the ping pins for echo edges. Events within a SysTick run in time order,
+  so echo widths are exact to the cycle.
+*/
+
+#ifdef HOST_BUILD
+
+#include <stdint.h>
+#include <sys/mman.h>
+#include "tm4c123gh6pm.h"
+#include "VirtualBoard.h"
+#include "Simulator.h"
+#include "OSHost.h"
+#include "terminal.h"
+
+// Peripheral register blocks mapped to host memory.
+#define PERIPHERAL_BASE 0x40000000
+#define PERIPHERAL_SIZE 0x00100000 // through System Control
+#define CORE_BASE       0xE000E000
+#define CORE_SIZE       0x00001000 // NVIC and SysTick
+
+#define ADC_MAX 4095
+
+// Ping pins PA3-PA5
+#define PING_PIN(channel) (0x08 << (channel))
+
+// Handlers on target are in the vector table in startup.s.
+void GPIOPortA_Handler(void);
+void Timer0A_Handler(void);
+void Timer1A_Handler(void);
+void Timer2A_Handler(void);
+
+/**
+ * One-shot timer used by a ping channel.
+ */
+struct vb_timer {
+  volatile uint32_t * ctl;
+  volatile uint32_t * tailr;
+  volatile uint32_t * imr;
+  volatile uint32_t * ris;
+  volatile uint32_t * icr;
+  void (*handler)(void);
+  uint8_t running;
+  uint64_t deadline;
+};
+
+static struct vb_timer Timers[VB_NUM_PING];
+
+/**
+ * PWM generator driving an IR output.
+ */
+struct vb_pwm {
+  volatile uint32_t * load;
+  volatile uint32_t * cmpb;
+  volatile uint32_t * enable;
+  uint32_t enableBit;
+};
+
+static struct vb_pwm Pwms[VB_NUM_IR];
+
+static vb_controller_t Controller = 0;
+static struct vb_car_inputs CarInputs;
+static struct vb_car_outputs CarOutputs;
+static uint64_t NextControllerTime = 0;
+
+// Ping pin levels driven by the board, and when each echo started.
+static uint8_t PingLevels = 0;
+static uint64_t EchoStart[VB_NUM_PING];
+
+static void runBoard(uint64_t now);
+static void service(uint64_t now);
+static void triggerPing(uint8_t channel, uint64_t now);
+static void updateIrOutputs(void);
+static void mapRegion(uintptr_t base, uint32_t size);
+
+/**************VirtualBoard_Init***************
+ Maps the peripheral registers and starts running the board from the 
+ virtual SysTick.
+ Inputs : controller - racecar model, 0 for VirtualBoard_DefaultController
+ Outputs: none
+*/
+void VirtualBoard_Init(vb_controller_t controller) {
+  mapRegion(PERIPHERAL_BASE, PERIPHERAL_SIZE);
+  mapRegion(CORE_BASE, CORE_SIZE);
+  
+  Timers[0] = (struct vb_timer){&TIMER0_CTL_R, &TIMER0_TAILR_R, &TIMER0_IMR_R,
+    &TIMER0_RIS_R, &TIMER0_ICR_R, Timer0A_Handler, 0, 0};
+  Timers[1] = (struct vb_timer){&TIMER1_CTL_R, &TIMER1_TAILR_R, &TIMER1_IMR_R,
+    &TIMER1_RIS_R, &TIMER1_ICR_R, Timer1A_Handler, 0, 0};
+  Timers[2] = (struct vb_timer){&TIMER2_CTL_R, &TIMER2_TAILR_R, &TIMER2_IMR_R,
+    &TIMER2_RIS_R, &TIMER2_ICR_R, Timer2A_Handler, 0, 0};
+  
+  Pwms[0] = (struct vb_pwm){&PWM0_0_LOAD_R, &PWM0_0_CMPB_R, &PWM0_ENABLE_R, 0x01};
+  Pwms[1] = (struct vb_pwm){&PWM0_3_LOAD_R, &PWM0_3_CMPB_R, &PWM0_ENABLE_R, 0x40};
+  Pwms[2] = (struct vb_pwm){&PWM1_2_LOAD_R, &PWM1_2_CMPB_R, &PWM1_ENABLE_R, 0x10};
+  Pwms[3] = (struct vb_pwm){&PWM1_3_LOAD_R, &PWM1_3_CMPB_R, &PWM1_ENABLE_R, 0x40};
+  Pwms[4] = (struct vb_pwm){&PWM1_1_LOAD_R, &PWM1_1_CMPB_R, &PWM1_ENABLE_R, 0x04};
+  
+  Controller = controller ? controller : VirtualBoard_DefaultController;
+  NextControllerTime = 0;
+  OSHost_SetBoardHook(runBoard);
+}
+
+/**************VirtualBoard_AdcConvert***************
+ Completes an ADC1 sequencer 3 conversion on the channel in SSMUX3.
+ Inputs : none
+ Outputs: none
+*/
+void VirtualBoard_AdcConvert(void) {
+  uint8_t channel = ADC1_SSMUX3_R & 0xF;
+  uint32_t val = 0;
+  
+  if (channel < VB_NUM_AIN) {
+    val = (uint32_t)CarOutputs.ainMv[channel] * (ADC_MAX + 1) / VB_SUPPLY_MV;
+    if (val > ADC_MAX) {
+      val = ADC_MAX;
+    }
+  }
+  ADC1_SSFIFO3_R = val;
+  ADC1_RIS_R |= 0x8;
+}
+
+/**************runBoard***************
+ Runs every board event up to now, in time order: timer timeouts and 
+ controller steps. Called from the virtual SysTick with SIGALRM blocked.
+*/
+static void runBoard(uint64_t now) {
+  uint64_t next;
+  int i, nextTimer;
+  
+  while (1) {
+    next = NextControllerTime;
+    nextTimer = -1;
+    for (i = 0; i < VB_NUM_PING; i++) {
+      if (Timers[i].running && Timers[i].deadline < next) {
+        next = Timers[i].deadline;
+        nextTimer = i;
+      }
+    }
+    if (next > now) {
+      return;
+    }
+    
+    if (nextTimer >= 0) {
+      // One-shot timeout disables the timer.
+      Timers[nextTimer].running = 0;
+      *Timers[nextTimer].ctl &= ~TIMER_CTL_TAEN;
+      *Timers[nextTimer].ris |= TIMER_RIS_TATORIS;
+      if (*Timers[nextTimer].imr & TIMER_IMR_TATOIM) {
+        Timers[nextTimer].handler();
+      }
+      service(next);
+      continue;
+    }
+    
+    NextControllerTime += VB_CONTROLLER_PERIOD;
+    CarInputs.time = next;
+    updateIrOutputs();
+    Controller(&CarInputs, &CarOutputs);
+    for (i = 0; i < VB_NUM_PING; i++) {
+      if (CarOutputs.pingTrigger & (1 << i)) {
+        triggerPing(i, next);
+      }
+    }
+    CarOutputs.pingTrigger = 0;
+  }
+}
+
+/**************service***************
+ Does what the hardware would after a handler returns: clears acknowledged 
+ flags, starts or stops timers, and records ping echo edges.
+*/
+static void service(uint64_t now) {
+  uint8_t levels;
+  int i;
+  
+  GPIO_PORTA_RIS_R &= ~GPIO_PORTA_ICR_R;
+  GPIO_PORTA_ICR_R = 0;
+  
+  for (i = 0; i < VB_NUM_PING; i++) {
+    *Timers[i].ris &= ~*Timers[i].icr;
+    *Timers[i].icr = 0;
+    if ((*Timers[i].ctl & TIMER_CTL_TAEN) && !Timers[i].running) {
+      Timers[i].running = 1;
+      Timers[i].deadline = now + *Timers[i].tailr;
+    } else if (!(*Timers[i].ctl & TIMER_CTL_TAEN)) {
+      Timers[i].running = 0;
+    }
+  }
+  
+  // Ping pins the board drives high.
+  levels = (GPIO_PORTA_DATA_R & GPIO_PORTA_DIR_R) >> 3;
+  for (i = 0; i < VB_NUM_PING; i++) {
+    if ((levels & ~PingLevels) & (1 << i)) {
+      EchoStart[i] = now;
+    } else if ((PingLevels & ~levels) & (1 << i)) {
+      CarInputs.pingEchoCycles[i] = now - EchoStart[i];
+    }
+  }
+  PingLevels = levels;
+}
+
+/**************triggerPing***************
+ Car drives a ping pin high. Ignored if the board is still answering the
+ last ping, since its edge interrupt is disarmed then.
+*/
+static void triggerPing(uint8_t channel, uint64_t now) {
+  uint32_t pin = PING_PIN(channel);
+  
+  if (!(GPIO_PORTA_IM_R & pin) || (GPIO_PORTA_DIR_R & pin)) {
+    return;
+  }
+  GPIO_PORTA_RIS_R |= pin;
+  GPIOPortA_Handler();
+  service(now);
+}
+
+/**************updateIrOutputs***************
+ Output is low from LOAD down to CMPB and high from CMPB to 0, filtered to 
+ its average voltage.
+*/
+static void updateIrOutputs(void) {
+  int i;
+  for (i = 0; i < VB_NUM_IR; i++) {
+    if (*Pwms[i].enable & Pwms[i].enableBit) {
+      CarInputs.irMv[i] = (uint64_t)VB_SUPPLY_MV * (*Pwms[i].cmpb + 1) / 
+        (*Pwms[i].load + 1);
+    } else {
+      CarInputs.irMv[i] = 0;
+    }
+  }
+}
+
+/**************mapRegion***************
+ Maps zeroed host memory at a register block's target address.
+*/
+static void mapRegion(uintptr_t base, uint32_t size) {
+  void * pt = mmap((void *)base, size, PROT_READ | PROT_WRITE, 
+    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+  if (pt != (void *)base) {
+    terminal_fatalErrorHandler(E_VIRTUAL_BOARD_MAP, 
+      "Register address range in use on host");
+  }
+}
+
+// Servo voltages ServoActuator bins as left, straight and right.
+#define SERVO_LEFT_MV 300
+#define SERVO_STRAIGHT_MV 100
+#define SERVO_RIGHT_MV 0
+
+// Echo cycles per mm of distance, see USSensor_PeriodFromMM.
+#define PING_CYCLES_PER_MM 462
+
+// Side clearance difference, in mm, before steering.
+#define STEER_THRESHOLD_MM 200
+
+// With DIFF_DRIVE, the inside wheel's motor voltage in a turn.
+#define INSIDE_WHEEL_MV (VB_SUPPLY_MV / 2)
+
+/**************VirtualBoard_DefaultController***************
+ Pings all sensors, drives forward, steers toward the side with more room.
+ Inputs : in - board outputs the car sees
+          out - car outputs to update
+ Outputs: none
+*/
+void VirtualBoard_DefaultController(const struct vb_car_inputs * in, 
+  struct vb_car_outputs * out) {
+  uint32_t left = in->pingEchoCycles[1] / PING_CYCLES_PER_MM;
+  uint32_t right = in->pingEchoCycles[2] / PING_CYCLES_PER_MM;
+  
+#ifdef DIFF_DRIVE
+  // PB7 drives the left wheel and PB6 the right, slow the inside one.
+  out->ainMv[1] = left > right + STEER_THRESHOLD_MM ? INSIDE_WHEEL_MV : 
+                                                       VB_SUPPLY_MV;
+  out->ainMv[3] = right > left + STEER_THRESHOLD_MM ? INSIDE_WHEEL_MV : 
+                                                       VB_SUPPLY_MV;
+#else
+  out->ainMv[1] = VB_SUPPLY_MV; // PB7 full, PB6 off: forward
+  out->ainMv[3] = 0;
+#endif
+  if (left > right + STEER_THRESHOLD_MM) {
+    out->ainMv[0] = SERVO_LEFT_MV;
+  } else if (right > left + STEER_THRESHOLD_MM) {
+    out->ainMv[0] = SERVO_RIGHT_MV;
+  } else {
+    out->ainMv[0] = SERVO_STRAIGHT_MV;
+  }
+  out->pingTrigger = (1 << VB_NUM_PING) - 1;
+}
+
+#endif
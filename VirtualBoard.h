@@ -0,0 +1,82 @@
+/********** VirtualBoard.h ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host (Linux) stand-in for the TM4C board and the racecar wired 
+  to it, built when HOST_BUILD is defined. The peripheral register blocks are
+  mapped to host memory at their target addresses, so IRSensor.c, USSensor.c
+  and ADC.c run unchanged. Each virtual SysTick the board models the pins 
+  between them and a racecar controller:
+   - Ping: the controller triggers PA3-PA5. The board runs the GPIO and 
+     one-shot Timer0-2 interrupts, and measures each echo pulse.
+   - IR: PWM compare registers give the filtered voltage on each IR output.
+   - Actuators: the controller drives the ADC inputs on PE0-PE3.
+  The controller runs every VB_CONTROLLER_PERIOD of virtual time. The UART 
+  is emulated in UART.c (see UART_PTY).
+*/
+
+#ifndef VIRTUALBOARD_H
+#define VIRTUALBOARD_H
+
+#ifdef HOST_BUILD
+
+#include <stdint.h>
+
+#define VB_NUM_IR 5    // PB6, PC4, PF0, PF2, PE4, in IRSensor channel order
+#define VB_NUM_PING 3  // PA3, PA4, PA5, in USSensor channel order
+#define VB_NUM_AIN 4   // Ain0-3: PE3 servo, PE2 motor PB7, PE1, PE0 motor PB6
+
+#define VB_SUPPLY_MV 3300
+
+// 50 Hz, a typical racecar control loop. In 12.5ns units.
+#define VB_CONTROLLER_PERIOD (80000000 / 50)
+
+/**
+ * What the racecar reads from the board.
+ */
+struct vb_car_inputs {
+	uint64_t time; // virtual time, 12.5ns units
+	uint16_t irMv[VB_NUM_IR]; // IR outputs after the car's RC filter
+	uint32_t pingEchoCycles[VB_NUM_PING]; // last echo width, 0 until one ends
+};
+
+/**
+ * What the racecar drives into the board. Kept between controller steps.
+ */
+struct vb_car_outputs {
+	uint16_t ainMv[VB_NUM_AIN]; // actuator voltages after the RC filter
+	uint8_t pingTrigger; // bit n triggers ping channel n, cleared after step
+};
+
+typedef void (*vb_controller_t)(const struct vb_car_inputs * in, 
+  struct vb_car_outputs * out);
+
+/**************VirtualBoard_Init***************
+ Maps the peripheral registers and starts running the board from the 
+ virtual SysTick. Must be called before any driver touches a register.
+ Inputs : controller - racecar model, 0 for VirtualBoard_DefaultController
+ Outputs: none
+*/
+void VirtualBoard_Init(vb_controller_t controller);
+
+/**************VirtualBoard_AdcConvert***************
+ Completes an ADC1 sequencer 3 conversion on the channel in SSMUX3. Called 
+ by ADC_In where the hardware would start converting.
+ Inputs : none
+ Outputs: none
+*/
+void VirtualBoard_AdcConvert(void);
+
+/**************VirtualBoard_DefaultController***************
+ Simple racecar: pings all three sensors each step, drives forward at full 
+ speed, and steers toward whichever side ping sees more room on.
+ Inputs : in - board outputs the car sees
+          out - car outputs to update
+ Outputs: none
+*/
+void VirtualBoard_DefaultController(const struct vb_car_inputs * in, 
+  struct vb_car_outputs * out);
+
+#endif
+
+#endif
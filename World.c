@@ -0,0 +1,346 @@
+/**
+ * File: World.c
+ * Author: Sarah Masimore
+ * Last Updated Date: 10/18/2026
+ * Description: Several cars sharing one environment. See World.h.
+ */
+
+#include "World.h"
+
+// TrigLookup.h defines the tables, included once in Simulator.c.
+#define TRIG_SCALE 10000
+extern int32_t SinLookup[360];
+extern int32_t CosLookup[360];
+
+#define HALF_LENGTH (CAR_LENGTH_MM / 2)
+#define HALF_WIDTH (CAR_WIDTH_MM / 2)
+
+static void placeTracedCar(struct car * car, const struct pose_trace * trace,
+                           uint32_t tick);
+static void updateBox(struct car_box * box, struct car * car);
+static void sortByMinX(struct world * world);
+static uint8_t boxesOverlap(struct car_box * a, struct car_box * b);
+static uint8_t rayHitsBox(struct car_box * box, int32_t x, int32_t y,
+                          int32_t cos, int32_t sin, uint32_t maxDistance,
+                          uint32_t * distance);
+static int32_t iabs(int32_t n);
+
+/**
+ * Start a world with no cars in env.
+ */
+void World_Init(struct world * world, struct environment * env) {
+  world->env = env;
+  world->numCars = 0;
+  world->boxTests = 0;
+}
+
+/**
+ * Add a car, driven by the sim if trace is 0 or replaying trace otherwise.
+ */
+ErrorCode_t World_AddCar(struct world * world, struct car * car,
+                         const struct pose_trace * trace) {
+  uint8_t i = world->numCars;
+  uint8_t j;
+
+  if (i >= WORLD_MAX_CARS || car->numSensors > WORLD_MAX_SENSORS) {
+    return E_OVERFLOW;
+  }
+
+  world->cars[i] = car;
+  world->traces[i] = trace;
+  world->order[i] = i;
+  for (j = 0; j < car->numSensors; j++) {
+    world->wallVals[i][j] = car->sensors[j].val;
+  }
+  world->numCars++;
+  if (trace) {
+    placeTracedCar(car, trace, 0);
+  }
+  updateBox(&world->boxes[i], car);
+  return E_SUCCESS;
+}
+
+/**
+ * Move replayed cars, update boxes, and find colliding cars.
+ *
+ * Boxes are sorted by minX. Car order barely changes between ticks, so
+ * insertion sort is close to linear. Walking that order, each car is only
+ * compared with the cars after it whose minX is within its maxX; of those,
+ * pairs whose y ranges also overlap get the exact oriented box test.
+ */
+uint8_t World_Step(struct world * world, uint32_t tick) {
+  uint8_t i, j, a, b;
+  uint8_t collided = 0;
+
+  for (i = 0; i < world->numCars; i++) {
+    if (world->traces[i]) {
+      placeTracedCar(world->cars[i], world->traces[i], tick);
+    }
+    updateBox(&world->boxes[i], world->cars[i]);
+  }
+
+  sortByMinX(world);
+
+  for (i = 0; i < world->numCars; i++) {
+    a = world->order[i];
+    for (j = i + 1; j < world->numCars; j++) {
+      b = world->order[j];
+      if (world->boxes[b].minX > world->boxes[a].maxX) {
+        break; // every later box starts further right
+      }
+
+      if (world->boxes[b].minY > world->boxes[a].maxY ||
+          world->boxes[a].minY > world->boxes[b].maxY) {
+        continue;
+      }
+
+      world->boxTests++;
+      if (boxesOverlap(&world->boxes[a], &world->boxes[b])) {
+        collided |= (1 << a) | (1 << b);
+      }
+    }
+  }
+
+  return collided;
+}
+
+/**
+ * Update sensor values of car i from walls, then from other cars.
+ *
+ * Wall distances are kept per car and put back before the wall update,
+ * since values from the last update may have been shortened by a car that
+ * has since moved, and Simulator_UpdateSensors only casts the rays that
+ * need it.
+ *
+ * Each ray only needs to be tested against cars closer than the wall it
+ * hit, so cars whose bounding box misses the ray's bounding box up to that
+ * wall are skipped, and the walk over cars sorted by minX stops at the first
+ * car past the ray's maxX.
+ */
+void World_UpdateSensors(struct world * world, uint8_t i) {
+  struct car * car = world->cars[i];
+  struct sensor * sensor;
+  struct car_box * box;
+  uint8_t j, k;
+  uint16_t absDir;
+  int32_t cos, sin, endX, endY;
+  int32_t rayMinX, rayMaxX, rayMinY, rayMaxY;
+  uint32_t maxDistance, distance;
+
+  for (j = 0; j < car->numSensors; j++) {
+    car->sensors[j].val = world->wallVals[i][j];
+  }
+  if (Simulator_UpdateSensors(car, world->env)) {
+    for (j = 0; j < car->numSensors; j++) {
+      world->wallVals[i][j] = car->sensors[j].val;
+    }
+  }
+
+  if (world->numCars < 2) {
+    return;
+  }
+
+  for (j = 0; j < car->numSensors; j++) {
+    sensor = &car->sensors[j];
+    absDir = car->dir + sensor->dir;
+    if (absDir >= 360) {
+      absDir -= 360;
+    }
+
+    cos = CosLookup[absDir];
+    sin = SinLookup[absDir];
+    maxDistance = sensor->val < MAX_SENSOR_LINE_OF_SIGHT ? sensor->val :
+                                                           MAX_SENSOR_LINE_OF_SIGHT;
+    endX = (int32_t)car->x + cos * (int32_t)maxDistance / TRIG_SCALE;
+    endY = (int32_t)car->y + sin * (int32_t)maxDistance / TRIG_SCALE;
+    rayMinX = endX < (int32_t)car->x ? endX : (int32_t)car->x;
+    rayMaxX = endX < (int32_t)car->x ? (int32_t)car->x : endX;
+    rayMinY = endY < (int32_t)car->y ? endY : (int32_t)car->y;
+    rayMaxY = endY < (int32_t)car->y ? (int32_t)car->y : endY;
+
+    for (k = 0; k < world->numCars; k++) {
+      box = &world->boxes[world->order[k]];
+      if (box->minX > rayMaxX) {
+        break;
+      }
+
+      if (world->order[k] == i || box->maxX < rayMinX ||
+          box->minY > rayMaxY || box->maxY < rayMinY) {
+        continue;
+      }
+
+      world->boxTests++;
+      if (rayHitsBox(box, car->x, car->y, cos, sin, maxDistance, &distance) &&
+          distance < sensor->val) {
+        sensor->val = distance;
+        maxDistance = distance;
+      }
+    }
+  }
+}
+
+/**
+ * Set car's pose to the trace's pose for tick, or its last pose.
+ */
+static void placeTracedCar(struct car * car, const struct pose_trace * trace,
+                           uint32_t tick) {
+  const struct trace_pose * pose;
+
+  if (trace->numTicks == 0) {
+    return;
+  }
+
+  pose = &trace->poses[tick < trace->numTicks ? tick : trace->numTicks - 1];
+  car->x = pose->x;
+  car->y = pose->y;
+  car->dir = pose->dir < 360 ? pose->dir : pose->dir % 360;
+  car->vel = 0;
+}
+
+/**
+ * Box centered on the car's point, length along its direction. Bounding box
+ * is rounded out by 1 mm so it always contains the oriented box.
+ */
+static void updateBox(struct car_box * box, struct car * car) {
+  int32_t extentX, extentY;
+  uint32_t dir = car->dir < 360 ? car->dir : car->dir % 360;
+
+  box->x = car->x;
+  box->y = car->y;
+  box->cos = CosLookup[dir];
+  box->sin = SinLookup[dir];
+  extentX = (iabs(box->cos) * HALF_LENGTH + iabs(box->sin) * HALF_WIDTH) /
+            TRIG_SCALE + 1;
+  extentY = (iabs(box->sin) * HALF_LENGTH + iabs(box->cos) * HALF_WIDTH) /
+            TRIG_SCALE + 1;
+  box->minX = box->x - extentX;
+  box->maxX = box->x + extentX;
+  box->minY = box->y - extentY;
+  box->maxY = box->y + extentY;
+}
+
+/**
+ * Insertion sort of world->order by boxes' minX.
+ */
+static void sortByMinX(struct world * world) {
+  uint8_t i, j, car;
+
+  for (i = 1; i < world->numCars; i++) {
+    car = world->order[i];
+    for (j = i; j > 0 &&
+         world->boxes[world->order[j - 1]].minX > world->boxes[car].minX; j--) {
+      world->order[j] = world->order[j - 1];
+    }
+    world->order[j] = car;
+  }
+}
+
+/**
+ * Separating axis test of two oriented boxes. The boxes overlap unless their
+ * projections on one of the four edge directions are apart. Projections are
+ * in mm * TRIG_SCALE; callers have already checked bounding boxes overlap,
+ * so center offsets are under a few car lengths and nothing overflows.
+ */
+static uint8_t boxesOverlap(struct car_box * a, struct car_box * b) {
+  int32_t dx = b->x - a->x;
+  int32_t dy = b->y - a->y;
+  // Components of b's axes along a's axes, TRIG_SCALE.
+  int32_t uu = (a->cos * b->cos + a->sin * b->sin) / TRIG_SCALE;
+  int32_t uv = (a->cos * -b->sin + a->sin * b->cos) / TRIG_SCALE;
+  int32_t vu = (-a->sin * b->cos + a->cos * b->sin) / TRIG_SCALE;
+  int32_t vv = (a->sin * b->sin + a->cos * b->cos) / TRIG_SCALE;
+  int32_t center, radius;
+
+  // a's length axis
+  center = iabs(dx * a->cos + dy * a->sin);
+  radius = HALF_LENGTH * TRIG_SCALE + HALF_LENGTH * iabs(uu) +
+           HALF_WIDTH * iabs(uv);
+  if (center > radius) {
+    return 0;
+  }
+
+  // a's width axis
+  center = iabs(-dx * a->sin + dy * a->cos);
+  radius = HALF_WIDTH * TRIG_SCALE + HALF_LENGTH * iabs(vu) +
+           HALF_WIDTH * iabs(vv);
+  if (center > radius) {
+    return 0;
+  }
+
+  // b's length axis
+  center = iabs(dx * b->cos + dy * b->sin);
+  radius = HALF_LENGTH * TRIG_SCALE + HALF_LENGTH * iabs(uu) +
+           HALF_WIDTH * iabs(vu);
+  if (center > radius) {
+    return 0;
+  }
+
+  // b's width axis
+  center = iabs(-dx * b->sin + dy * b->cos);
+  radius = HALF_WIDTH * TRIG_SCALE + HALF_LENGTH * iabs(uv) +
+           HALF_WIDTH * iabs(vv);
+  return center <= radius;
+}
+
+/**
+ * Returns 1 and stores distance if the ray from (x, y) in direction
+ * (cos, sin) hits box within maxDistance mm. Slab test in the box's frame:
+ * the ray is inside the box for the distances where it is within both the
+ * length and the width slab. A ray starting inside the box hits at 0.
+ *
+ * A ray at a shallow angle to a side slides far along it for a small change
+ * across it, so the start is kept unrounded (mm * TRIG_SCALE) and the
+ * direction to 1/10 of TRIG_SCALE. Rays reach at most a line of sight past
+ * the box's bounding box, so the products stay under 2^31.
+ */
+static uint8_t rayHitsBox(struct car_box * box, int32_t x, int32_t y,
+                          int32_t cos, int32_t sin, uint32_t maxDistance,
+                          uint32_t * distance) {
+  int32_t px = x - box->x;
+  int32_t py = y - box->y;
+  int32_t start[2], dir[2], half[2];
+  int32_t near = 0;
+  int32_t far = maxDistance;
+  int32_t t0, t1, swap;
+  uint8_t axis;
+
+  // Ray start and direction along the box's axes.
+  start[0] = px * box->cos + py * box->sin;
+  start[1] = -px * box->sin + py * box->cos;
+  dir[0] = (cos * box->cos + sin * box->sin) / (TRIG_SCALE / 10);
+  dir[1] = (-cos * box->sin + sin * box->cos) / (TRIG_SCALE / 10);
+  half[0] = HALF_LENGTH * TRIG_SCALE;
+  half[1] = HALF_WIDTH * TRIG_SCALE;
+
+  for (axis = 0; axis < 2; axis++) {
+    if (dir[axis] == 0) {
+      // Parallel to this slab, inside it everywhere or nowhere.
+      if (iabs(start[axis]) > half[axis]) {
+        return 0;
+      }
+      continue;
+    }
+
+    t0 = (-half[axis] - start[axis]) * 10 / dir[axis];
+    t1 = (half[axis] - start[axis]) * 10 / dir[axis];
+    if (t0 > t1) {
+      swap = t0;
+      t0 = t1;
+      t1 = swap;
+    }
+
+    near = t0 > near ? t0 : near;
+    far = t1 < far ? t1 : far;
+    // far <= 0 is a ray starting on the box's edge and leaving it.
+    if (near > far || far <= 0) {
+      return 0;
+    }
+  }
+
+  *distance = near;
+  return 1;
+}
+
+static int32_t iabs(int32_t n) {
+  return n < 0 ? -n : n;
+}
@@ -0,0 +1,98 @@
+/**
+ * File: World.h
+ * Author: Sarah Masimore
+ * Last Updated Date: 10/18/2026
+ * Description: Several cars sharing one environment. Each car is a box
+ *              around its point (length along its direction), sensors see
+ *              other cars as well as walls, and cars that overlap have
+ *              collided. The hardware car is driven by the sim as before;
+ *              opponents replay recorded pose traces.
+ *
+ *              Cars are kept sorted by the left edge of their bounding
+ *              boxes (sweep and prune on x). Each tick only neighbors in
+ *              that order whose boxes overlap are tested exactly, and a
+ *              sensor ray is only tested against cars between its start and
+ *              the wall it hit.
+ */
+
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <stdint.h>
+#include "ErrorCodes.h"
+#include "Simulator.h"
+
+#define WORLD_MAX_CARS 8
+#define WORLD_MAX_SENSORS 8 // per car
+#define CAR_LENGTH_MM 400 // 1/10 scale racecar
+#define CAR_WIDTH_MM 200
+
+/**
+ * Pose of a replayed car for one sim tick. Same units as struct car.
+ */
+struct trace_pose {
+	uint16_t x;
+	uint16_t y;
+	uint16_t dir;
+};
+
+/**
+ * Recorded poses, one per sim tick. The last pose is held after the trace
+ * ends. Columns x, y, dir of a TelemetryDecode CSV give one.
+ */
+struct pose_trace {
+	uint16_t numTicks;
+	const struct trace_pose * poses;
+};
+
+/**
+ * Oriented box of a car, with its axis aligned bounding box.
+ */
+struct car_box {
+	int32_t x; // center, mm
+	int32_t y;
+	int32_t cos; // direction, TRIG_SCALE
+	int32_t sin;
+	int32_t minX;
+	int32_t maxX;
+	int32_t minY;
+	int32_t maxY;
+};
+
+struct world {
+	struct environment * env;
+	uint8_t numCars;
+	struct car * cars[WORLD_MAX_CARS];
+	const struct pose_trace * traces[WORLD_MAX_CARS]; // 0 if driven by sim
+	struct car_box boxes[WORLD_MAX_CARS];
+	uint8_t order[WORLD_MAX_CARS]; // car indexes by boxes[].minX
+	uint32_t wallVals[WORLD_MAX_CARS][WORLD_MAX_SENSORS]; // walls only
+	uint32_t boxTests; // exact car-car and ray-car tests, for profiling
+};
+
+/**
+ * Start a world with no cars in env.
+ */
+void World_Init(struct world * world, struct environment * env);
+
+/**
+ * Add a car. trace is 0 for the hardware car, whose pose the sim updates,
+ * or the poses an opponent replays. Returns E_OVERFLOW if the world is full
+ * or the car has more than WORLD_MAX_SENSORS sensors.
+ */
+ErrorCode_t World_AddCar(struct world * world, struct car * car,
+                         const struct pose_trace * trace);
+
+/**
+ * Move replayed cars to their pose for tick, then update boxes and find
+ * collisions. Returns a bit per car index, set if it overlaps another car.
+ */
+uint8_t World_Step(struct world * world, uint32_t tick);
+
+/**
+ * Update sensor values of car index i from walls (Simulator_UpdateSensors),
+ * then from other cars in the way. Call after World_Step.
+ */
+void World_UpdateSensors(struct world * world, uint8_t i);
+
+#endif // WORLD_H
@@ -12,8 +12,28 @@ extern uint32_t priorityOccupied;
 
 uint8_t getHighestPriority(void){
   uint8_t leading;
+#ifdef HOST_BUILD
+  leading = priorityOccupied ? __builtin_clz(priorityOccupied) : 32;
+#else
   __asm{
     CLZ leading, priorityOccupied
   }
+#endif
+  return (leading + NUM_PRIORITY_LEVELS) - 32;
+}
+
+/**
+ * Same as getHighestPriority for any bitmap with priorityOccupied's layout,
+ * e.g. a semaphore's priorityWaiting.
+ */
+uint8_t getHighestPriorityOf(uint32_t occupied){
+  uint8_t leading;
+#ifdef HOST_BUILD
+  leading = occupied ? __builtin_clz(occupied) : 32;
+#else
+  __asm{
+    CLZ leading, occupied
+  }
+#endif
   return (leading + NUM_PRIORITY_LEVELS) - 32;
 }
@@ -11,5 +11,7 @@
 #include <stdint.h>
 
 uint8_t getHighestPriority(void);
+
+uint8_t getHighestPriorityOf(uint32_t occupied);
 	
 #endif
@@ -17,6 +17,9 @@ Description: Implements interfacing with CLI via UART. See "Command Reference.tx
 #include "OS.h"
 #include "splash.h"
 #include "terminal.h"
+#include "Profiler.h"
+#include "Trace.h"
+#include "LineBuilder.h"
 
 #define MAX_BUFFER_LEN 50
 #define MAX_PARAM_LEN 25
@@ -197,7 +200,30 @@ ErrorCode_t terminal_ReadAndParse(void){ ErrorCode_t error;
   if(*buffer == '\0') return E_SUCCESS;
   if((error = readStringLower(buffer, &bufferOffset, command)) != E_SUCCESS) return error;
   
-  // NO COMMANDS CURRENTLY SUPPORTED FOR THIS PROGRAM
+  if(strcmp(command, "threads") == 0){
+    if((error = assertBufferEmpty(buffer, &bufferOffset)) != E_SUCCESS) return error;
+    OS_PrintThreadStats();
+    return E_SUCCESS;
+  }
+#if TRACE_LEVEL > TRACE_LEVEL_NONE
+  if(strcmp(command, "trace") == 0){
+    if((error = assertBufferEmpty(buffer, &bufferOffset)) != E_SUCCESS) return error;
+    Trace_PrintToTerminal();
+    return E_SUCCESS;
+  }
+#endif
+#ifdef PROFILE_CRITICAL
+  if(strcmp(command, "prof") == 0){
+    if((error = assertBufferEmpty(buffer, &bufferOffset)) != E_SUCCESS) return error;
+    Profiler_PrintToTerminal();
+    return E_SUCCESS;
+  }
+  if(strcmp(command, "profclear") == 0){
+    if((error = assertBufferEmpty(buffer, &bufferOffset)) != E_SUCCESS) return error;
+    Profiler_Clear();
+    return E_SUCCESS;
+  }
+#endif
   
   UART_OutString("\r\nERROR: Unknown command: ");
   UART_OutString(command);
@@ -304,6 +330,18 @@ void terminal_printValueDec(uint32_t value){
   UART_OutUDec(value);
 }
 
+/**************terminal_printValueHex***************
+Description: Prints a 32-bit integer to the UART terminal in hex format, 
+  regardless of TERMINAL_DEBUGGING.
+Inputs:
+  value - Value to print to the terminal
+  Outputs: None
+*/
+void terminal_printValueHex(uint32_t value){
+  if(!Initialized) terminal_init();
+  UART_OutUHex(value);
+}
+
 /**************terminal_printString***************
 Description: Prints a 32-bit integer to the UART terminal in dec format.
   Does not print on a new line, as it is intented to be printed immediately after an info message.
@@ -316,6 +354,17 @@ void terminal_printString(char * msg){
   UART_OutString(msg);
 }
 
+/**************terminal_printLine***************
+Description: Prints a built line to the UART terminal with one bulk FIFO put.
+Inputs:
+  line - Line to print to the terminal
+  Outputs: None
+*/
+void terminal_printLine(struct line_builder *line){
+  if(!Initialized) terminal_init();
+  UART_OutBuffer(line->buf, line->len);
+}
+
 #endif
 
 void HardFault_Handler(void){
@@ -82,6 +82,15 @@ Inputs:
 */
 void terminal_printValueDec(uint32_t value);
 
+/**************terminal_printValueHex***************
+Description: Prints a 32-bit integer to the UART terminal in hex format, 
+  regardless of TERMINAL_DEBUGGING.
+Inputs:
+  value - Value to print to the terminal
+  Outputs: None
+*/
+void terminal_printValueHex(uint32_t value);
+
 /**************terminal_printString***************
 Description: Prints a 32-bit integer to the UART terminal in dec format.
   Does not print on a new line, as it is intented to be printed immediately after an info message.
@@ -91,6 +100,15 @@ Inputs:
 */
 void terminal_printString(char * msg);
 
+/**************terminal_printLine***************
+Description: Prints a line built with LineBuilder, with one bulk FIFO put.
+Inputs:
+  line - Line to print to the terminal
+  Outputs: None
+*/
+struct line_builder;
+void terminal_printLine(struct line_builder *line);
+
 void HardFault_Handler(void);
 
 #endif
@@ -0,0 +1,178 @@
+/********** ArcBench.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host convergence check for Simulator_MoveCarArc and 
+  Simulator_MoveCarDiff. Drives 10 s of a schedule with sim steps from 1 to
+  500 ms, and compares the pose against the exact path in doubles (same
+  wheelbase, track width and tan lookup). Schedules, changing every 500 ms:
+   - circle: bicycle model, 20 degrees left at 1112 mm/s.
+   - slalom: bicycle model, -30 to 30 degrees and back at 1112 mm/s.
+   - diff: differential drive, wheel velocities from gentle turns to a
+     spin in place.
+  Euler is the same model stepped the way Simulator_MoveCar does without
+  BICYCLE_MODEL or DIFF_DRIVE: turn by the step's heading change, then move
+  straight, in doubles so only the step size is to blame. Prints the final
+  and the largest position error along the way (mm), and the ns per step
+  of the fixed point move.
+  Build: gcc -O2 -I.. ArcBench.c ../Simulator.c ../TrackSDF.c ../isqrt.c \
+          -lm -o ArcBench
+  Run:   ArcBench
+*/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+#include "Simulator.h"
+
+#define TRIG_SCALE 10000
+#define DURATION_MS 10000
+#define HOLD_MS 500 // steer schedule changes this often
+#define VEL 1112
+#define START_X 100000 // far from 0 so the pose never clamps
+#define START_Y 100000
+
+extern int32_t SinLookup[360];
+extern int32_t CosLookup[360];
+
+static const uint32_t Steps[] = {1, 10, 20, 50, 100, 250, 500};
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+enum schedule {
+  CIRCLE,
+  SLALOM,
+  DIFF,
+  NUM_SCHEDULES
+};
+
+static const char * ScheduleNames[NUM_SCHEDULES] = {"circle", "slalom",
+                                                    "diff"};
+
+/**
+ * Sets car's steer or wheel velocities for schedule at ms.
+ */
+static void drive(struct car * car, enum schedule schedule, uint32_t ms) {
+  static const int16_t steers[6] = {-30, -10, 10, 30, 10, -10};
+  static const int16_t wheels[6][2] = {
+    {1112, 900}, {900, 1112}, {1112, 1112}, {600, 1112}, {1112, 300},
+    {-500, 500}
+  };
+  uint32_t k = (ms / HOLD_MS) % 6;
+
+  car->vel = VEL;
+  car->steer = schedule == CIRCLE ? 20 : steers[k];
+  if (schedule == DIFF) {
+    car->velLeft = wheels[k][0];
+    car->velRight = wheels[k][1];
+    car->vel = (car->velLeft + car->velRight) / 2;
+  }
+}
+
+/**
+ * tan(steer) as Simulator_MoveCarArc sees it.
+ */
+static double tanSteer(int16_t steer) {
+  int32_t a = steer < 0 ? -steer : steer;
+  double t = SinLookup[a] * TRIG_SCALE / CosLookup[a] / (double)TRIG_SCALE;
+  return steer < 0 ? -t : t;
+}
+
+/**
+ * Advance (x, y, heading) by ms along car's exact arc, or Euler.
+ */
+static void advance(double * x, double * y, double * heading,
+                    struct car * car, enum schedule schedule, uint32_t ms,
+                    uint8_t euler) {
+  double dist, turn;
+
+  if (schedule == DIFF) {
+    dist = (car->velLeft + car->velRight) / 2.0 * ms / 1000;
+    turn = (double)(car->velRight - car->velLeft) * ms / 1000 /
+           TRACK_WIDTH_MM;
+  } else {
+    dist = car->vel * ms / 1000.0;
+    turn = dist * tanSteer(car->steer) / WHEELBASE_MM;
+  }
+
+  if (euler) {
+    *heading += turn;
+    *x += dist * cos(*heading);
+    *y += dist * sin(*heading);
+  } else if (fabs(turn) < 1e-12) {
+    *x += dist * cos(*heading);
+    *y += dist * sin(*heading);
+  } else if (fabs(dist) < 1e-12) {
+    *heading += turn;
+  } else {
+    double radius = dist / turn;
+    *x += radius * (sin(*heading + turn) - sin(*heading));
+    *y -= radius * (cos(*heading + turn) - cos(*heading));
+    *heading += turn;
+  }
+}
+
+static void run(enum schedule schedule, uint32_t stepMs) {
+  double ex = START_X, ey = START_Y, eh = M_PI / 2; // exact, 1 ms
+  double ux = START_X, uy = START_Y, uh = M_PI / 2; // Euler
+  double arcFinal = 0, arcMax = 0, eulerFinal = 0, eulerMax = 0;
+  double arcTime = 0, t0;
+  struct car car = {0};
+  uint32_t ms, k;
+
+  car.x = START_X;
+  car.y = START_Y;
+  car.dir = 90;
+
+  for (ms = 0; ms < DURATION_MS; ms += stepMs) {
+    double arcError, eulerError;
+
+    // Steps never straddle a schedule change, so the exact path can go
+    // 1 ms at a time along arcs as well.
+    drive(&car, schedule, ms);
+    for (k = 0; k < stepMs; k++) {
+      advance(&ex, &ey, &eh, &car, schedule, 1, 0);
+    }
+    advance(&ux, &uy, &uh, &car, schedule, stepMs, 1);
+    t0 = now();
+    if (schedule == DIFF) {
+      Simulator_MoveCarDiff(&car, stepMs);
+    } else {
+      Simulator_MoveCarArc(&car, stepMs);
+    }
+    arcTime += now() - t0;
+
+    arcError = hypot(car.fineX / (double)(1 << POSE_FRAC_BITS) - ex,
+                     car.fineY / (double)(1 << POSE_FRAC_BITS) - ey);
+    eulerError = hypot(ux - ex, uy - ey);
+    arcMax = arcError > arcMax ? arcError : arcMax;
+    eulerMax = eulerError > eulerMax ? eulerError : eulerMax;
+    arcFinal = arcError;
+    eulerFinal = eulerError;
+  }
+
+  printf("%8s %6u %10.2f %10.2f %10.2f %10.2f %8.1f\n",
+         ScheduleNames[schedule], stepMs, eulerFinal, eulerMax,
+         arcFinal, arcMax, arcTime * 1e9 / (DURATION_MS / stepMs));
+}
+
+int main(void) {
+  uint32_t s;
+  enum schedule schedule;
+
+  printf("%u ms, wheelbase %u mm, track width %u mm, errors in mm\n\n",
+         DURATION_MS, WHEELBASE_MM, TRACK_WIDTH_MM);
+  printf("%8s %6s %10s %10s %10s %10s %8s\n", "schedule", "step", "euler end",
+         "euler max", "arc end", "arc max", "arc ns");
+  for (schedule = 0; schedule < NUM_SCHEDULES; schedule++) {
+    for (s = 0; s < sizeof(Steps) / sizeof(Steps[0]); s++) {
+      run(schedule, Steps[s]);
+    }
+  }
+  return 0;
+}
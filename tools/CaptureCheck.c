@@ -0,0 +1,209 @@
+/********** CaptureCheck.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host check of MotorCapture against mock registers. Maps the
+  peripheral and core register blocks to host memory at their target
+  addresses, like VirtualBoard, then plays PWM edges the way the hardware
+  would deliver them: the timer count latched in TnR, the pin level in the
+  port's DATA register, then the edge handler. Checks the registers
+  MotorCapture_Init writes and the duty MotorCapture_GetDuty reports for
+  steady PWM, a duty change, counter wraparound, pins held high or low,
+  and both channels at once. Prints each failure and a total.
+  Build: gcc -O2 -I.. CaptureCheck.c ../MotorCapture.c -o CaptureCheck
+  Run:   CaptureCheck
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <sys/mman.h>
+#include "tm4c123gh6pm.h"
+#include "MotorCapture.h"
+
+#define PERIPHERAL_BASE 0x40000000
+#define PERIPHERAL_SIZE 0x00100000 // through System Control
+#define CORE_BASE       0xE000E000
+#define CORE_SIZE       0x00001000 // NVIC and SysTick
+
+#define PWM_PERIOD 4000 // 20 kHz at 80 MHz
+
+void WideTimer1A_Handler(void);
+void WideTimer1B_Handler(void);
+
+static uint32_t NumChecks, NumFailed;
+
+static void check(int ok, const char * what, uint32_t got,
+                  uint32_t expected) {
+  NumChecks++;
+  if (!ok) {
+    NumFailed++;
+    printf("FAIL %s: got %u (0x%x), expected %u (0x%x)\n", what, got, got,
+           expected, expected);
+  }
+}
+
+#define CHECK_EQ(what, got, expected) \
+  check((got) == (expected), what, got, expected)
+
+static int mapRegisters(uintptr_t base, uint32_t size) {
+  void * pt = mmap((void *)base, size, PROT_READ | PROT_WRITE,
+    MAP_PRIVATE | MAP_ANONYMOUS | MAP_FIXED_NOREPLACE, -1, 0);
+  return pt == (void *)base;
+}
+
+/**
+ * Edge on channel at count time, leaving the pin at level.
+ */
+static void edge(uint8_t channel, uint32_t time, uint8_t level) {
+  uint32_t pin = channel == MOTOR_CAPTURE_PB6 ? 0x40 : 0x80;
+
+  GPIO_PORTC_DATA_R = level ? GPIO_PORTC_DATA_R | pin :
+                              GPIO_PORTC_DATA_R & ~pin;
+  if (channel == MOTOR_CAPTURE_PB6) {
+    WTIMER1_TAR_R = time;
+    WTIMER1_TAV_R = time;
+    WTIMER1_RIS_R |= TIMER_ICR_CAECINT;
+    WTIMER1_ICR_R = 0;
+    WideTimer1A_Handler();
+    CHECK_EQ("A handler acknowledges", WTIMER1_ICR_R, TIMER_ICR_CAECINT);
+  } else {
+    WTIMER1_TBR_R = time;
+    WTIMER1_TBV_R = time;
+    WTIMER1_RIS_R |= TIMER_ICR_CBECINT;
+    WTIMER1_ICR_R = 0;
+    WideTimer1B_Handler();
+    CHECK_EQ("B handler acknowledges", WTIMER1_ICR_R, TIMER_ICR_CBECINT);
+  }
+}
+
+/**
+ * cycles of PWM at duty (tenths of percent) on channel from count start.
+ * Returns the count at the end of the last one.
+ */
+static uint32_t pwm(uint8_t channel, uint32_t start, uint16_t duty,
+                    uint32_t cycles) {
+  uint32_t high = PWM_PERIOD * duty / 1000;
+  uint32_t k;
+
+  for (k = 0; k < cycles; k++) {
+    edge(channel, start, 1);
+    edge(channel, start + high, 0);
+    start += PWM_PERIOD;
+  }
+  return start;
+}
+
+/**
+ * Moves both timers' free running count to time.
+ */
+static void setNow(uint32_t time) {
+  WTIMER1_TAV_R = time;
+  WTIMER1_TBV_R = time;
+}
+
+static void checkInit(void) {
+  MotorCapture_Init();
+  CHECK_EQ("wide timer 1 clock", SYSCTL_RCGCWTIMER_R & 0x02, 0x02);
+  CHECK_EQ("port C clock", SYSCTL_RCGCGPIO_R & 0x04, 0x04);
+  CHECK_EQ("PC6, PC7 alternate function", GPIO_PORTC_AFSEL_R & 0xC0, 0xC0);
+  CHECK_EQ("PC6, PC7 digital", GPIO_PORTC_DEN_R & 0xC0, 0xC0);
+  CHECK_EQ("PC6, PC7 inputs", GPIO_PORTC_DIR_R & 0xC0, 0);
+  CHECK_EQ("PC6, PC7 as WT1CCP0, WT1CCP1", GPIO_PORTC_PCTL_R & 0xFF000000,
+           0x77000000);
+  CHECK_EQ("split 32-bit timers", WTIMER1_CFG_R, TIMER_CFG_16_BIT);
+  CHECK_EQ("A count up edge time capture", WTIMER1_TAMR_R, 0x17);
+  CHECK_EQ("B count up edge time capture", WTIMER1_TBMR_R, 0x17);
+  CHECK_EQ("A, B full range", WTIMER1_TAILR_R & WTIMER1_TBILR_R,
+           0xFFFFFFFF);
+  CHECK_EQ("both edges, enabled", WTIMER1_CTL_R, 0x0D0D);
+  CHECK_EQ("capture event interrupts armed", WTIMER1_IMR_R, 0x0404);
+  CHECK_EQ("NVIC 96, 97 enabled", NVIC_EN3_R & 0x3, 0x3);
+  CHECK_EQ("NVIC 96, 97 priority 1", NVIC_PRI24_R & 0xE0E0, 0x2020);
+}
+
+static void checkDuties(void) {
+  static const uint16_t duties[] = {1, 250, 500, 700, 999};
+  uint32_t t = 1000;
+  uint32_t k;
+  char what[64];
+
+  for (k = 0; k < sizeof(duties) / sizeof(duties[0]); k++) {
+    t = pwm(MOTOR_CAPTURE_PB6, t, duties[k], 3);
+    snprintf(what, sizeof(what), "PB6 at %u", duties[k]);
+    CHECK_EQ(what, MotorCapture_GetDuty(MOTOR_CAPTURE_PB6), duties[k]);
+  }
+
+  // The first fall after a change reports it, within one period.
+  t = pwm(MOTOR_CAPTURE_PB6, t, 300, 1);
+  CHECK_EQ("PB6 first cycle after change",
+           MotorCapture_GetDuty(MOTOR_CAPTURE_PB6), 300);
+}
+
+static void checkWrap(void) {
+  uint32_t t = 0xFFFFFFFF - PWM_PERIOD * 2 - 100;
+  t = pwm(MOTOR_CAPTURE_PB7, t, 600, 5); // count wraps mid stream
+  CHECK_EQ("PB7 across wraparound", MotorCapture_GetDuty(MOTOR_CAPTURE_PB7),
+           600);
+}
+
+static void checkSteady(void) {
+  uint32_t t = 5000000;
+
+  t = pwm(MOTOR_CAPTURE_PB6, t, 400, 3);
+  edge(MOTOR_CAPTURE_PB6, t, 1); // then held high
+  setNow(t + MOTOR_CAPTURE_STALE_CYCLES / 2);
+  CHECK_EQ("PB6 held high briefly", MotorCapture_GetDuty(MOTOR_CAPTURE_PB6),
+           400);
+  setNow(t + MOTOR_CAPTURE_STALE_CYCLES + 1);
+  CHECK_EQ("PB6 held high", MotorCapture_GetDuty(MOTOR_CAPTURE_PB6), 1000);
+
+  t += MOTOR_CAPTURE_STALE_CYCLES * 2;
+  edge(MOTOR_CAPTURE_PB6, t, 0); // then held low
+  setNow(t + MOTOR_CAPTURE_STALE_CYCLES + 1);
+  CHECK_EQ("PB6 held low", MotorCapture_GetDuty(MOTOR_CAPTURE_PB6), 0);
+
+  // A long gap isn't taken as a period.
+  t += MOTOR_CAPTURE_STALE_CYCLES * 2;
+  edge(MOTOR_CAPTURE_PB6, t, 1);
+  edge(MOTOR_CAPTURE_PB6, t + 100, 0);
+  CHECK_EQ("PB6 after a gap", MotorCapture_GetDuty(MOTOR_CAPTURE_PB6), 400);
+  t = pwm(MOTOR_CAPTURE_PB6, t + PWM_PERIOD, 800, 1);
+  CHECK_EQ("PB6 after a gap and a cycle",
+           MotorCapture_GetDuty(MOTOR_CAPTURE_PB6), 800);
+}
+
+static void checkBoth(void) {
+  uint32_t t = 20000000;
+  uint32_t k;
+
+  // Interleaved edges, PB7 a quarter period behind.
+  for (k = 0; k < 4; k++) {
+    edge(MOTOR_CAPTURE_PB6, t, 1);
+    edge(MOTOR_CAPTURE_PB7, t + PWM_PERIOD / 4, 1);
+    edge(MOTOR_CAPTURE_PB6, t + PWM_PERIOD * 200 / 1000, 0);
+    edge(MOTOR_CAPTURE_PB7, t + PWM_PERIOD / 4 + PWM_PERIOD * 900 / 1000, 0);
+    t += PWM_PERIOD;
+  }
+  setNow(t + PWM_PERIOD / 2);
+  CHECK_EQ("both, PB6", MotorCapture_GetDuty(MOTOR_CAPTURE_PB6), 200);
+  CHECK_EQ("both, PB7", MotorCapture_GetDuty(MOTOR_CAPTURE_PB7), 900);
+}
+
+int main(void) {
+  if (!mapRegisters(PERIPHERAL_BASE, PERIPHERAL_SIZE) ||
+      !mapRegisters(CORE_BASE, CORE_SIZE)) {
+    printf("Register address range in use on host\n");
+    return 1;
+  }
+
+  checkInit();
+  setNow(0);
+  CHECK_EQ("no edges yet, low", MotorCapture_GetDuty(MOTOR_CAPTURE_PB7), 0);
+  checkDuties();
+  checkWrap();
+  checkSteady();
+  checkBoth();
+
+  printf("%u checks, %u failed\n", NumChecks, NumFailed);
+  return NumFailed != 0;
+}
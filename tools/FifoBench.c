@@ -0,0 +1,179 @@
+/********** FifoBench.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host throughput benchmark for the FIFO.h queues. Moves 32-byte
+  rows from producer threads to one consumer, the main thread, which takes
+  them in batches of 32:
+   - AddSpscFifo, one producer putting one row at a time and in batches.
+   - AddMpscFifo, 1, 2, 4, 8 and 16 producers each putting its share of
+     the rows one at a time.
+  A producer yields when the queue is full, and the consumer when it's
+  empty. Every row carries its producer and sequence number, and the
+  consumer checks each producer's rows arrive in order with none lost.
+  Prints rows/s and the order errors of each run.
+  Build: gcc -O2 -pthread -DHOST_BUILD -I.. FifoBench.c -o FifoBench
+  Run:   FifoBench [rows]
+*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "FIFO.h"
+
+#define FIFO_SIZE 1024
+#define BATCH 32
+#define MAX_PRODUCERS 16
+
+struct row {
+  uint32_t producer;
+  uint32_t seq;
+  uint8_t pad[24];
+};
+
+struct producer {
+  pthread_t thread;
+  uint32_t id;
+  uint32_t numRows;
+  uint32_t batch; // rows per put, SPSC only
+};
+
+AddSpscFifo(Spsc, FIFO_SIZE, struct row, 1, 0)
+AddMpscFifo(Mpsc, FIFO_SIZE, struct row, 1, 0)
+
+static atomic_uint Started;
+
+// Not used, host queues don't take critical sections.
+long StartCritical(void) { return 0; }
+void EndCritical(long sr) {}
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static void waitForStart(void) {
+  while (!atomic_load(&Started)) {
+    sched_yield();
+  }
+}
+
+static void * spscProducer(void * arg) {
+  struct producer * p = arg;
+  struct row rows[BATCH] = {{0}};
+  uint32_t seq = 0, n, i;
+
+  waitForStart();
+  while (seq < p->numRows) {
+    n = p->numRows - seq < p->batch ? p->numRows - seq : p->batch;
+    for (i = 0; i < n; i++) {
+      rows[i].producer = p->id;
+      rows[i].seq = seq + i;
+    }
+    for (i = 0; i < n; ) {
+      uint32_t put = SpscFifo_PutN(&rows[i], n - i);
+      if (put == 0) {
+        sched_yield();
+      }
+      i += put;
+    }
+    seq += n;
+  }
+  return 0;
+}
+
+static void * mpscProducer(void * arg) {
+  struct producer * p = arg;
+  struct row row = {0};
+
+  row.producer = p->id;
+  waitForStart();
+  for (row.seq = 0; row.seq < p->numRows; row.seq++) {
+    while (!MpscFifo_Put(&row)) {
+      sched_yield();
+    }
+  }
+  return 0;
+}
+
+/**
+ * Runs one configuration. Returns the order errors: rows out of sequence
+ * for their producer, from a bad producer, or missing at the end.
+ */
+static uint32_t run(const char * name, uint8_t mpsc, uint32_t numProducers,
+                    uint32_t batch, uint32_t numRows) {
+  struct producer producers[MAX_PRODUCERS];
+  uint32_t next[MAX_PRODUCERS] = {0};
+  struct row rows[BATCH];
+  uint32_t received = 0, errors = 0, n, i;
+  double start, secs;
+
+  numRows -= numRows % numProducers;
+  if (mpsc) {
+    MpscFifo_Init();
+  } else {
+    SpscFifo_Init();
+  }
+  atomic_store(&Started, 0);
+  for (i = 0; i < numProducers; i++) {
+    producers[i].id = i;
+    producers[i].numRows = numRows / numProducers;
+    producers[i].batch = batch;
+    pthread_create(&producers[i].thread, 0,
+                   mpsc ? mpscProducer : spscProducer, &producers[i]);
+  }
+
+  start = now();
+  atomic_store(&Started, 1);
+  while (received < numRows) {
+    n = mpsc ? MpscFifo_GetN(rows, BATCH) : SpscFifo_GetN(rows, BATCH);
+    if (n == 0) {
+      sched_yield();
+      continue;
+    }
+    for (i = 0; i < n; i++) {
+      uint32_t p = rows[i].producer;
+      if (p >= numProducers || rows[i].seq != next[p]) {
+        errors++;
+      }
+      if (p < numProducers) {
+        next[p] = rows[i].seq + 1;
+      }
+    }
+    received += n;
+  }
+  secs = now() - start;
+
+  for (i = 0; i < numProducers; i++) {
+    pthread_join(producers[i].thread, 0);
+    if (next[i] != numRows / numProducers) {
+      errors++;
+    }
+  }
+  printf("%-12s %9u %9u %10u %10.1f %8u\n", name, numProducers,
+         mpsc ? 1 : batch, numRows, numRows / secs / 1e6, errors);
+  return errors;
+}
+
+int main(int argc, char ** argv) {
+  static const uint32_t producerCounts[] = {1, 2, 4, 8, 16};
+  uint32_t numRows = argc > 1 ? strtoul(argv[1], 0, 0) : 2000000;
+  uint32_t errors = 0, k;
+
+  printf("%u-byte rows, queue of %u, consumer batches of %u\n",
+         (uint32_t)sizeof(struct row), FIFO_SIZE, BATCH);
+  printf("%-12s %9s %9s %10s %10s %8s\n", "queue", "producers", "put batch",
+         "rows", "Mrows/s", "errors");
+  errors += run("SPSC", 0, 1, 1, numRows);
+  errors += run("SPSC", 0, 1, BATCH, numRows);
+  for (k = 0; k < sizeof(producerCounts) / sizeof(producerCounts[0]); k++) {
+    errors += run("MPSC", 1, producerCounts[k], 1, numRows);
+  }
+  printf("%u order errors\n", errors);
+  return errors != 0;
+}
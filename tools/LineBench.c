@@ -0,0 +1,208 @@
+/********** LineBench.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host benchmark of SimLogger_PrintToTerminal's row output. The
+  same random SimLogger rows go through the host UART both ways:
+   - per char: UART_OutUDec and UART_OutString for each field, as
+     terminal_printValueDec and terminal_printString send them, one
+     write() per character.
+   - line: the row built with LineBuilder and sent with one
+     UART_OutBuffer, as terminal_printLine does.
+  Both outputs go to temp files first and must be byte-identical. Then each
+  path writes the rows to /dev/null, and rows/s is reported for each.
+  Velocities are negative for about half the rows and sensors are over the
+  MAX cutoff for about a quarter.
+  Build: gcc -O2 -DHOST_BUILD -I.. LineBench.c ../LineBuilder.c ../UART.c \
+          -o LineBench
+  Run:   LineBench [rows]
+*/
+
+#include <fcntl.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "LineBuilder.h"
+#include "UART.h"
+
+#define NUM_SENSORS 7
+#define SENSOR_MAX 1500 // SimLogger prints MAX above this
+
+// Same fields as SimLogger's, sensors as an array.
+struct row {
+  uint32_t numTicks;
+  uint32_t carX;
+  uint32_t carY;
+  int32_t carV;
+  uint16_t carDir;
+  uint32_t sensors[NUM_SENSORS];
+};
+
+static uint32_t RandState = 12345;
+
+static uint32_t randBelow(uint32_t n) {
+  // xorshift32
+  RandState ^= RandState << 13;
+  RandState ^= RandState >> 17;
+  RandState ^= RandState << 5;
+  return RandState % n;
+}
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/**
+ * Row output before LineBuilder, one UART call per field.
+ */
+static void printPerChar(const struct row * row) {
+  uint8_t i;
+
+  UART_OutUDec(row->numTicks);
+  UART_OutString(",");
+  UART_OutUDec(row->carX);
+  UART_OutString(",");
+  UART_OutUDec(row->carY);
+  UART_OutString(",");
+  if (row->carV < 0) {
+    UART_OutString("-");
+    UART_OutUDec(row->carV * -1);
+  } else {
+    UART_OutUDec(row->carV);
+  }
+  UART_OutString(",");
+  UART_OutUDec(row->carDir);
+  for (i = 0; i < NUM_SENSORS; i++) {
+    UART_OutString(",");
+    if (row->sensors[i] > SENSOR_MAX) {
+      UART_OutString("MAX");
+    } else {
+      UART_OutUDec(row->sensors[i]);
+    }
+  }
+  UART_OutString("\r\n");
+}
+
+/**
+ * Row output as SimLogger_PrintToTerminal builds it.
+ */
+static void printLine(const struct row * row) {
+  static struct line_builder line;
+  uint8_t i;
+
+  LineBuilder_Clear(&line);
+  LineBuilder_AppendUDec(&line, row->numTicks);
+  LineBuilder_AppendString(&line, ",");
+  LineBuilder_AppendUDec(&line, row->carX);
+  LineBuilder_AppendString(&line, ",");
+  LineBuilder_AppendUDec(&line, row->carY);
+  LineBuilder_AppendString(&line, ",");
+  LineBuilder_AppendDec(&line, row->carV);
+  LineBuilder_AppendString(&line, ",");
+  LineBuilder_AppendUDec(&line, row->carDir);
+  for (i = 0; i < NUM_SENSORS; i++) {
+    LineBuilder_AppendString(&line, ",");
+    if (row->sensors[i] > SENSOR_MAX) {
+      LineBuilder_AppendString(&line, "MAX");
+    } else {
+      LineBuilder_AppendUDec(&line, row->sensors[i]);
+    }
+  }
+  LineBuilder_AppendString(&line, "\r\n");
+  UART_OutBuffer(line.buf, line.len);
+}
+
+/**
+ * Runs print on every row with the UART's stdout sent to fd. Returns the
+ * seconds taken.
+ */
+static double printTo(int fd, void (*print)(const struct row *),
+                      const struct row * rows, uint32_t numRows) {
+  int saved = dup(STDOUT_FILENO);
+  double start;
+  uint32_t i;
+
+  fflush(stdout);
+  dup2(fd, STDOUT_FILENO);
+  start = now();
+  for (i = 0; i < numRows; i++) {
+    print(&rows[i]);
+  }
+  start = now() - start;
+  dup2(saved, STDOUT_FILENO);
+  close(saved);
+  return start;
+}
+
+/**
+ * Reads all of a temp file from the start. Returns its length.
+ */
+static size_t readAll(FILE * file, char ** data) {
+  size_t len;
+
+  fseek(file, 0, SEEK_END);
+  len = ftell(file);
+  rewind(file);
+  *data = malloc(len + 1);
+  if (*data == 0 || fread(*data, 1, len, file) != len) {
+    fprintf(stderr, "couldn't read back output\n");
+    exit(1);
+  }
+  return len;
+}
+
+int main(int argc, char ** argv) {
+  uint32_t numRows = argc > 1 ? strtoul(argv[1], 0, 0) : 20000;
+  struct row * rows = calloc(numRows, sizeof(*rows));
+  FILE * perCharFile = tmpfile();
+  FILE * lineFile = tmpfile();
+  int devNull = open("/dev/null", O_WRONLY);
+  char * perCharOut, * lineOut;
+  size_t perCharLen, lineLen, diffAt;
+  double perCharSecs, lineSecs;
+  uint32_t i, k;
+
+  if (rows == 0 || perCharFile == 0 || lineFile == 0 || devNull < 0) {
+    fprintf(stderr, "setup failed\n");
+    return 1;
+  }
+  for (i = 0; i < numRows; i++) {
+    rows[i].numTicks = i;
+    rows[i].carX = randBelow(5000);
+    rows[i].carY = randBelow(5000);
+    rows[i].carV = (int32_t)randBelow(4001) - 2000;
+    rows[i].carDir = randBelow(360);
+    for (k = 0; k < NUM_SENSORS; k++) {
+      rows[i].sensors[k] = randBelow(2000);
+    }
+  }
+
+  printTo(fileno(perCharFile), printPerChar, rows, numRows);
+  printTo(fileno(lineFile), printLine, rows, numRows);
+  perCharLen = readAll(perCharFile, &perCharOut);
+  lineLen = readAll(lineFile, &lineOut);
+  for (diffAt = 0; diffAt < perCharLen && diffAt < lineLen &&
+       perCharOut[diffAt] == lineOut[diffAt]; diffAt++) {
+  }
+
+  perCharSecs = printTo(devNull, printPerChar, rows, numRows);
+  lineSecs = printTo(devNull, printLine, rows, numRows);
+
+  printf("%u rows, %zu bytes\n", numRows, perCharLen);
+  printf("%-10s %12s\n", "path", "rows/s");
+  printf("%-10s %12.0f\n", "per char", numRows / perCharSecs);
+  printf("%-10s %12.0f (%.1fx)\n", "line", numRows / lineSecs,
+         perCharSecs / lineSecs);
+  if (perCharLen != lineLen || diffAt != perCharLen) {
+    printf("FAIL outputs differ at byte %zu (lengths %zu, %zu)\n", diffAt,
+           perCharLen, lineLen);
+    return 1;
+  }
+  printf("outputs identical\n");
+  return 0;
+}
@@ -0,0 +1,179 @@
+/********** MotorFit.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host fit of the motor model in MotorActuator (first-order lag
+  with time constant tau, change limited to a max acceleration) to a logged
+  run of the car. Reads CSV rows of time (ms), signed motor duty (tenths of
+  percent, negative backwards), and measured velocity (mm/s) on stdin; a
+  header row is skipped. The duty is taken as held from each row to the
+  next. Searches tau and accel for the least squares velocity error, then
+  checks MotorModel_Step at each tick length in its table against the
+  fitted model on the same duty, and prints the MotorCoeffs initializer.
+  Build: gcc -O2 -I.. MotorFit.c ../MotorActuator.c -lm -o MotorFit
+  Run:   MotorFit < run.csv
+*/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "MotorActuator.h"
+#include "Simulator.h"
+
+#define MAX_VELOCITY 1114 // mm/s, keep in sync with MotorActuator
+#define MAX_ROWS 100000
+#define MIN_TAU_MS 5
+#define MAX_TAU_MS 2000
+#define MIN_ACCEL 100 // mm/s^2
+#define MAX_ACCEL 50000
+
+static const uint16_t TickLengths[] = {1, 5, 10, 20, 50, 100};
+
+// Stubs for what MotorActuator.c reads the duty with, unused here.
+struct live_data LiveData;
+void ActuatorTrace_Open(uint8_t channel) {}
+uint16_t ActuatorTrace_In(uint8_t channel) { return 0; }
+void terminal_fatalErrorHandler(ErrorCode_t errorCode, char * errorMessage) {
+  fprintf(stderr, "%s\n", errorMessage);
+  exit(1);
+}
+
+static double Times[MAX_ROWS], Targets[MAX_ROWS], Vels[MAX_ROWS];
+static uint32_t NumRows;
+
+/**
+ * Exact response of the model over dt ms with the target held: velocity
+ * moves at the accel limit while (target - vel) / tau would exceed it, then
+ * decays toward target.
+ */
+static double respond(double vel, double target, double dt, double tau,
+                      double accel) {
+  double error = target - vel;
+  double sign = error < 0 ? -1 : 1;
+  double limitMs = (fabs(error) - accel * tau / 1000) / (accel / 1000);
+
+  if (limitMs > 0) {
+    if (limitMs >= dt) {
+      return vel + sign * accel * dt / 1000;
+    }
+    vel += sign * accel * limitMs / 1000;
+    dt -= limitMs;
+  }
+  return target - (target - vel) * exp(-dt / tau);
+}
+
+/**
+ * Sum of squared velocity errors over the log.
+ */
+static double cost(double tau, double accel) {
+  double vel = Vels[0], sum = 0;
+  uint32_t i;
+
+  for (i = 1; i < NumRows; i++) {
+    vel = respond(vel, Targets[i - 1], Times[i] - Times[i - 1], tau, accel);
+    sum += (vel - Vels[i]) * (vel - Vels[i]);
+  }
+  return sum;
+}
+
+/**
+ * Grid search on log tau and log accel, then narrow around the best.
+ */
+static void fit(double * tau, double * accel) {
+  double lo[2] = {log(MIN_TAU_MS), log(MIN_ACCEL)};
+  double hi[2] = {log(MAX_TAU_MS), log(MAX_ACCEL)};
+  double best = INFINITY, center[2] = {0, 0};
+  int round, i, j;
+
+  for (round = 0; round < 8; round++) {
+    for (i = 0; i <= 20; i++) {
+      for (j = 0; j <= 20; j++) {
+        double t = lo[0] + (hi[0] - lo[0]) * i / 20;
+        double a = lo[1] + (hi[1] - lo[1]) * j / 20;
+        double c = cost(exp(t), exp(a));
+        if (c < best) {
+          best = c;
+          center[0] = t;
+          center[1] = a;
+        }
+      }
+    }
+    for (i = 0; i < 2; i++) {
+      double span = (hi[i] - lo[i]) / 5;
+      lo[i] = center[i] - span;
+      hi[i] = center[i] + span;
+    }
+  }
+  *tau = exp(center[0]);
+  *accel = exp(center[1]);
+}
+
+/**
+ * Worst difference (mm/s) between MotorModel_Step at coeffs' tick length and
+ * the fitted model, on the logged duty.
+ */
+static double checkTicks(const struct motor_coeffs * coeffs, double tau,
+                         double accel) {
+  struct motor_model model = {coeffs, 0};
+  double vel = 0, worst = 0, ms, end = Times[NumRows - 1] - Times[0];
+  uint32_t row = 0;
+
+  for (ms = 0; ms + coeffs->msPerTick <= end; ms += coeffs->msPerTick) {
+    double target, diff;
+    while (row + 1 < NumRows && Times[row + 1] - Times[0] <= ms) {
+      row++;
+    }
+    target = Targets[row];
+    vel = respond(vel, target, coeffs->msPerTick, tau, accel);
+    diff = fabs(MotorModel_Step(&model, (int32_t)lround(target)) - vel);
+    worst = diff > worst ? diff : worst;
+  }
+  return worst;
+}
+
+int main(void) {
+  struct motor_coeffs coeffs[sizeof(TickLengths) / sizeof(TickLengths[0])];
+  char line[256];
+  double tau, accel, t, duty, vel;
+  uint32_t i;
+
+  while (fgets(line, sizeof(line), stdin) && NumRows < MAX_ROWS) {
+    if (sscanf(line, "%lf,%lf,%lf", &t, &duty, &vel) != 3) {
+      continue;
+    }
+    Times[NumRows] = t;
+    Targets[NumRows] = duty * MAX_VELOCITY / 1000;
+    Vels[NumRows] = vel;
+    NumRows++;
+  }
+  if (NumRows < 3) {
+    fprintf(stderr, "need ms,duty,vel rows on stdin\n");
+    return 1;
+  }
+
+  fit(&tau, &accel);
+  printf("%u rows, tau = %.1f ms, max accel = %.0f mm/s^2, rms error = "
+         "%.1f mm/s\n\n", NumRows, tau, accel,
+         sqrt(cost(tau, accel) / (NumRows - 1)));
+
+  printf("%6s %12s\n", "ms", "max diff");
+  for (i = 0; i < sizeof(TickLengths) / sizeof(TickLengths[0]); i++) {
+    coeffs[i].msPerTick = TickLengths[i];
+    coeffs[i].alpha = lround(65536 * (1 - exp(-TickLengths[i] / tau)));
+    coeffs[i].maxStep = lround(accel * TickLengths[i] / 1000 *
+                               (1 << MOTOR_VEL_FRAC_BITS));
+    printf("%6u %12.1f\n", TickLengths[i],
+           checkTicks(&coeffs[i], tau, accel));
+  }
+
+  printf("\n// Printed by tools/MotorFit for tau = %.0f ms, max accel = "
+         "%.0f mm/s^2.\nstatic const struct motor_coeffs MotorCoeffs[] = {\n",
+         tau, accel);
+  for (i = 0; i < sizeof(TickLengths) / sizeof(TickLengths[0]); i++) {
+    printf("  {%u, %u, %d},\n", coeffs[i].msPerTick, coeffs[i].alpha,
+           coeffs[i].maxStep);
+  }
+  printf("};\n");
+  return 0;
+}
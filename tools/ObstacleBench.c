@@ -0,0 +1,237 @@
+/********** ObstacleBench.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host benchmark for moving obstacles. On a 10 x 10 m field of
+  random static walls, 1 to 50 box obstacles follow random scripts, some
+  appearing and going away, while parked cars watch with 7 sensors each.
+  Every tick is run twice: incrementally (Obstacles_Step updating the
+  distance field in dirty regions, then sensor updates that only cast rays
+  crossing one) and by full rebuild (TrackSDF_Build on all walls, capped at
+  the same range, then every ray cast). Prints ms per tick for the field
+  and the sensors each way, rays cast per tick, the largest difference
+  between the two fields (mm), and sensor values that differ (diff).
+  Build: gcc -O2 -I.. ObstacleBench.c ../Obstacles.c ../TrackSDF.c \
+          ../Simulator.c ../isqrt.c -lm -o ObstacleBench
+  Run:   ObstacleBench [cell mm] [ticks]
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "Simulator.h"
+#include "TrackSDF.h"
+#include "Obstacles.h"
+
+#define FIELD_MM 10000
+#define NUM_STATIC_WALLS 100
+#define BOX_MM 300
+#define NUM_KEYS 32
+#define KEY_TICKS 10 // ticks between script keys
+#define MAX_MOVE_MM 500 // from the box's start, per axis
+#define RANGE_MM 300
+#define NUM_CARS 20
+#define NUM_SENSORS 7
+#define MAX_WALLS (NUM_STATIC_WALLS + 2 + OBSTACLES_MAX * 4)
+
+static const uint32_t SensorDirs[NUM_SENSORS] = {0, 90, 270, 90, 270, 15, 345};
+static uint32_t RandState = 12345;
+
+static uint32_t randBelow(uint32_t n) {
+  // xorshift32
+  RandState ^= RandState << 13;
+  RandState ^= RandState >> 17;
+  RandState ^= RandState << 5;
+  return RandState % n;
+}
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/**
+ * Axis-aligned walls 100 - 1000 mm long inside the field, then two walls
+ * on the far edges so the distance field covers the whole field.
+ */
+static void staticWalls(struct wall * walls) {
+  uint16_t k;
+  for (k = 0; k < NUM_STATIC_WALLS; k++) {
+    uint32_t len = 100 + randBelow(900);
+    walls[k].startX = 1000 + randBelow(FIELD_MM - 3000);
+    walls[k].startY = 1000 + randBelow(FIELD_MM - 3000);
+    walls[k].endX = walls[k].startX;
+    walls[k].endY = walls[k].startY;
+    if (randBelow(2)) {
+      walls[k].endX += len;
+    } else {
+      walls[k].endY += len;
+    }
+  }
+  walls[k++] = (struct wall){FIELD_MM, 0, FIELD_MM, FIELD_MM};
+  walls[k] = (struct wall){0, FIELD_MM, FIELD_MM, FIELD_MM};
+}
+
+/**
+ * Square box at a random spot, moving to a random offset every KEY_TICKS.
+ * One in eight keys hides it.
+ */
+static void randomObstacle(struct obstacle * obstacle, struct wall * shape,
+                           struct obstacle_key * keys) {
+  uint32_t x = 1000 + randBelow(FIELD_MM - 2000 - BOX_MM);
+  uint32_t y = 1000 + randBelow(FIELD_MM - 2000 - BOX_MM);
+  uint8_t k;
+
+  shape[0] = (struct wall){x, y, x + BOX_MM, y};
+  shape[1] = (struct wall){x + BOX_MM, y, x + BOX_MM, y + BOX_MM};
+  shape[2] = (struct wall){x, y + BOX_MM, x + BOX_MM, y + BOX_MM};
+  shape[3] = (struct wall){x, y, x, y + BOX_MM};
+  for (k = 0; k < NUM_KEYS; k++) {
+    keys[k].tick = k * KEY_TICKS;
+    keys[k].dx = (int32_t)randBelow(2 * MAX_MOVE_MM + 1) - MAX_MOVE_MM;
+    keys[k].dy = (int32_t)randBelow(2 * MAX_MOVE_MM + 1) - MAX_MOVE_MM;
+    keys[k].visible = randBelow(8) != 0;
+  }
+  memset(obstacle, 0, sizeof(*obstacle));
+  obstacle->shape = shape;
+  obstacle->numWalls = 4;
+  obstacle->keys = keys;
+  obstacle->numKeys = NUM_KEYS;
+}
+
+static void parkCars(struct car * cars, struct sensor (*sensors)[NUM_SENSORS]) {
+  uint8_t i, j;
+  for (i = 0; i < NUM_CARS; i++) {
+    memset(&cars[i], 0, sizeof(cars[i]));
+    cars[i].x = 500 + randBelow(FIELD_MM - 1000);
+    cars[i].y = 500 + randBelow(FIELD_MM - 1000);
+    cars[i].dir = randBelow(360);
+    cars[i].numSensors = NUM_SENSORS;
+    cars[i].sensors = sensors[i];
+    for (j = 0; j < NUM_SENSORS; j++) {
+      sensors[i][j] = (struct sensor){S_IR, SensorDirs[j], 0, 0,
+                                      SENSOR_NO_WALL};
+    }
+  }
+}
+
+static void bench(uint8_t numObstacles, uint32_t cellMm, uint32_t numTicks) {
+  static struct wall walls[MAX_WALLS], fullWalls[MAX_WALLS];
+  static struct wall shapes[OBSTACLES_MAX][4];
+  static struct obstacle_key keys[OBSTACLES_MAX][NUM_KEYS];
+  static struct obstacle obstacles[OBSTACLES_MAX];
+  static struct sensor sensors[NUM_CARS][NUM_SENSORS];
+  static struct sensor fullSensors[NUM_CARS][NUM_SENSORS];
+  struct car cars[NUM_CARS], fullCars[NUM_CARS];
+  struct environment env = {0}, fullEnv = {0};
+  struct track_sdf sdf, fullSdf;
+  struct obstacle_set set;
+  uint16_t * cells, * staticCells, * fullCells;
+  uint32_t numCells, n, t, rays = 0, fullRays = 0, mismatches = 0;
+  uint32_t maxDiff = 0;
+  double t0, sdfTime = 0, sensorTime = 0, fullSdfTime = 0;
+  double fullSensorTime = 0;
+  uint8_t i, j;
+
+  RandState = 12345 + numObstacles;
+  staticWalls(walls);
+  env.walls = walls;
+  env.numWalls = NUM_STATIC_WALLS + 2;
+  numCells = TrackSDF_Cells(&env, cellMm);
+  cells = malloc(numCells * sizeof(uint16_t));
+  staticCells = malloc(numCells * sizeof(uint16_t));
+  fullCells = malloc(numCells * sizeof(uint16_t));
+  if (!cells || !staticCells || !fullCells ||
+      TrackSDF_Build(&sdf, &env, cells, numCells, cellMm) != E_SUCCESS ||
+      TrackSDF_EnableUpdates(&sdf, &env, staticCells, RANGE_MM) !=
+      E_SUCCESS) {
+    printf("setup failed\n");
+    exit(1);
+  }
+  env.sdf = &sdf;
+  for (i = 0; i < numObstacles; i++) {
+    randomObstacle(&obstacles[i], shapes[i], keys[i]);
+  }
+  Obstacles_Init(&set, &env, obstacles, numObstacles, MAX_WALLS);
+  parkCars(cars, sensors);
+  memcpy(fullCars, cars, sizeof(cars));
+  memcpy(fullSensors, sensors, sizeof(sensors));
+  for (i = 0; i < NUM_CARS; i++) {
+    fullCars[i].sensors = fullSensors[i];
+  }
+  fullEnv.walls = fullWalls;
+  for (i = 0; i < NUM_CARS; i++) {
+    Simulator_UpdateSensors(&cars[i], &env);
+  }
+
+  for (t = 1; t <= numTicks; t++) {
+    NumRaysCast = 0;
+    t0 = now();
+    Obstacles_Step(&set, t);
+    sdfTime += now() - t0;
+    t0 = now();
+    for (i = 0; i < NUM_CARS; i++) {
+      Simulator_UpdateSensors(&cars[i], &env);
+    }
+    sensorTime += now() - t0;
+    rays += NumRaysCast;
+
+    // Same walls, rebuilt from scratch.
+    memcpy(fullWalls, walls, env.numWalls * sizeof(struct wall));
+    fullEnv.numWalls = env.numWalls;
+    NumRaysCast = 0;
+    t0 = now();
+    TrackSDF_Build(&fullSdf, &fullEnv, fullCells, numCells, cellMm);
+    for (n = 0; n < numCells; n++) {
+      fullCells[n] = fullCells[n] > RANGE_MM ? RANGE_MM : fullCells[n];
+    }
+    fullSdfTime += now() - t0;
+    t0 = now();
+    for (i = 0; i < NUM_CARS; i++) {
+      fullCars[i].sensorCacheValid = 0;
+      Simulator_UpdateSensors(&fullCars[i], &fullEnv);
+    }
+    fullSensorTime += now() - t0;
+    fullRays += NumRaysCast;
+
+    for (n = 0; n < numCells; n++) {
+      uint32_t diff = cells[n] > fullCells[n] ? cells[n] - fullCells[n] :
+                                                fullCells[n] - cells[n];
+      maxDiff = diff > maxDiff ? diff : maxDiff;
+    }
+    for (i = 0; i < NUM_CARS; i++) {
+      for (j = 0; j < NUM_SENSORS; j++) {
+        mismatches += sensors[i][j].val != fullSensors[i][j].val;
+      }
+    }
+  }
+
+  printf("%9u %9.3f %9.3f %9.3f %9.3f %7.1f %7.1f %6u %5u\n", numObstacles,
+         fullSdfTime * 1e3 / numTicks, sdfTime * 1e3 / numTicks,
+         fullSensorTime * 1e3 / numTicks, sensorTime * 1e3 / numTicks,
+         (double)fullRays / numTicks, (double)rays / numTicks, maxDiff,
+         mismatches);
+  free(cells);
+  free(staticCells);
+  free(fullCells);
+}
+
+int main(int argc, char ** argv) {
+  static const uint8_t counts[] = {1, 2, 5, 10, 20, 50};
+  uint32_t cellMm = argc > 1 ? strtoul(argv[1], 0, 0) : 20;
+  uint32_t numTicks = argc > 2 ? strtoul(argv[2], 0, 0) : 300;
+  uint32_t s;
+
+  printf("cell %u mm, range %u mm, %u ticks, %u cars x %u sensors\n\n",
+         cellMm, RANGE_MM, numTicks, NUM_CARS, NUM_SENSORS);
+  printf("%9s %9s %9s %9s %9s %7s %7s %6s %5s\n", "obstacles", "build ms",
+         "update ms", "cast ms", "dirty ms", "rays", "dirty", "max mm",
+         "diff");
+  for (s = 0; s < sizeof(counts) / sizeof(counts[0]); s++) {
+    bench(counts[s], cellMm, numTicks);
+  }
+  return 0;
+}
@@ -0,0 +1,63 @@
+/********** Philox.h **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Philox4x32-10 counter-based random number generator (Salmon et
+  al., "Parallel Random Numbers: As Easy as 1, 2, 3"). Each call maps a
+  (key, counter) pair to four independent 32-bit words with no state, so
+  a draw depends only on what it is for (run, tick, sensor), not on which
+  thread ran it or in what order. Header only, host tools.
+*/
+
+#ifndef PHILOX_H
+#define PHILOX_H
+
+#include <stdint.h>
+
+#define PHILOX_M0 0xD2511F53U
+#define PHILOX_M1 0xCD9E8D57U
+#define PHILOX_W0 0x9E3779B9U
+#define PHILOX_W1 0xBB67AE85U
+#define PHILOX_ROUNDS 10
+
+struct philox_ctr {
+  uint32_t v[4];
+};
+
+struct philox_key {
+  uint32_t v[2];
+};
+
+/**
+ * Philox_Generate
+ * Runs the ten Philox rounds on ctr under key.
+ * Input: counter and key
+ * Output: four uniformly distributed 32-bit words
+ */
+static inline struct philox_ctr Philox_Generate(struct philox_ctr ctr,
+                                                struct philox_key key) {
+  int i;
+  for (i = 0; i < PHILOX_ROUNDS; i++) {
+    uint64_t p0 = (uint64_t)PHILOX_M0 * ctr.v[0];
+    uint64_t p1 = (uint64_t)PHILOX_M1 * ctr.v[2];
+    struct philox_ctr next;
+    next.v[0] = (uint32_t)(p1 >> 32) ^ ctr.v[1] ^ key.v[0];
+    next.v[1] = (uint32_t)p1;
+    next.v[2] = (uint32_t)(p0 >> 32) ^ ctr.v[3] ^ key.v[1];
+    next.v[3] = (uint32_t)p0;
+    ctr = next;
+    key.v[0] += PHILOX_W0;
+    key.v[1] += PHILOX_W1;
+  }
+  return ctr;
+}
+
+/**
+ * Philox_Uniform
+ * Maps a random word to a double in (0, 1]. Never 0, so it is safe to log.
+ */
+static inline double Philox_Uniform(uint32_t word) {
+  return ((double)word + 1.0) * (1.0 / 4294967296.0);
+}
+
+#endif // PHILOX_H
@@ -0,0 +1,48 @@
+/********** PingController.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Example controller for HilController.h, the same policy as
+  VirtualBoard_DefaultController: drive forward at full speed and steer
+  toward whichever side Ping sees more room on. Link a different file
+  defining hil_controller_step to run another control law.
+*/
+
+#include "HilController.h"
+#include "Simulator.h"
+
+// Echo cycles per mm of distance, see USSensor_PeriodFromMM.
+#define PING_CYCLES_PER_MM 462
+
+// Side clearance difference, in mm, before steering.
+#define STEER_THRESHOLD_MM 200
+
+// Servo duties ServoActuator bins as left, straight and right.
+#define SERVO_LEFT_DUTY 90
+#define SERVO_STRAIGHT_DUTY 30
+#define SERVO_RIGHT_DUTY 0
+
+// With DIFF_DRIVE, the inside wheel's motor duty in a turn.
+#define INSIDE_WHEEL_DUTY 500
+
+void hil_controller_step(const struct sensor_readings * in,
+                         struct actuator_out * out) {
+  uint32_t left = in->pingPeriod[1] / PING_CYCLES_PER_MM;
+  uint32_t right = in->pingPeriod[2] / PING_CYCLES_PER_MM;
+
+#ifdef DIFF_DRIVE
+  // PB7 drives the left wheel and PB6 the right, slow the inside one.
+  out->pb7Duty = left > right + STEER_THRESHOLD_MM ? INSIDE_WHEEL_DUTY : 1000;
+  out->pb6Duty = right > left + STEER_THRESHOLD_MM ? INSIDE_WHEEL_DUTY : 1000;
+#else
+  out->pb7Duty = 1000; // PB7 full, PB6 off: forward
+  out->pb6Duty = 0;
+#endif
+  if (left > right + STEER_THRESHOLD_MM) {
+    out->servoDuty = SERVO_LEFT_DUTY;
+  } else if (right > left + STEER_THRESHOLD_MM) {
+    out->servoDuty = SERVO_RIGHT_DUTY;
+  } else {
+    out->servoDuty = SERVO_STRAIGHT_DUTY;
+  }
+}
@@ -0,0 +1,159 @@
+/********** PoseTableBench.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host benchmark for PoseTable on the HILMain track. Builds the
+  table, then for random poses inside the track compares a 7-sensor
+  Simulator_UpdateSensors with the table against casting every ray:
+  time per update, how many rays the table answered, and the error of
+  those answers against the exact raycast.
+  Build: gcc -O2 -pthread -DPOSE_TABLE -DSIM_THREADED -I.. PoseTableBench.c ../PoseTable.c \
+          ../Simulator.c ../TrackSDF.c ../isqrt.c -lm -o PoseTableBench
+  Run:   PoseTableBench [cell mm] [threads]
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Simulator.h"
+#include "PoseTable.h"
+
+#define NUM_SENSORS 7
+#define NUM_POSES 200000
+#define TABLE_PATH "/tmp/posetable_bench.bin"
+
+// Open floor of the HILMain track, 20 mm in from the walls
+struct rect {
+  uint32_t minX, minY, maxX, maxY;
+};
+static const struct rect Floor[] = {
+  {1020, 20, 1980, 1480},
+  {1980, 520, 2480, 1480},
+  {2520, 520, 2980, 4980},
+};
+
+static uint32_t RandState = 12345;
+
+static uint32_t randBelow(uint32_t n) {
+  // xorshift32
+  RandState ^= RandState << 13;
+  RandState ^= RandState >> 17;
+  RandState ^= RandState << 5;
+  return RandState % n;
+}
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+static int compareU32(const void * a, const void * b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+static double updateAll(struct car * car, struct environment * env,
+                        uint32_t (*poses)[3], uint32_t (*vals)[NUM_SENSORS]) {
+  double t0 = now();
+  uint32_t p, s;
+  for (p = 0; p < NUM_POSES; p++) {
+    car->x = poses[p][0];
+    car->y = poses[p][1];
+    car->dir = poses[p][2];
+    car->sensorCacheValid = 0;
+    Simulator_UpdateSensors(car, env);
+    for (s = 0; s < NUM_SENSORS; s++) {
+      vals[p][s] = car->sensors[s].val;
+    }
+  }
+  return (now() - t0) * 1e9 / NUM_POSES;
+}
+
+int main(int argc, char ** argv) {
+  static uint32_t poses[NUM_POSES][3];
+  static uint32_t exact[NUM_POSES][NUM_SENSORS];
+  static uint32_t table[NUM_POSES][NUM_SENSORS];
+  static uint32_t errors[NUM_POSES * NUM_SENSORS];
+  static const uint16_t sensorDirs[NUM_SENSORS] = {0, 90, 270, 90, 270, 15, 345};
+  struct wall walls[6] = {
+    {1000, 0, 1000, 1500},
+    {2000, 0, 2000, 500},
+    {1000, 1500, 2500, 1500},
+    {2000, 500, 3000, 500},
+    {2500, 1500, 2500, 5000},
+    {3000, 500, 3000, 5000},
+  };
+  struct environment env = {2000, 6, walls, 0, 0};
+  struct sensor sensors[NUM_SENSORS] = {{0}};
+  struct car car = {0};
+  struct pose_table pt;
+  uint32_t cellMm = argc > 1 ? strtoul(argv[1], 0, 0) : 20;
+  uint32_t threads = argc > 2 ? strtoul(argv[2], 0, 0) : 1;
+  uint64_t fileBytes, rawBytes;
+  uint32_t p, s, numErrors = 0, mismatched = 0;
+  double t0, buildS, exactNs, tableNs;
+  ErrorCode_t err;
+
+  t0 = now();
+  err = PoseTable_Build(&env, 1500, 1, cellMm, threads, TABLE_PATH);
+  buildS = now() - t0;
+  if (err != E_SUCCESS || PoseTable_Open(&pt, TABLE_PATH, &env) != E_SUCCESS) {
+    printf("table build failed: %d\n", err);
+    return 1;
+  }
+  fileBytes = PoseTable_Bytes(&pt, &rawBytes);
+
+  for (s = 0; s < NUM_SENSORS; s++) {
+    sensors[s].dir = sensorDirs[s];
+    sensors[s].hitWall = SENSOR_NO_WALL;
+  }
+  car.numSensors = NUM_SENSORS;
+  car.sensors = sensors;
+  for (p = 0; p < NUM_POSES; p++) {
+    const struct rect * r = &Floor[randBelow(3)];
+    poses[p][0] = r->minX + randBelow(r->maxX - r->minX);
+    poses[p][1] = r->minY + randBelow(r->maxY - r->minY);
+    poses[p][2] = randBelow(360);
+  }
+
+  exactNs = updateAll(&car, &env, poses, exact);
+  env.poseTable = &pt;
+  tableNs = updateAll(&car, &env, poses, table);
+
+  // Rays the table answered are the ones not cast; recount with it off.
+  for (p = 0; p < NUM_POSES; p++) {
+    for (s = 0; s < NUM_SENSORS; s++) {
+      uint32_t d;
+      uint16_t absDir = (poses[p][2] + sensorDirs[s]) % 360;
+      if (!PoseTable_Lookup(&pt, poses[p][0], poses[p][1], absDir, &d)) {
+        continue;
+      }
+      if ((d == MAX_U32INT) != (exact[p][s] == MAX_U32INT)) {
+        mismatched++;
+      } else if (d != MAX_U32INT) {
+        errors[numErrors++] = d > exact[p][s] ? d - exact[p][s] :
+                                                exact[p][s] - d;
+      }
+    }
+  }
+  qsort(errors, numErrors, sizeof(errors[0]), compareU32);
+
+  printf("cell %u mm, %u build threads, %u poses x %u sensors\n", cellMm,
+         threads, NUM_POSES, NUM_SENSORS);
+  printf("build %.2f s, file %.1f MB (raw 16-bit %.1f MB, %.1fx)\n", buildS,
+         fileBytes / 1e6, rawBytes / 1e6, (double)rawBytes / fileBytes);
+  printf("update: raycast %.0f ns, table %.0f ns\n", exactNs, tableNs);
+  printf("table answered %.1f%% of rays, hit/miss mismatches %u\n",
+         100.0 * (numErrors + mismatched) / (NUM_POSES * NUM_SENSORS),
+         mismatched);
+  if (numErrors) {
+    printf("abs error mm: p50 %u, p99 %u, p99.9 %u, max %u\n",
+           errors[numErrors / 2], errors[(uint64_t)numErrors * 99 / 100],
+           errors[(uint64_t)numErrors * 999 / 1000], errors[numErrors - 1]);
+  }
+  PoseTable_Close(&pt);
+  return 0;
+}
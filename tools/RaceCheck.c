@@ -0,0 +1,185 @@
+/********** RaceCheck.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host check of Race gate crossing and timing. A ring circuit
+  1 m in radius with four gates across it every quarter turn, the last at
+  the start/finish. The car drives the exact circle at 1112 mm/s
+  counterclockwise, its pose rounded to the mm every sim step, for steps
+  from 1 to 250 ms, and each split time is compared against the exact
+  crossing time. Then the car backs over a gate and drives on, which must
+  flag it as wrong way and count the gate once, and drives outside a gate's
+  ends, which must not count. Prints each failure and a total.
+  Build: gcc -O2 -I.. RaceCheck.c ../Race.c -lm -o RaceCheck
+  Run:   RaceCheck
+*/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "Race.h"
+
+#define CX 5000
+#define CY 5000
+#define RADIUS 1000
+#define HALF_WIDTH 200 // track is RADIUS +- HALF_WIDTH
+#define VEL 1112
+#define NUM_LAPS 2
+#define NUM_GATES 4
+#define START_DEG 10 // car starts this far past the start/finish
+
+static struct gate Gates[NUM_GATES];
+static uint32_t NumChecks, NumFailed;
+
+static void check(int ok, const char * what, uint32_t got,
+                  uint32_t expected) {
+  NumChecks++;
+  if (!ok) {
+    NumFailed++;
+    printf("FAIL %s: got %u, expected %u\n", what, got, expected);
+  }
+}
+
+#define CHECK_EQ(what, got, expected) \
+  do { \
+    uint32_t got_ = (got); \
+    check(got_ == (expected), what, got_, expected); \
+  } while (0)
+
+/**
+ * Gate k is at (k + 1) quarter turns, from the inside of the ring (the
+ * car's left going counterclockwise) to the outside.
+ */
+static void initGates(void) {
+  uint8_t k;
+
+  for (k = 0; k < NUM_GATES; k++) {
+    double a = (k + 1) * M_PI / 2;
+    Gates[k].startX = lround(CX + (RADIUS - HALF_WIDTH) * cos(a));
+    Gates[k].startY = lround(CY + (RADIUS - HALF_WIDTH) * sin(a));
+    Gates[k].endX = lround(CX + (RADIUS + HALF_WIDTH) * cos(a));
+    Gates[k].endY = lround(CY + (RADIUS + HALF_WIDTH) * sin(a));
+  }
+}
+
+static void pointAt(double deg, double radius, uint32_t * x, uint32_t * y) {
+  *x = lround(CX + radius * cos(deg * M_PI / 180));
+  *y = lround(CY + radius * sin(deg * M_PI / 180));
+}
+
+/**
+ * Drives the race at step ms per tick. Returns the largest split time
+ * error, us.
+ */
+static uint32_t checkLaps(uint32_t step) {
+  struct race race;
+  double degPerUs = VEL * 180 / (M_PI * RADIUS) / 1e6;
+  uint32_t tickUs = step * 1000;
+  uint32_t x, y, prevX, prevY;
+  uint32_t t = 0;
+  uint32_t maxErr = 0;
+  uint32_t numSplits = 0;
+  enum race_event event = RACE_NONE;
+  char what[64];
+
+  Race_Init(&race, Gates, NUM_GATES, NUM_LAPS);
+  pointAt(START_DEG, RADIUS, &x, &y);
+  while (event != RACE_FINISHED && t < 60000000) {
+    prevX = x;
+    prevY = y;
+    pointAt(START_DEG + (t + tickUs) * degPerUs, RADIUS, &x, &y);
+    event = Race_Step(&race, prevX, prevY, x, y, t, tickUs);
+    t += tickUs;
+    if (event != RACE_NONE) {
+      // Gates are every 90 degrees from 90.
+      double exact = ((numSplits + 1) * 90 - START_DEG) / degPerUs;
+      uint32_t err = fabs(race.split.time - exact);
+      numSplits++;
+      maxErr = err > maxErr ? err : maxErr;
+      snprintf(what, sizeof(what), "%u ms split %u event", step, numSplits);
+      CHECK_EQ(what, race.split.event, numSplits == NUM_LAPS * NUM_GATES ?
+               RACE_FINISHED : numSplits % NUM_GATES ? RACE_SECTOR :
+               RACE_LAP);
+      snprintf(what, sizeof(what), "%u ms split %u gate", step, numSplits);
+      CHECK_EQ(what, race.split.gate, (numSplits - 1) % NUM_GATES);
+      snprintf(what, sizeof(what), "%u ms split %u lap", step, numSplits);
+      CHECK_EQ(what, race.split.lap, (numSplits - 1) / NUM_GATES + 1);
+    }
+  }
+  snprintf(what, sizeof(what), "%u ms splits", step);
+  CHECK_EQ(what, numSplits, NUM_LAPS * NUM_GATES);
+  return maxErr;
+}
+
+/**
+ * Moves from one angle to another on the ring in one 100 ms tick.
+ */
+static enum race_event move(struct race * race, double fromDeg, double toDeg,
+                            double radius, uint32_t * t) {
+  uint32_t prevX, prevY, x, y;
+
+  pointAt(fromDeg, radius, &prevX, &prevY);
+  pointAt(toDeg, radius, &x, &y);
+  *t += 100000;
+  return Race_Step(race, prevX, prevY, x, y, *t - 100000, 100000);
+}
+
+static void checkWrongWay(void) {
+  struct race race;
+  uint32_t t = 0;
+  uint32_t sectorStart;
+
+  Race_Init(&race, Gates, NUM_GATES, NUM_LAPS);
+  CHECK_EQ("forward over gate 0", move(&race, 85, 95, RADIUS, &t),
+           RACE_SECTOR);
+  sectorStart = race.sectorStart;
+  CHECK_EQ("forward over gate 1", move(&race, 175, 185, RADIUS, &t),
+           RACE_SECTOR);
+  CHECK_EQ("back over gate 1", move(&race, 185, 175, RADIUS, &t),
+           RACE_WRONG_WAY);
+  CHECK_EQ("back over gate 1, gate", race.split.gate, 1);
+  CHECK_EQ("back over gate 1, flagged", race.wrongWay, 1);
+  CHECK_EQ("back over gate 1, sector restored", race.sectorStart,
+           sectorStart);
+  CHECK_EQ("back over gate 0 again, not tested",
+           move(&race, 95, 85, RADIUS, &t), RACE_NONE);
+  CHECK_EQ("forward over gate 0 again, not counted",
+           move(&race, 85, 95, RADIUS, &t), RACE_NONE);
+  CHECK_EQ("forward over gate 1 again", move(&race, 175, 185, RADIUS, &t),
+           RACE_SECTOR);
+  CHECK_EQ("forward over gate 1 again, gate", race.split.gate, 1);
+  CHECK_EQ("forward over gate 1 again, cleared", race.wrongWay, 0);
+
+  // Past the gates' outer ends and inside their inner ends.
+  CHECK_EQ("outside gate 2", move(&race, 265, 275, RADIUS + 2 * HALF_WIDTH,
+           &t), RACE_NONE);
+  CHECK_EQ("inside gate 2", move(&race, 265, 275, RADIUS - 2 * HALF_WIDTH,
+           &t), RACE_NONE);
+  CHECK_EQ("through gate 2", move(&race, 265, 275, RADIUS, &t),
+           RACE_SECTOR);
+
+  // Backing over the start/finish undoes the lap.
+  CHECK_EQ("forward over finish", move(&race, 355, 365, RADIUS, &t),
+           RACE_LAP);
+  CHECK_EQ("back over finish", move(&race, 365, 355, RADIUS, &t),
+           RACE_WRONG_WAY);
+  CHECK_EQ("back over finish, lap undone", race.lapsDone, 0);
+  CHECK_EQ("forward over finish again", move(&race, 355, 365, RADIUS, &t),
+           RACE_LAP);
+  CHECK_EQ("forward over finish again, lap", race.lapsDone, 1);
+}
+
+int main(void) {
+  static const uint32_t steps[] = {1, 10, 50, 100, 250};
+  uint32_t k;
+
+  initGates();
+  printf("step ms,max split error us\n");
+  for (k = 0; k < sizeof(steps) / sizeof(steps[0]); k++) {
+    printf("%u,%u\n", steps[k], checkLaps(steps[k]));
+  }
+  checkWrongWay();
+
+  printf("%u checks, %u failed\n", NumChecks, NumFailed);
+  return NumFailed != 0;
+}
@@ -0,0 +1,429 @@
+/********** SchedCheck.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Randomized property check of the scheduler against the host
+  backend (OSHost.c). For each seed, a fresh OS runs worker threads at
+  random priorities that take turns drawing the next call from Philox keyed
+  by the seed, with the step number as counter:
+   OS_Suspend, OS_Sleep, OS_Wait, OS_Signal, OS_MutexLock, OS_MutexUnlock,
+   OS_AddThread, OS_Kill, and a SysTick (SIGALRM raised in place).
+  A driver thread just above idle runs whenever every worker is blocked or
+  asleep, and ticks, signals, or adds a worker. The real interval timer is
+  stopped at the first step, so only drawn ticks preempt and a seed replays
+  the same way every time.
+
+  Mutexes are locked in index order and threads holding one aren't killed,
+  the rules the firmware follows, so runs can't deadlock. Before every step
+  the running thread checks:
+   - OSHost_CheckScheduler (ready and sleep lists). OSHost also fails
+     any switch that rotates a ready list the running thread isn't the
+     head of.
+   - It is at the highest ready priority, unless nothing has switched
+     since a SysTick skipped its switch for CS_Ignore or a higher priority
+     thread was added, which the firmware lets wait for the next slice.
+   - Every live thread's priority is the highest of its base priority and
+     the waiters on each mutex it owns.
+   - Each mutex is free with no waiters, or owned by a live thread whose
+     held list has it, and held lists have nothing else.
+  Each seed runs in its own process since OS_Launch doesn't return. Prints
+  each failure and a total.
+  Build: gcc -O2 -DHOST_BUILD -I.. SchedCheck.c ../OS.c ../OSAux.c \
+          ../OSHost.c ../ServiceCalls.c ../getHighest.c ../StackPool.c \
+          ../Trace.c ../unitConvert.c ../Profiler.c -o SchedCheck
+  Run:   SchedCheck -n 200 -s 5000
+  Add -DTICKLESS to the build to check tickless SysTick.
+*/
+
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#include "OS.h"
+#include "OSHost.h"
+#include "getHighest.h"
+#include "terminal.h"
+#include "Philox.h"
+
+#define NUM_SEMAS 3
+#define NUM_MUTEXES 4
+#define MAX_WORKERS 12
+#define DRIVER_PRIORITY (IDLE_PRIORITY - 1)
+#define NUM_WORKER_PRIORITIES DRIVER_PRIORITY // 0 to DRIVER_PRIORITY - 1
+#define STACK_SIZE 256
+#define NO_MUTEX 0xFF
+
+enum op {
+  OP_SUSPEND,
+  OP_SLEEP,
+  OP_WAIT,
+  OP_SIGNAL,
+  OP_LOCK,
+  OP_UNLOCK,
+  OP_ADD,
+  OP_KILL,
+  OP_TICK,
+  NUM_OPS
+};
+
+// Relative odds of each op for workers.
+static const uint8_t OpWeights[NUM_OPS] = {3, 2, 2, 2, 5, 5, 1, 1, 3};
+
+struct worker {
+  uint8_t alive;
+  uint8_t base;
+  uint8_t held; // mutex bits, set once OS_MutexLock returns
+  uint8_t wanting; // mutex being locked, NO_MUTEX if none
+};
+
+struct seed_result {
+  uint32_t checks;
+  uint32_t failed;
+};
+
+extern TCB_t TCBs[MAX_THREADS];
+extern TCB_t * ReadyThreads[NUM_PRIORITY_LEVELS];
+extern TCB_t * InactiveThreads;
+extern TCB_t * Current_Thread;
+extern uint32_t CS_Ignore;
+extern uint32_t Systick_Calls;
+
+static Sema4Type Semas[NUM_SEMAS];
+static Sema4Type Mutexes[NUM_MUTEXES];
+static struct worker Workers[MAX_THREADS];
+static uint32_t NumWorkers;
+static struct philox_key Key;
+static uint32_t Step, NumSteps;
+static uint8_t TimerStopped;
+static TCB_t * LastThread; // ran the last step
+static uint8_t Lagging; // a higher priority thread may be ready
+static struct seed_result Result;
+static int ResultFd;
+
+static void worker(void);
+
+// What OS.c and friends print through, unused here except for fatal errors.
+void terminal_printString(char * msg) {}
+void terminal_printValueDec(uint32_t value) {}
+void terminal_printValueHex(uint32_t value) {}
+
+static void finish(int status) {
+  fflush(stdout);
+  if (write(ResultFd, &Result, sizeof(Result)) != sizeof(Result)) {
+    status = 1;
+  }
+  _exit(status);
+}
+
+/**
+ * The scheduler checks end a seed through here.
+ */
+void terminal_fatalErrorHandler(ErrorCode_t errorCode, char * errorMessage) {
+  Result.checks++;
+  Result.failed++;
+  printf("FAIL seed %u step %u: %s\n", Key.v[0], Step, errorMessage);
+  finish(1);
+}
+
+static void check(int ok, const char * what, uint32_t got,
+                  uint32_t expected) {
+  Result.checks++;
+  if (!ok) {
+    Result.failed++;
+    printf("FAIL seed %u step %u: %s: got %u, expected %u\n", Key.v[0], Step,
+           what, got, expected);
+  }
+}
+
+#define CHECK_EQ(what, got, expected) \
+  do { \
+    uint32_t got_ = (got); \
+    check(got_ == (expected), what, got_, expected); \
+  } while (0)
+
+/**
+ * Draw for this step, uniform in 0 to n - 1. word picks one of the four
+ * Philox words so a step can make several draws.
+ */
+static uint32_t draw(uint8_t word, uint32_t n) {
+  struct philox_ctr ctr = {{Step, 0, 0, 0}};
+  return (uint64_t)Philox_Generate(ctr, Key).v[word] * n >> 32;
+}
+
+static void checkState(void) {
+  uint8_t owned[MAX_THREADS] = {0};
+  uint32_t t, m;
+
+  OSHost_CheckScheduler();
+  Result.checks++;
+  // Every switch goes to the highest ready thread.
+  if (Current_Thread != LastThread) {
+    Lagging = 0;
+    LastThread = Current_Thread;
+  }
+  if (!Lagging) {
+    CHECK_EQ("running thread's priority", Current_Thread->priority,
+             getHighestPriority());
+  }
+
+  for (m = 0; m < NUM_MUTEXES; m++) {
+    TCB_t * owner = Mutexes[m].owner;
+    if (owner == 0) {
+      CHECK_EQ("free mutex waiters", Mutexes[m].priorityWaiting, 0);
+      CHECK_EQ("free mutex value", Mutexes[m].Value, 1);
+      continue;
+    }
+    CHECK_EQ("mutex owner alive", Workers[owner->tid].alive, 1);
+    owned[owner->tid] |= 1 << m;
+  }
+
+  for (t = 0; t < MAX_THREADS; t++) {
+    struct worker * w = &Workers[t];
+    Sema4Type * held;
+    uint8_t expected, listed = 0;
+
+    if (!w->alive) {
+      continue;
+    }
+    expected = w->base;
+    for (held = TCBs[t].heldMutexes; held != 0; held = held->nextHeld) {
+      m = held - Mutexes;
+      if (m >= NUM_MUTEXES || (listed & 1 << m)) {
+        check(0, "held list entry", m, NUM_MUTEXES);
+        break;
+      }
+      listed |= 1 << m;
+      if (held->priorityWaiting &&
+          getHighestPriorityOf(held->priorityWaiting) < expected) {
+        expected = getHighestPriorityOf(held->priorityWaiting);
+      }
+    }
+    CHECK_EQ("held list matches owners", listed, owned[t]);
+    CHECK_EQ("inherited priority", TCBs[t].priority, expected);
+    // Ownership passes to a waiter before its OS_MutexLock returns.
+    CHECK_EQ("owned mutexes were locked",
+             owned[t] & ~(w->held | (w->wanting == NO_MUTEX ? 0 :
+                                     1 << w->wanting)), 0);
+    CHECK_EQ("locked mutexes are owned", w->held & ~owned[t], 0);
+  }
+}
+
+/**
+ * Adds a worker at a drawn priority. OS_AddThread takes the head of the
+ * inactive list and doesn't yield, so the new tid is known beforehand.
+ */
+static void addWorker(void) {
+  uint8_t tid;
+
+  if (NumWorkers == MAX_WORKERS || InactiveThreads == 0) {
+    return;
+  }
+  tid = InactiveThreads->tid;
+  Workers[tid].base = draw(2, NUM_WORKER_PRIORITIES);
+  Workers[tid].held = 0;
+  Workers[tid].wanting = NO_MUTEX;
+  Workers[tid].alive = 1;
+  if (OS_AddThread(worker, STACK_SIZE, Workers[tid].base)) {
+    NumWorkers++;
+    // OS_AddThread doesn't yield. No thread runs yet before launch.
+    Lagging |= Current_Thread != 0 &&
+               Workers[tid].base < Current_Thread->priority;
+  } else {
+    Workers[tid].alive = 0;
+  }
+}
+
+/**
+ * Raises one SysTick. If it ran the scheduler but CS_Ignore skipped the
+ * switch, a thread it woke may be waiting, otherwise the switch (if any)
+ * went to the highest ready thread.
+ */
+static void tick(void) {
+  uint32_t ignore = CS_Ignore;
+  uint32_t calls = Systick_Calls;
+
+  raise(SIGALRM);
+  if (Systick_Calls != calls) { // not a tickless skipped slice
+    Lagging = ignore;
+  }
+}
+
+/**
+ * Checks, then counts the step. Ends the seed after the last one.
+ */
+static void startStep(void) {
+  if (!TimerStopped) {
+    OS_Disable();
+    TimerStopped = 1;
+  }
+  checkState();
+  if (++Step >= NumSteps) {
+    finish(Result.failed != 0);
+  }
+}
+
+static void worker(void) {
+  struct worker * w;
+  uint32_t total, pick, op, m;
+
+  for (total = 0, op = 0; op < NUM_OPS; op++) {
+    total += OpWeights[op];
+  }
+  while (1) {
+    startStep();
+    w = &Workers[Current_Thread->tid];
+    pick = draw(0, total);
+    for (op = 0; pick >= OpWeights[op]; op++) {
+      pick -= OpWeights[op];
+    }
+
+    switch (op) {
+      case OP_SUSPEND:
+        OS_Suspend();
+        break;
+      case OP_SLEEP:
+        OS_Sleep(1 + draw(1, 3));
+        break;
+      case OP_WAIT:
+        OS_Wait(&Semas[draw(1, NUM_SEMAS)]);
+        break;
+      case OP_SIGNAL:
+        OS_Signal(&Semas[draw(1, NUM_SEMAS)]);
+        break;
+      case OP_LOCK:
+        // Only above the highest mutex held, so there is a lock order.
+        for (m = NUM_MUTEXES; m > 0 && !(w->held & 1 << (m - 1)); m--) {
+        }
+        if (m == NUM_MUTEXES) {
+          break;
+        }
+        m += draw(1, NUM_MUTEXES - m);
+        w->wanting = m;
+        OS_MutexLock(&Mutexes[m]);
+        w->held |= 1 << m;
+        w->wanting = NO_MUTEX;
+        break;
+      case OP_UNLOCK:
+        // Any held mutex, not just the last locked.
+        if (w->held == 0) {
+          break;
+        }
+        for (m = draw(1, NUM_MUTEXES); !(w->held & 1 << m);
+             m = (m + 1) % NUM_MUTEXES) {
+        }
+        w->held &= ~(1 << m);
+        OS_MutexUnlock(&Mutexes[m]);
+        break;
+      case OP_ADD:
+        addWorker();
+        break;
+      case OP_KILL:
+        if (w->held != 0 || NumWorkers == 1) {
+          break;
+        }
+        w->alive = 0;
+        NumWorkers--;
+        OS_Kill();
+        break;
+      case OP_TICK:
+        tick();
+        break;
+    }
+  }
+}
+
+/**
+ * Runs only when every worker is blocked or asleep, so it never blocks.
+ */
+static void driver(void) {
+  while (1) {
+    startStep();
+    switch (draw(0, 4)) {
+      case 0:
+        OS_Signal(&Semas[draw(1, NUM_SEMAS)]);
+        break;
+      case 1:
+        addWorker();
+        break;
+      default:
+        tick();
+        break;
+    }
+  }
+}
+
+static void runSeed(uint32_t seed) {
+  uint32_t i;
+
+  Key.v[0] = seed;
+  Key.v[1] = 0;
+  OS_Init();
+  for (i = 0; i < NUM_SEMAS; i++) {
+    OS_InitSemaphore(&Semas[i], 0);
+  }
+  for (i = 0; i < NUM_MUTEXES; i++) {
+    OS_InitSemaphore(&Mutexes[i], 1);
+  }
+  // Idle and driver have fixed priorities and never lock.
+  Workers[InactiveThreads->tid].alive = 1;
+  Workers[InactiveThreads->tid].base = DRIVER_PRIORITY;
+  Workers[InactiveThreads->tid].wanting = NO_MUTEX;
+  OS_AddThread(driver, STACK_SIZE, DRIVER_PRIORITY);
+  for (i = 0; i < 4; i++) {
+    Step = i; // a different draw for each
+    addWorker();
+  }
+  Step = 0;
+  OS_Launch(TIME_1MS);
+}
+
+static void usage(const char * name) {
+  fprintf(stderr, "usage: %s [-n seeds] [-k first seed] [-s steps]\n", name);
+  exit(1);
+}
+
+int main(int argc, char ** argv) {
+  uint32_t numSeeds = 200, firstSeed = 1, seed;
+  uint32_t checks = 0, failed = 0;
+  struct seed_result result;
+  int fds[2], status, opt;
+
+  NumSteps = 5000;
+  while ((opt = getopt(argc, argv, "n:k:s:")) != -1) {
+    switch (opt) {
+      case 'n': numSeeds = strtoul(optarg, 0, 0); break;
+      case 'k': firstSeed = strtoul(optarg, 0, 0); break;
+      case 's': NumSteps = strtoul(optarg, 0, 0); break;
+      default: usage(argv[0]);
+    }
+  }
+
+  for (seed = firstSeed; seed < firstSeed + numSeeds; seed++) {
+    if (pipe(fds) != 0) {
+      perror("pipe");
+      return 1;
+    }
+    fflush(stdout);
+    if (fork() == 0) {
+      close(fds[0]);
+      ResultFd = fds[1];
+      runSeed(seed);
+    }
+    close(fds[1]);
+    if (read(fds[0], &result, sizeof(result)) != sizeof(result)) {
+      printf("FAIL seed %u: ended without a result\n", seed);
+      result.checks = 1;
+      result.failed = 1;
+    }
+    close(fds[0]);
+    wait(&status);
+    checks += result.checks;
+    failed += result.failed;
+  }
+
+  printf("%u seeds, %u steps each\n", numSeeds, NumSteps);
+  printf("%u checks, %u failed\n", checks, failed);
+  return failed != 0;
+}
@@ -0,0 +1,196 @@
+/********** SdfBench.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host benchmark for TrackSDF. For the HILMain track and random
+  tracks of 50 to 5000 walls, prints distance field memory and build time,
+  clearance lookup cost and worst error against brute force distance, and
+  Simulator_HitWall cost with and without the field for random 100 mm
+  moves, and how often the field couldn't rule out a hit (exact%). Any
+  collision result that differs between the two is counted (diff).
+  Build: gcc -O2 -I.. SdfBench.c ../TrackSDF.c ../Simulator.c ../isqrt.c -lm -o SdfBench
+  Run:   SdfBench [cell mm]
+*/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Simulator.h"
+#include "TrackSDF.h"
+
+#define FIELD_MM 10000 // random tracks are placed in a 10 x 10 m square
+#define NUM_SAMPLES 200000
+#define MOVE_MM 100 // 1 m/s for one sim tick
+
+static uint32_t RandState = 12345;
+
+static uint32_t randBelow(uint32_t n) {
+  // xorshift32
+  RandState ^= RandState << 13;
+  RandState ^= RandState >> 17;
+  RandState ^= RandState << 5;
+  return RandState % n;
+}
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/**
+ * Exact distance from (x, y) to the nearest wall, checking every wall.
+ */
+static double bruteDistance(struct environment * env, double x, double y) {
+  double best = 1e18;
+  uint16_t k;
+  for (k = 0; k < env->numWalls; k++) {
+    struct wall * w = &env->walls[k];
+    double dx = (double)w->endX - w->startX;
+    double dy = (double)w->endY - w->startY;
+    double lenSq = dx * dx + dy * dy;
+    double t = lenSq > 0 ? ((x - w->startX) * dx + (y - w->startY) * dy) / lenSq
+                         : 0;
+    double cx, cy, d;
+    t = t < 0 ? 0 : (t > 1 ? 1 : t);
+    cx = w->startX + t * dx;
+    cy = w->startY + t * dy;
+    d = (x - cx) * (x - cx) + (y - cy) * (y - cy);
+    best = d < best ? d : best;
+  }
+  return sqrt(best);
+}
+
+/**
+ * Axis-aligned walls 100 - 1000 mm long, the only kind getSegmentIntersection
+ * handles.
+ */
+static void randomWalls(struct wall * walls, uint16_t numWalls) {
+  uint16_t k;
+  for (k = 0; k < numWalls; k++) {
+    uint32_t len = 100 + randBelow(900);
+    walls[k].startX = 1 + randBelow(FIELD_MM - 1000);
+    walls[k].startY = 1 + randBelow(FIELD_MM - 1000);
+    walls[k].endX = walls[k].startX;
+    walls[k].endY = walls[k].startY;
+    if (randBelow(2)) {
+      walls[k].endX += len;
+    } else {
+      walls[k].endY += len;
+    }
+  }
+}
+
+static void benchTrack(const char * name, struct environment * env,
+                       uint32_t cellMm) {
+  static uint32_t points[NUM_SAMPLES][4];
+  struct track_sdf sdf;
+  uint32_t numCells = TrackSDF_Cells(env, cellMm);
+  uint16_t * cells = malloc(numCells * sizeof(uint16_t));
+  double t0, buildMs, lookupNs, scanNs, sdfNs, maxError = 0;
+  volatile uint32_t sink = 0;
+  uint32_t i, mismatches = 0, fallbacks = 0;
+  uint32_t maxX, maxY;
+
+  t0 = now();
+  if (!cells || TrackSDF_Build(&sdf, env, cells, numCells, cellMm) !=
+      E_SUCCESS) {
+    printf("%-10s build failed\n", name);
+    free(cells);
+    return;
+  }
+  buildMs = (now() - t0) * 1e3;
+  maxX = (sdf.width - 1) * cellMm;
+  maxY = (sdf.height - 1) * cellMm;
+
+  // Random moves inside the grid, away from the boundary.
+  for (i = 0; i < NUM_SAMPLES; i++) {
+    uint32_t dir = randBelow(360);
+    points[i][0] = MOVE_MM + randBelow(maxX - 2 * MOVE_MM);
+    points[i][1] = MOVE_MM + randBelow(maxY - 2 * MOVE_MM);
+    points[i][2] = points[i][0] + MOVE_MM * cos(dir * M_PI / 180);
+    points[i][3] = points[i][1] + MOVE_MM * sin(dir * M_PI / 180);
+  }
+
+  for (i = 0; i < NUM_SAMPLES / 20; i++) {
+    double error = fabs(TrackSDF_Clearance(&sdf, points[i][0], points[i][1]) -
+                        bruteDistance(env, points[i][0], points[i][1]));
+    maxError = error > maxError ? error : maxError;
+  }
+
+  t0 = now();
+  for (i = 0; i < NUM_SAMPLES; i++) {
+    sink += TrackSDF_Clearance(&sdf, points[i][0], points[i][1]);
+  }
+  lookupNs = (now() - t0) * 1e9 / NUM_SAMPLES;
+
+  env->sdf = 0;
+  t0 = now();
+  for (i = 0; i < NUM_SAMPLES; i++) {
+    sink += Simulator_HitWall(env, points[i][0], points[i][1], points[i][2],
+                              points[i][3]);
+  }
+  scanNs = (now() - t0) * 1e9 / NUM_SAMPLES;
+
+  env->sdf = &sdf;
+  t0 = now();
+  for (i = 0; i < NUM_SAMPLES; i++) {
+    sink += Simulator_HitWall(env, points[i][0], points[i][1], points[i][2],
+                              points[i][3]);
+  }
+  sdfNs = (now() - t0) * 1e9 / NUM_SAMPLES;
+
+  for (i = 0; i < NUM_SAMPLES; i++) {
+    uint8_t exact, fast;
+    env->sdf = 0;
+    exact = Simulator_HitWall(env, points[i][0], points[i][1], points[i][2],
+                              points[i][3]);
+    env->sdf = &sdf;
+    fast = Simulator_HitWall(env, points[i][0], points[i][1], points[i][2],
+                             points[i][3]);
+    mismatches += exact != fast;
+    fallbacks += !TrackSDF_IsClear(&sdf, (points[i][0] + points[i][2]) / 2,
+                                   (points[i][1] + points[i][3]) / 2,
+                                   MOVE_MM / 2 + 2);
+  }
+  env->sdf = 0;
+
+  printf("%-10s %6u %9u %9.1f %8.1f %8.1f %6u %8.1f %8.1f %8.1f %6.1f %5u\n", name,
+         env->numWalls, numCells, numCells * 2 / 1024.0, buildMs, lookupNs,
+         TrackSDF_Error(&sdf), maxError, scanNs, sdfNs,
+         100.0 * fallbacks / NUM_SAMPLES, mismatches);
+  free(cells);
+}
+
+int main(int argc, char ** argv) {
+  static struct wall walls[5000];
+  static const uint16_t sizes[] = {50, 500, 5000};
+  struct environment env = {0};
+  uint32_t cellMm = argc > 1 ? strtoul(argv[1], 0, 0) : 10;
+  uint32_t s;
+
+  printf("cell %u mm, %u samples\n\n", cellMm, NUM_SAMPLES);
+  printf("%-10s %6s %9s %9s %8s %8s %6s %8s %8s %8s %6s %5s\n", "track",
+         "walls", "cells", "KB", "build ms", "look ns", "bound", "max err",
+         "scan ns", "sdf ns", "exact%", "diff");
+
+  // HILMain initObjects track
+  walls[0] = (struct wall){1000, 0, 1000, 1500};
+  walls[1] = (struct wall){2000, 0, 2000, 500};
+  walls[2] = (struct wall){1000, 1500, 2500, 1500};
+  walls[3] = (struct wall){2000, 500, 3000, 500};
+  walls[4] = (struct wall){2500, 1500, 2500, 5000};
+  walls[5] = (struct wall){3000, 500, 3000, 5000};
+  env.walls = walls;
+  env.numWalls = 6;
+  benchTrack("hil", &env, cellMm);
+
+  for (s = 0; s < sizeof(sizes) / sizeof(sizes[0]); s++) {
+    randomWalls(walls, sizes[s]);
+    env.numWalls = sizes[s];
+    benchTrack("random", &env, cellMm);
+  }
+  return 0;
+}
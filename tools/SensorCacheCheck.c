@@ -0,0 +1,226 @@
+/********** SensorCacheCheck.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host differential check of the sensor hit cache. Tracks are
+  winding corridors 600 mm wide, two walls per 500 mm, from 16 to 1024
+  walls long. On each, a car with the HIL's 7 sensors random walks up and
+  down the corridor, mostly within the cache's move and turn limits
+  (SENSOR_CACHE_MAX_MOVE_MM, SENSOR_CACHE_MAX_TURN_DEG), with one step in 20
+  a jump past them. After every step Simulator_UpdateSensors runs with the
+  cache, and again from the same pose with sensorCacheValid = 0, so no
+  sensor tests its last hit wall first. Each sensor val must match the
+  uncached one bit for bit, and both must match a scan of every wall with
+  no pruning. Prints wall tests per ray for the cached and uncached paths
+  on each track (the scan of every wall tests them all), each failure, and
+  a total.
+  Build: gcc -O2 -I.. SensorCacheCheck.c ../Simulator.c ../TrackSDF.c \
+          ../isqrt.c -lm -o SensorCacheCheck
+  Run:   SensorCacheCheck [steps]
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "Simulator.h"
+
+#define NUM_SENSORS 7
+#define SEGMENT_MM 500 // corridor length per pair of walls
+#define HALF_WIDTH 300
+#define BASE_Y 5000 // corridor centerline wanders around this
+#define WANDER_MM 400
+#define MAX_WALLS 1024
+#define JUMP_ODDS 20 // one step in this many jumps past the cache limits
+#define TRIG_SCALE 10000
+
+extern int32_t SinLookup[360];
+extern int32_t CosLookup[360];
+
+static const uint32_t SensorDirs[NUM_SENSORS] = {0, 90, 270, 90, 270, 15, 345};
+static uint32_t RandState = 12345;
+static uint32_t NumChecks, NumFailed;
+static struct wall Walls[MAX_WALLS];
+static int32_t CenterY[MAX_WALLS / 2 + 1];
+
+// Simulator.c's intersection helpers, not in Simulator.h.
+uint8_t getSegmentIntersection(int32_t p0_x, int32_t p0_y, int32_t p1_x,
+                               int32_t p1_y, int32_t p2_x, int32_t p2_y,
+                               int32_t p3_x, int32_t p3_y, int32_t *i_x,
+                               int32_t *i_y);
+int32_t getDistanceBetweenPoints(int32_t x0, int32_t y0, int32_t x1,
+                                 int32_t y1);
+
+static uint32_t randBelow(uint32_t n) {
+  // xorshift32
+  RandState ^= RandState << 13;
+  RandState ^= RandState >> 17;
+  RandState ^= RandState << 5;
+  return RandState % n;
+}
+
+static int32_t randRange(int32_t lo, int32_t hi) {
+  return lo + (int32_t)randBelow(hi - lo + 1);
+}
+
+/**
+ * Corridor of numSegments segments along x, its centerline at a random
+ * height at each segment boundary. Both ends are left open, so rays down
+ * the corridor see walls far away. Returns the number of walls.
+ */
+static uint16_t buildTrack(uint16_t numSegments) {
+  uint16_t k, n = 0;
+
+  for (k = 0; k <= numSegments; k++) {
+    CenterY[k] = BASE_Y + randRange(-WANDER_MM, WANDER_MM);
+  }
+  for (k = 0; k < numSegments; k++) {
+    uint32_t x0 = (k + 1) * SEGMENT_MM;
+    uint32_t x1 = x0 + SEGMENT_MM;
+    Walls[n++] = (struct wall){x0, CenterY[k] + HALF_WIDTH,
+                               x1, CenterY[k + 1] + HALF_WIDTH};
+    Walls[n++] = (struct wall){x0, CenterY[k] - HALF_WIDTH,
+                               x1, CenterY[k + 1] - HALF_WIDTH};
+  }
+  return n;
+}
+
+/**
+ * Keeps the car inside the corridor, 50 mm from the walls at the segment
+ * boundaries it's between.
+ */
+static void clampToTrack(struct car * car, uint16_t numSegments) {
+  uint32_t minX = SEGMENT_MM + 1;
+  uint32_t maxX = (numSegments + 1) * SEGMENT_MM - 1;
+  uint16_t k;
+  int32_t lo, hi;
+
+  car->x = car->x < minX ? minX : car->x > maxX ? maxX : car->x;
+  k = car->x / SEGMENT_MM - 1;
+  lo = (CenterY[k] > CenterY[k + 1] ? CenterY[k] : CenterY[k + 1]) -
+       HALF_WIDTH + 50;
+  hi = (CenterY[k] < CenterY[k + 1] ? CenterY[k] : CenterY[k + 1]) +
+       HALF_WIDTH - 50;
+  car->y = (int32_t)car->y < lo ? lo : (int32_t)car->y > hi ? hi : car->y;
+}
+
+/**
+ * Distance along a sensor's ray to the closest wall, testing every wall,
+ * MAX_U32INT if none.
+ */
+static uint32_t scanEveryWall(const struct car * car,
+                              const struct environment * env,
+                              uint32_t sensorDir) {
+  uint32_t absDir = (car->dir + sensorDir) % 360;
+  int32_t endY = car->y + SinLookup[absDir]*MAX_SENSOR_LINE_OF_SIGHT/TRIG_SCALE;
+  int32_t endX = car->x + CosLookup[absDir]*MAX_SENSOR_LINE_OF_SIGHT/TRIG_SCALE;
+  uint32_t minDistance = MAX_U32INT;
+  uint32_t distance;
+  int32_t x, y;
+  uint16_t j;
+
+  for (j = 0; j < env->numWalls; j++) {
+    const struct wall * wall = &env->walls[j];
+    if (getSegmentIntersection(car->x, car->y, endX, endY, wall->startX,
+                               wall->startY, wall->endX, wall->endY, &x,
+                               &y)) {
+      distance = getDistanceBetweenPoints(car->x, car->y, x, y);
+      minDistance = distance < minDistance ? distance : minDistance;
+    }
+  }
+  return minDistance;
+}
+
+static void initCar(struct car * car, struct sensor * sensors) {
+  uint8_t i;
+
+  memset(car, 0, sizeof(*car));
+  for (i = 0; i < NUM_SENSORS; i++) {
+    sensors[i] = (struct sensor){i < 3 ? S_US : S_IR, SensorDirs[i], 0, 0,
+                                 SENSOR_NO_WALL};
+  }
+  car->numSensors = NUM_SENSORS;
+  car->sensors = sensors;
+}
+
+/**
+ * Random walks the car for numSteps on a track of numSegments segments and
+ * compares the cached, uncached and every wall scans.
+ */
+static void checkTrack(uint16_t numSegments, uint32_t numSteps) {
+  struct sensor sensors[NUM_SENSORS], fullSensors[NUM_SENSORS];
+  struct environment env;
+  struct car car, full;
+  uint64_t cachedRays = 0, cachedTests = 0, fullRays = 0, fullTests = 0;
+  uint32_t step, rays, tests;
+  uint8_t i;
+
+  memset(&env, 0, sizeof(env));
+  env.numWalls = buildTrack(numSegments);
+  env.walls = Walls;
+  initCar(&car, sensors);
+  initCar(&full, fullSensors);
+  car.x = SEGMENT_MM * (numSegments / 2 + 1);
+  car.y = BASE_Y;
+  car.dir = randBelow(360);
+
+  for (step = 0; step < numSteps; step++) {
+    uint32_t move = randBelow(JUMP_ODDS) ? SENSOR_CACHE_MAX_MOVE_MM :
+                                           4 * SENSOR_CACHE_MAX_MOVE_MM;
+    uint32_t turn = randBelow(JUMP_ODDS) ? SENSOR_CACHE_MAX_TURN_DEG : 180;
+
+    car.x += randRange(-(int32_t)move, move);
+    car.y += randRange(-(int32_t)move, move);
+    car.dir = (car.dir + 360 + randRange(-(int32_t)turn, turn)) % 360;
+    clampToTrack(&car, numSegments);
+
+    rays = NumRaysCast;
+    tests = NumWallTests;
+    Simulator_UpdateSensors(&car, &env);
+    cachedRays += NumRaysCast - rays;
+    cachedTests += NumWallTests - tests;
+
+    full.x = car.x;
+    full.y = car.y;
+    full.dir = car.dir;
+    full.sensorCacheValid = 0;
+    rays = NumRaysCast;
+    tests = NumWallTests;
+    Simulator_UpdateSensors(&full, &env);
+    fullRays += NumRaysCast - rays;
+    fullTests += NumWallTests - tests;
+
+    for (i = 0; i < NUM_SENSORS; i++) {
+      uint32_t every = scanEveryWall(&car, &env, SensorDirs[i]);
+      NumChecks += 2;
+      if (sensors[i].val != fullSensors[i].val ||
+          fullSensors[i].val != every) {
+        NumFailed += (sensors[i].val != fullSensors[i].val) +
+                     (fullSensors[i].val != every);
+        printf("FAIL %u walls step %u sensor %u at (%u, %u) dir %u: "
+               "cached %u, uncached %u, every wall %u\n", env.numWalls, step,
+               i, car.x, car.y, car.dir, sensors[i].val, fullSensors[i].val,
+               every);
+      }
+    }
+  }
+
+  printf("%5u %8u %12.2f %12.2f\n", env.numWalls, numSteps,
+         cachedRays ? (double)cachedTests / cachedRays : 0,
+         fullRays ? (double)fullTests / fullRays : 0);
+}
+
+int main(int argc, char ** argv) {
+  static const uint16_t numSegments[] = {8, 32, 128, 512};
+  uint32_t numSteps = argc > 1 ? strtoul(argv[1], 0, 0) : 20000;
+  uint32_t k;
+
+  printf("%5s %8s %12s %12s\n", "walls", "steps", "cached", "uncached");
+  printf("%5s %8s %12s %12s\n", "", "", "tests/ray", "tests/ray");
+  for (k = 0; k < sizeof(numSegments) / sizeof(numSegments[0]); k++) {
+    checkTrack(numSegments[k], numSteps);
+  }
+
+  printf("%u checks, %u failed\n", NumChecks, NumFailed);
+  return NumFailed != 0;
+}
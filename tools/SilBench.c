@@ -0,0 +1,305 @@
+/********** SilBench.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host software in the loop run of a controller compiled in
+  through HilController.h. The tick loop is HILMain simThread's, on the
+  HIL track and sensor layout from initObjects, with the controller
+  stepped once per sim tick:
+   1) Each IR val goes through IRSensor_DutyFromMM and each Ping val
+      through USSensor_PeriodFromMM, the values put on the pins.
+   2) hil_controller_step.
+   3) Its duties become the 12-bit samples the ADC would read of them, and
+      Actuators_UpdateVelocityAndDirection reads them like it reads
+      ActuatorTrace, so servo binning, motor mapping and the model options
+      (BICYCLE_MODEL, DIFF_DRIVE, MOTOR_DYNAMICS) are the hardware path's.
+   4) Move, wall check, finish check, sensor update.
+  MOTOR_INPUT_CAPTURE isn't supported, the motor duties come from the ADC.
+
+  Without -b, runs the race once and prints each tick. With -b, each of -j
+  worker processes, pinned one per core, runs races back to back for -t
+  seconds and reports its ticks/s. Workers are processes, not threads, since
+  controllers and the actuator code keep state in globals.
+
+  Build: gcc -O2 -I.. SilBench.c PingController.c ../Actuators.c \
+          ../MotorActuator.c ../ServoActuator.c ../IRSensor.c \
+          ../USSensor.c ../Simulator.c ../TrackSDF.c ../isqrt.c \
+          -lm -o SilBench
+  Run:   SilBench
+         SilBench -b -j 4 -t 2
+*/
+
+#define _GNU_SOURCE
+#include <sched.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/wait.h>
+#include <time.h>
+#include <unistd.h>
+#include "HilController.h"
+#include "ErrorCodes.h"
+#include "Simulator.h"
+#include "Actuators.h"
+#include "IRSensor.h"
+#include "USSensor.h"
+
+#define NUM_SENSORS 7 // same layout as HILMain initObjects
+#define NUM_WALLS 6
+#define NUM_AIN 4 // ADC channels, PE3 servo, PE2 PB7, PE1, PE0 PB6
+#define SERVO_AIN 0
+#define PB7_AIN 1
+#define PB6_AIN 3
+#define ADC_MAX 4095
+#define MAX_WORKERS 64
+
+enum outcome {
+  OUT_FINISH,
+  OUT_CRASH,
+  OUT_TIMEOUT
+};
+
+static const char * OutcomeNames[] = {
+  "Car completed race!", "Car crashed into wall!", "Sim hit max num ticks"
+};
+
+struct worker_result {
+  uint64_t ticks;
+  uint32_t runs;
+  double secs;
+};
+
+// What the actuator code links against in place of the HIL's.
+struct live_data LiveData;
+uint32_t NumSimTicks;
+static uint16_t AinSamples[NUM_AIN];
+void ActuatorTrace_Open(uint8_t channel) {}
+void ActuatorTrace_StartTick(uint32_t numTicks) {}
+uint16_t ActuatorTrace_In(uint8_t channel) { return AinSamples[channel]; }
+void terminal_printString(char * msg) { fputs(msg, stderr); }
+void terminal_fatalErrorHandler(ErrorCode_t errorCode, char * errorMessage) {
+  fprintf(stderr, "Error %u: %s\n", errorCode, errorMessage);
+  exit(1);
+}
+
+// HIL track, from HILMain initObjects.
+static const struct wall TrackWalls[NUM_WALLS] = {
+  {1000, 0, 1000, 1500},
+  {2000, 0, 2000, 500},
+  {1000, 1500, 2500, 1500},
+  {2000, 500, 3000, 500},
+  {2500, 1500, 2500, 5000},
+  {3000, 500, 3000, 5000}
+};
+
+static const struct sensor SensorLayout[NUM_SENSORS] = {
+  {S_US, 0, 0, 0, SENSOR_NO_WALL},
+  {S_US, 90, 0, 0, SENSOR_NO_WALL},
+  {S_US, 270, 0, 0, SENSOR_NO_WALL},
+  {S_IR, 90, 0, 0, SENSOR_NO_WALL},
+  {S_IR, 270, 0, 0, SENSOR_NO_WALL},
+  {S_IR, 15, 0, 0, SENSOR_NO_WALL},
+  {S_IR, 345, 0, 0, SENSOR_NO_WALL},
+};
+
+/**
+ * 12-bit sample of a duty's RC filtered voltage, as VirtualBoard converts.
+ */
+static uint16_t adcFromDuty(uint16_t duty) {
+  uint32_t val = (uint32_t)duty * (ADC_MAX + 1) / 1000;
+  return val > ADC_MAX ? ADC_MAX : val;
+}
+
+/**
+ * Fills readings from sensor vals. IR and Ping channels go in sensor order,
+ * the order IRSensor_Init and USSensor_Init hand them out.
+ */
+static void readSensors(const struct car * car, uint32_t tick,
+                        struct sensor_readings * readings) {
+  uint8_t ir = 0, ping = 0, i;
+
+  memset(readings, 0, sizeof(*readings));
+  readings->time = tick * MS_PER_SIM_TICK * 1000;
+  for (i = 0; i < car->numSensors; i++) {
+    if (car->sensors[i].type == S_IR && ir < HIL_NUM_IR) {
+      readings->irDuty[ir++] = IRSensor_DutyFromMM(car->sensors[i].val);
+    } else if (car->sensors[i].type == S_US && ping < HIL_NUM_PING) {
+      readings->pingPeriod[ping++] =
+        USSensor_PeriodFromMM(car->sensors[i].val);
+    }
+  }
+}
+
+/**
+ * Runs the race once. Returns the outcome and sets ticks to how many ran.
+ */
+static enum outcome runOne(uint8_t print, uint32_t * ticks) {
+  struct sensor sensors[NUM_SENSORS];
+  struct wall walls[NUM_WALLS];
+  struct environment env;
+  struct car car;
+  struct sensor_readings readings;
+  struct actuator_out out;
+
+  memcpy(sensors, SensorLayout, sizeof(sensors));
+  memcpy(walls, TrackWalls, sizeof(walls));
+  memset(&env, 0, sizeof(env));
+  env.finishLineY = 2000;
+  env.numWalls = NUM_WALLS;
+  env.walls = walls;
+  memset(&car, 0, sizeof(car));
+  car.x = 1500;
+  car.y = 1;
+  car.vel = 1000;
+  car.dir = 90;
+  car.numSensors = NUM_SENSORS;
+  car.sensors = sensors;
+  memset(&out, 0, sizeof(out));
+  memset(AinSamples, 0, sizeof(AinSamples));
+  Actuators_Init(); // motor models start at rest
+  Simulator_UpdateSensors(&car, &env);
+
+  for (NumSimTicks = 0; NumSimTicks < MAX_NUM_TICKS; NumSimTicks++) {
+    uint32_t prevX = car.x;
+    uint32_t prevY = car.y;
+
+    readSensors(&car, NumSimTicks, &readings);
+    hil_controller_step(&readings, &out);
+    AinSamples[SERVO_AIN] = adcFromDuty(out.servoDuty);
+    AinSamples[PB7_AIN] = adcFromDuty(out.pb7Duty);
+    AinSamples[PB6_AIN] = adcFromDuty(out.pb6Duty);
+    Actuators_UpdateVelocityAndDirection(&car);
+    if (print) {
+      printf("%u,%u,%u,%d,%u,%u,%u,%u\n", NumSimTicks, car.x, car.y,
+             car.vel, car.dir, out.servoDuty, out.pb7Duty, out.pb6Duty);
+    }
+
+    Simulator_MoveCar(&car, MS_PER_SIM_TICK);
+    if (Simulator_HitWall(&env, prevX, prevY, car.x, car.y)) {
+      *ticks = NumSimTicks + 1;
+      return OUT_CRASH;
+    }
+    if (car.y >= env.finishLineY) {
+      *ticks = NumSimTicks + 1;
+      return OUT_FINISH;
+    }
+    Simulator_UpdateSensors(&car, &env);
+  }
+  *ticks = MAX_NUM_TICKS;
+  return OUT_TIMEOUT;
+}
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/**
+ * Worker process body: pin to cpu, run races for secs, write the totals to
+ * fd.
+ */
+static void benchWorker(uint32_t cpu, double secs, int fd) {
+  struct worker_result result = {0, 0, 0};
+  cpu_set_t set;
+  double start;
+  uint32_t ticks;
+
+  CPU_ZERO(&set);
+  CPU_SET(cpu, &set);
+  sched_setaffinity(0, sizeof(set), &set); // unpinned if cpu isn't online
+  start = now();
+  do {
+    // Check the clock every 1000 races, not every one.
+    for (ticks = 0; ticks < 1000; ticks++) {
+      uint32_t n;
+      runOne(0, &n);
+      result.ticks += n;
+      result.runs++;
+    }
+    result.secs = now() - start;
+  } while (result.secs < secs);
+  if (write(fd, &result, sizeof(result)) != sizeof(result)) {
+    _exit(1);
+  }
+  _exit(0);
+}
+
+static int bench(uint32_t numWorkers, double secs) {
+  struct worker_result results[MAX_WORKERS];
+  uint64_t totalTicks = 0;
+  double totalRate = 0;
+  int fds[MAX_WORKERS];
+  uint32_t i;
+
+  for (i = 0; i < numWorkers; i++) {
+    int pipeFds[2];
+    if (pipe(pipeFds) != 0) {
+      perror("pipe");
+      return 1;
+    }
+    if (fork() == 0) {
+      close(pipeFds[0]);
+      benchWorker(i, secs, pipeFds[1]);
+    }
+    close(pipeFds[1]);
+    fds[i] = pipeFds[0];
+  }
+
+  printf("controller ABI %u, %u ms ticks, %u workers, %.1f s\n",
+         HIL_CONTROLLER_ABI, MS_PER_SIM_TICK, numWorkers, secs);
+  printf("%6s %10s %12s %12s\n", "worker", "runs", "ticks", "ticks/s");
+  for (i = 0; i < numWorkers; i++) {
+    if (read(fds[i], &results[i], sizeof(results[i])) !=
+        sizeof(results[i])) {
+      fprintf(stderr, "worker %u failed\n", i);
+      return 1;
+    }
+    close(fds[i]);
+    printf("%6u %10u %12llu %12.0f\n", i, results[i].runs,
+           (unsigned long long)results[i].ticks,
+           results[i].ticks / results[i].secs);
+    totalTicks += results[i].ticks;
+    totalRate += results[i].ticks / results[i].secs;
+  }
+  while (wait(0) > 0) {
+  }
+  printf("%6s %10s %12llu %12.0f (%.0f per worker)\n", "total", "",
+         (unsigned long long)totalTicks, totalRate, totalRate / numWorkers);
+  return 0;
+}
+
+static void usage(const char * name) {
+  fprintf(stderr, "usage: %s [-b] [-j workers] [-t seconds]\n", name);
+  exit(1);
+}
+
+int main(int argc, char ** argv) {
+  uint32_t numWorkers = sysconf(_SC_NPROCESSORS_ONLN);
+  double secs = 2.0;
+  uint8_t benchMode = 0;
+  enum outcome outcome;
+  uint32_t ticks;
+  int opt;
+
+  while ((opt = getopt(argc, argv, "bj:t:")) != -1) {
+    switch (opt) {
+      case 'b': benchMode = 1; break;
+      case 'j': numWorkers = strtoul(optarg, 0, 0); break;
+      case 't': secs = strtod(optarg, 0); break;
+      default: usage(argv[0]);
+    }
+  }
+  if (numWorkers == 0 || numWorkers > MAX_WORKERS || secs <= 0) {
+    usage(argv[0]);
+  }
+
+  if (benchMode) {
+    return bench(numWorkers, secs);
+  }
+  printf("tick,x,y,vel,dir,servo duty,pb7 duty,pb6 duty\n");
+  outcome = runOne(1, &ticks);
+  printf("%s after %u ticks\n", OutcomeNames[outcome], ticks);
+  return 0;
+}
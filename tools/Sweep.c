@@ -0,0 +1,412 @@
+/********** Sweep.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host Monte Carlo robustness sweep. Runs the Simulator.c tick
+  loop (actuators, move, collision, finish line, sensors, same order as
+  HILMain simThread) for thousands of seeds per track and controller, with
+  noise injected between the simulated sensors and the controller and a
+  delay queue between the controller and the car. Prints crash rate and
+  lap time distribution for each track/controller pair.
+
+  Every random draw comes from Philox keyed by (seed, run) with the tick and
+  sensor as counter, so a run's result does not depend on the thread count.
+
+  Noise model, applied to each reading the controller sees (sensor->val
+  itself is left alone, Simulator_UpdateSensors keeps it between ticks):
+    dropout   reading lost (no echo), reported as no wall in sight
+    gaussian  zero mean, sigma in mm, clamped at 0
+    quantize  rounded down to a multiple of the step in mm
+
+  Build: gcc -O2 -pthread -DSIM_THREADED -I.. Sweep.c ../Simulator.c \
+          ../TrackSDF.c ../isqrt.c -o Sweep -lm
+  Run:   Sweep -n 10000 -j 4 -s 50 -q 10 -d 20 -l 2
+*/
+
+#include <math.h>
+#include <pthread.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include "Simulator.h"
+#include "Philox.h"
+
+#define NUM_SENSORS 7 // same layout as HILMain initObjects
+#define MAX_WALLS 6
+#define MAX_THREADS 64
+#define MAX_DELAY_TICKS 16
+
+#define MAX_VELOCITY 1114 // mm/s, keep in sync with MotorActuator
+#define FULL_SPEED (MAX_VELOCITY * 999 / 1000)
+#define HALF_SPEED (MAX_VELOCITY * 500 / 1000)
+#define TURN_LEFT 30
+#define TURN_RIGHT (360 - 30)
+#define STEER_THRESHOLD_MM 200
+#define FRONT_THRESHOLD_MM 800
+#define SLOW_THRESHOLD_MM 400
+
+// Second counter word, one stream per kind of draw
+#define STREAM_SENSOR 0
+
+enum outcome {
+  OUT_FINISH,
+  OUT_CRASH,
+  OUT_TIMEOUT,
+  NUM_OUTCOMES
+};
+
+struct command {
+  int32_t vel;
+  uint32_t turn; // added to car dir, 0 - 360
+};
+
+typedef struct command (*controller_t)(const uint32_t * readings);
+
+struct track {
+  const char * name;
+  uint32_t startX;
+  uint32_t finishLineY;
+  uint16_t numWalls;
+  struct wall walls[MAX_WALLS];
+};
+
+struct controller {
+  const char * name;
+  controller_t step;
+};
+
+struct sweep_config {
+  uint32_t numRuns;
+  uint32_t numThreads;
+  uint32_t seed;
+  double sigmaMm;
+  uint32_t quantMm;
+  uint32_t dropoutPermille;
+  uint32_t delayTicks;
+};
+
+struct run_result {
+  uint8_t outcome;
+  uint16_t ticks;
+};
+
+struct sweep_job {
+  const struct sweep_config * config;
+  const struct track * track;
+  const struct controller * controller;
+  struct run_result * results;
+  uint32_t first; // this thread runs first, first + numThreads, ...
+};
+
+// Tracks from the TEST ENVIRONMENTS notes at the bottom of HILMain.c
+static const struct track Tracks[] = {
+  {"straight", 1500, 4500, 2, {
+    {1000, 0, 1000, 5000},
+    {2000, 0, 2000, 5000}}},
+  {"wide turns", 1500, 2000, 6, {
+    {1000, 0, 1000, 1500},
+    {2000, 0, 2000, 500},
+    {1000, 1500, 2500, 1500},
+    {2000, 500, 3000, 500},
+    {2500, 1500, 2500, 5000},
+    {3000, 500, 3000, 5000}}},
+  {"normal turn", 1750, 2000, 6, {
+    {1500, 0, 1500, 1000},
+    {2000, 0, 2000, 500},
+    {1500, 1000, 2500, 1000},
+    {2000, 500, 3000, 500},
+    {2500, 1000, 2500, 5000},
+    {3000, 500, 3000, 5000}}},
+};
+#define NUM_TRACKS (sizeof(Tracks) / sizeof(Tracks[0]))
+
+static const struct sensor SensorLayout[NUM_SENSORS] = {
+  {S_US, 0, 0, 0, SENSOR_NO_WALL},
+  {S_US, 90, 0, 0, SENSOR_NO_WALL},
+  {S_US, 270, 0, 0, SENSOR_NO_WALL},
+  {S_IR, 90, 0, 0, SENSOR_NO_WALL},
+  {S_IR, 270, 0, 0, SENSOR_NO_WALL},
+  {S_IR, 15, 0, 0, SENSOR_NO_WALL},
+  {S_IR, 345, 0, 0, SENSOR_NO_WALL},
+};
+
+/**
+ * steerPing
+ * Full speed, turns toward whichever side ping (left or right) sees more
+ * room. Same policy as VirtualBoard_DefaultController.
+ */
+static struct command steerPing(const uint32_t * readings) {
+  struct command cmd = {FULL_SPEED, 0};
+  if (readings[1] > readings[2] + STEER_THRESHOLD_MM) {
+    cmd.turn = TURN_LEFT;
+  } else if (readings[2] > readings[1] + STEER_THRESHOLD_MM) {
+    cmd.turn = TURN_RIGHT;
+  }
+  return cmd;
+}
+
+/**
+ * steerFront
+ * Keeps centered on the side IRs until the front ping sees a wall, then
+ * slows down and turns toward the angled IR with more room.
+ */
+static struct command steerFront(const uint32_t * readings) {
+  struct command cmd = {FULL_SPEED, 0};
+  if (readings[0] < FRONT_THRESHOLD_MM) {
+    if (readings[0] < SLOW_THRESHOLD_MM) {
+      cmd.vel = HALF_SPEED;
+    }
+    cmd.turn = readings[5] >= readings[6] ? TURN_LEFT : TURN_RIGHT;
+  } else if (readings[3] > readings[4] + STEER_THRESHOLD_MM) {
+    cmd.turn = TURN_LEFT;
+  } else if (readings[4] > readings[3] + STEER_THRESHOLD_MM) {
+    cmd.turn = TURN_RIGHT;
+  }
+  return cmd;
+}
+
+static const struct controller Controllers[] = {
+  {"ping steer", steerPing},
+  {"front avoid", steerFront},
+};
+#define NUM_CONTROLLERS (sizeof(Controllers) / sizeof(Controllers[0]))
+
+/**
+ * readSensors
+ * Copies sensor vals into readings with dropout, gaussian noise, and
+ * quantization applied. One Philox block per sensor per tick.
+ */
+static void readSensors(const struct sweep_config * config,
+                        struct philox_key key, uint32_t tick,
+                        const struct sensor * sensors, uint32_t * readings) {
+  int i;
+  for (i = 0; i < NUM_SENSORS; i++) {
+    struct philox_ctr ctr = {{tick, STREAM_SENSOR, i, 0}};
+    struct philox_ctr r = Philox_Generate(ctr, key);
+    double val = sensors[i].val;
+
+    if ((uint64_t)r.v[2] * 1000 < (uint64_t)config->dropoutPermille << 32) {
+      readings[i] = MAX_U32INT;
+      continue;
+    }
+    if (sensors[i].val == MAX_U32INT) {
+      readings[i] = MAX_U32INT; // nothing to add noise to
+      continue;
+    }
+    if (config->sigmaMm > 0) {
+      // Box-Muller, one normal from two uniforms
+      double u1 = Philox_Uniform(r.v[0]);
+      double u2 = Philox_Uniform(r.v[1]);
+      val += config->sigmaMm * sqrt(-2.0 * log(u1)) * cos(2.0 * M_PI * u2);
+      if (val < 0) {
+        val = 0;
+      }
+    }
+    readings[i] = (uint32_t)val;
+    if (config->quantMm > 1) {
+      readings[i] -= readings[i] % config->quantMm;
+    }
+  }
+}
+
+/**
+ * runOne
+ * Runs one seed to finish, crash, or MAX_NUM_TICKS.
+ */
+static struct run_result runOne(const struct sweep_config * config,
+                                const struct track * track,
+                                const struct controller * controller,
+                                uint32_t run) {
+  struct sensor sensors[NUM_SENSORS];
+  struct wall walls[MAX_WALLS];
+  struct environment env;
+  struct car car;
+  struct command queue[MAX_DELAY_TICKS + 1];
+  struct philox_key key = {{config->seed, run}};
+  uint32_t readings[NUM_SENSORS];
+  struct run_result result = {OUT_TIMEOUT, MAX_NUM_TICKS};
+  uint32_t tick, head = 0;
+
+  memcpy(sensors, SensorLayout, sizeof(sensors));
+  memcpy(walls, track->walls, sizeof(walls));
+  memset(&env, 0, sizeof(env));
+  env.finishLineY = track->finishLineY;
+  env.numWalls = track->numWalls;
+  env.walls = walls;
+  memset(&car, 0, sizeof(car));
+  car.x = track->startX;
+  car.y = 1;
+  car.vel = 1000;
+  car.dir = 90;
+  car.numSensors = NUM_SENSORS;
+  car.sensors = sensors;
+  Simulator_UpdateSensors(&car, &env);
+
+  // Commands issued before the run starts hold the start state
+  for (tick = 0; tick <= config->delayTicks; tick++) {
+    queue[tick].vel = car.vel;
+    queue[tick].turn = 0;
+  }
+
+  for (tick = 0; tick < MAX_NUM_TICKS; tick++) {
+    uint32_t prevX = car.x;
+    uint32_t prevY = car.y;
+    uint32_t dir;
+
+    // Controller output lands delayTicks later
+    readSensors(config, key, tick, sensors, readings);
+    queue[(head + config->delayTicks) % (config->delayTicks + 1)] =
+      controller->step(readings);
+    car.vel = queue[head].vel;
+    dir = car.dir + queue[head].turn;
+    car.dir = dir >= 360 ? dir - 360 : dir;
+    head = (head + 1) % (config->delayTicks + 1);
+
+    Simulator_MoveCar(&car, MS_PER_SIM_TICK);
+    if (Simulator_HitWall(&env, prevX, prevY, car.x, car.y)) {
+      result.outcome = OUT_CRASH;
+      result.ticks = tick + 1;
+      return result;
+    }
+    if (car.y >= env.finishLineY) {
+      result.outcome = OUT_FINISH;
+      result.ticks = tick + 1;
+      return result;
+    }
+    Simulator_UpdateSensors(&car, &env);
+  }
+  return result;
+}
+
+static void * sweepThread(void * arg) {
+  struct sweep_job * job = arg;
+  uint32_t run;
+  for (run = job->first; run < job->config->numRuns;
+       run += job->config->numThreads) {
+    job->results[run] = runOne(job->config, job->track, job->controller, run);
+  }
+  return 0;
+}
+
+static int compareU32(const void * a, const void * b) {
+  uint32_t x = *(const uint32_t *)a;
+  uint32_t y = *(const uint32_t *)b;
+  return x < y ? -1 : x > y;
+}
+
+/**
+ * printStats
+ * One row: outcome rates and lap time distribution of finished runs.
+ */
+static void printStats(const struct track * track,
+                       const struct controller * controller,
+                       const struct run_result * results, uint32_t numRuns,
+                       uint32_t * lapMs) {
+  uint32_t counts[NUM_OUTCOMES] = {0};
+  uint32_t numLaps = 0;
+  uint64_t lapSum = 0;
+  uint32_t i;
+
+  for (i = 0; i < numRuns; i++) {
+    counts[results[i].outcome]++;
+    if (results[i].outcome == OUT_FINISH) {
+      lapMs[numLaps] = results[i].ticks * MS_PER_SIM_TICK;
+      lapSum += lapMs[numLaps];
+      numLaps++;
+    }
+  }
+  printf("%-12s %-12s %7u %7.2f %7.2f %7.2f", track->name, controller->name,
+         numRuns, 100.0 * counts[OUT_CRASH] / numRuns,
+         100.0 * counts[OUT_FINISH] / numRuns,
+         100.0 * counts[OUT_TIMEOUT] / numRuns);
+  if (numLaps == 0) {
+    printf(" %6s %6s %6s %6s %8s\n", "-", "-", "-", "-", "-");
+    return;
+  }
+  qsort(lapMs, numLaps, sizeof(lapMs[0]), compareU32);
+  printf(" %6u %6u %6u %6u %8.1f\n", lapMs[0], lapMs[numLaps / 2],
+         lapMs[(uint64_t)numLaps * 9 / 10], lapMs[numLaps - 1],
+         (double)lapSum / numLaps);
+}
+
+static void usage(const char * name) {
+  fprintf(stderr, "usage: %s [-n runs] [-j threads] [-k seed] [-s sigma mm]"
+          " [-q quant mm] [-d dropout permille] [-l delay ticks]\n", name);
+  exit(1);
+}
+
+int main(int argc, char ** argv) {
+  struct sweep_config config = {10000, 1, 1, 0.0, 0, 0, 0};
+  pthread_t threads[MAX_THREADS];
+  struct sweep_job jobs[MAX_THREADS];
+  struct run_result * results;
+  uint32_t * lapMs;
+  struct timespec start, end;
+  double secs;
+  uint32_t t, c, i;
+  int opt;
+
+  config.numThreads = sysconf(_SC_NPROCESSORS_ONLN);
+  while ((opt = getopt(argc, argv, "n:j:k:s:q:d:l:")) != -1) {
+    switch (opt) {
+      case 'n': config.numRuns = strtoul(optarg, 0, 0); break;
+      case 'j': config.numThreads = strtoul(optarg, 0, 0); break;
+      case 'k': config.seed = strtoul(optarg, 0, 0); break;
+      case 's': config.sigmaMm = strtod(optarg, 0); break;
+      case 'q': config.quantMm = strtoul(optarg, 0, 0); break;
+      case 'd': config.dropoutPermille = strtoul(optarg, 0, 0); break;
+      case 'l': config.delayTicks = strtoul(optarg, 0, 0); break;
+      default: usage(argv[0]);
+    }
+  }
+  if (config.numRuns == 0 || config.numThreads == 0 ||
+      config.numThreads > MAX_THREADS || config.dropoutPermille > 1000 ||
+      config.delayTicks > MAX_DELAY_TICKS) {
+    usage(argv[0]);
+  }
+  results = malloc(config.numRuns * sizeof(results[0]));
+  lapMs = malloc(config.numRuns * sizeof(lapMs[0]));
+  if (!results || !lapMs) {
+    fprintf(stderr, "out of memory\n");
+    return 1;
+  }
+
+  printf("runs %u, threads %u, seed %u, sigma %.1f mm, quant %u mm, "
+         "dropout %u/1000, delay %u ticks (%u ms)\n\n", config.numRuns,
+         config.numThreads, config.seed, config.sigmaMm, config.quantMm,
+         config.dropoutPermille, config.delayTicks,
+         config.delayTicks * MS_PER_SIM_TICK);
+  printf("%-12s %-12s %7s %7s %7s %7s %6s %6s %6s %6s %8s\n", "track",
+         "controller", "runs", "crash%", "finish%", "tmout%", "min", "p50",
+         "p90", "max", "mean ms");
+
+  clock_gettime(CLOCK_MONOTONIC, &start);
+  for (t = 0; t < NUM_TRACKS; t++) {
+    for (c = 0; c < NUM_CONTROLLERS; c++) {
+      for (i = 0; i < config.numThreads; i++) {
+        jobs[i].config = &config;
+        jobs[i].track = &Tracks[t];
+        jobs[i].controller = &Controllers[c];
+        jobs[i].results = results;
+        jobs[i].first = i;
+        pthread_create(&threads[i], 0, sweepThread, &jobs[i]);
+      }
+      for (i = 0; i < config.numThreads; i++) {
+        pthread_join(threads[i], 0);
+      }
+      printStats(&Tracks[t], &Controllers[c], results, config.numRuns, lapMs);
+    }
+  }
+  clock_gettime(CLOCK_MONOTONIC, &end);
+  secs = (end.tv_sec - start.tv_sec) + (end.tv_nsec - start.tv_nsec) * 1e-9;
+  printf("\n%u runs in %.2f s (%.0f runs/s)\n",
+         config.numRuns * (uint32_t)(NUM_TRACKS * NUM_CONTROLLERS), secs,
+         config.numRuns * NUM_TRACKS * NUM_CONTROLLERS / secs);
+
+  free(results);
+  free(lapMs);
+  return 0;
+}
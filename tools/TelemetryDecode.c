@@ -0,0 +1,107 @@
+/********** TelemetryDecode.c ************** 
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host receiver for binary live data (see Telemetry.h). Reads 
+  the UART byte stream on stdin and writes one CSV row per valid frame to 
+  stdout, flushed per row so it can feed a live plot. Lost and corrupt 
+  frames are counted on stderr at the end.
+  With -a, reads a recorded actuator trace instead (see ActuatorTrace.h), 
+  from the UART or a host build's ACTUATOR_TRACE_PATH, and writes it as 
+  ReplayTrace initializer lines for replaying on the board.
+  Build: gcc -I.. TelemetryDecode.c ../Telemetry.c -o TelemetryDecode
+  Run:   TelemetryDecode < /dev/ttyACM0 > live.csv
+         TelemetryDecode -a < actuator_trace.bin > replay.txt
+*/
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include "Telemetry.h"
+
+int main(int argc, char ** argv) {
+  uint8_t frame[TELEMETRY_FRAME_BYTES];
+  uint16_t len = 0;
+  struct live_data data;
+  struct actuator_sample sample;
+  int actuators = argc > 1 && strcmp(argv[1], "-a") == 0;
+  uint16_t lastSeq = 0;
+  int haveSeq = 0;
+  uint32_t numFrames = 0, numLost = 0, numBad = 0;
+  int c, i;
+  
+  if (!actuators) {
+    printf("seq,time,x,y,vel,dir,servoDuty,motorPB7Duty,motorPB6Duty");
+    for (i = 0; i < LIVE_DATA_SENSORS; i++) {
+      printf(",s%d", i);
+    }
+    printf(",actuatorCycles,moveCycles,collisionCycles,sensorCycles\n");
+  }
+  
+  while ((c = getchar()) != EOF) {
+    if (c != 0) {
+      // Too long to be a frame, e.g. terminal text. Dropped at the next 0.
+      if (len < TELEMETRY_FRAME_BYTES) {
+        frame[len] = c;
+      }
+      len++;
+      continue;
+    }
+    if (len == 0) {
+      continue;
+    }
+    if (actuators) {
+      if (len > TELEMETRY_ACTUATOR_FRAME_BYTES || 
+          !Telemetry_DecodeActuator(frame, len, &sample)) {
+        numBad++;
+        len = 0;
+        continue;
+      }
+      len = 0;
+      
+      // Ticks count up from 0, so a gap is lost samples.
+      numLost += sample.numTicks - (haveSeq ? lastSeq + 1 : 0);
+      lastSeq = sample.numTicks;
+      haveSeq = 1;
+      numFrames++;
+      
+      printf("  {%u, {", sample.numTicks);
+      for (i = 0; i < MAX_TRACE_CHANNELS; i++) {
+        printf(i ? ", %u" : "%u", sample.adc[i]);
+      }
+      printf("}, %u},\n", sample.time);
+      continue;
+    }
+    
+    if (len > TELEMETRY_FRAME_BYTES || 
+        !Telemetry_Decode(frame, len, &data)) {
+      numBad++;
+      len = 0;
+      continue;
+    }
+    len = 0;
+    
+    if (haveSeq) {
+      numLost += (uint16_t)(data.seq - lastSeq - 1);
+    }
+    lastSeq = data.seq;
+    haveSeq = 1;
+    numFrames++;
+    
+    printf("%u,%u,%u,%u,%d,%u,%u,%u,%u", data.seq, data.time, data.x, data.y,
+      data.vel, data.dir, data.servoDuty, data.motorPB7Duty, 
+      data.motorPB6Duty);
+    for (i = 0; i < LIVE_DATA_SENSORS; i++) {
+      printf(",%u", data.sensors[i]);
+    }
+    for (i = 0; i < NUM_SIM_STAGES; i++) {
+      printf(",%u", data.stageCycles[i]);
+    }
+    printf("\n");
+    fflush(stdout);
+  }
+  
+  fprintf(stderr, "Frames: %u, lost: %u, bad: %u\n", numFrames, numLost, 
+    numBad);
+  return 0;
+}
@@ -0,0 +1,274 @@
+/********** WorldBench.c **************
+ * Authors: Sarah Masimore and Zachary Susskind
+ * Created Date: 10/18/2026
+ * Last Updated Date: 10/18/2026
+ Description: Host benchmark for World. On the HILMain track, 1 to 8 cars
+  wander the 3 x 5 m area at 1 m/s, car 0 driven directly and the rest
+  replaying traces. Per sim tick, prints the cost of World_Step and of car 0's
+  7-sensor World_UpdateSensors (walls alone for comparison), exact box tests
+  against the number of car-car pairs and ray-car pairs, how many car ticks
+  were collisions (coll), and checks collisions and sensor values
+  against brute force floating point tests of every pair and every ray:
+  collision results that differ (diff) and the worst sensor error in mm,
+  ignoring boxes within 2 mm of touching and rays within 2 mm of a box's
+  edge or corner.
+  Build: gcc -O2 -I.. WorldBench.c ../World.c ../Simulator.c ../TrackSDF.c \
+          ../isqrt.c -lm -o WorldBench
+  Run:   WorldBench [ticks]
+*/
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "Simulator.h"
+#include "World.h"
+
+#define NUM_SENSORS 7
+#define MAX_TICKS 20000
+#define FIELD_X 3000
+#define FIELD_Y 5000
+#define MARGIN 300
+#define MOVE_MM 100 // 1 m/s for one sim tick
+#define TRIG_SCALE 10000
+
+extern int32_t SinLookup[360];
+extern int32_t CosLookup[360];
+
+static const uint32_t SensorDirs[NUM_SENSORS] = {0, 90, 270, 90, 270, 15, 345};
+static uint32_t RandState = 12345;
+
+static uint32_t randBelow(uint32_t n) {
+  // xorshift32
+  RandState ^= RandState << 13;
+  RandState ^= RandState >> 17;
+  RandState ^= RandState << 5;
+  return RandState % n;
+}
+
+static double now(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + t.tv_nsec * 1e-9;
+}
+
+/**
+ * Random walk: turn up to 10 degrees a tick, move MOVE_MM, turn around at
+ * the edges of the field.
+ */
+static void randomWalk(struct trace_pose * poses, uint32_t numTicks) {
+  int32_t x = MARGIN + randBelow(FIELD_X - 2 * MARGIN);
+  int32_t y = MARGIN + randBelow(FIELD_Y - 2 * MARGIN);
+  int32_t dir = randBelow(360);
+  uint32_t t;
+
+  for (t = 0; t < numTicks; t++) {
+    poses[t].x = x;
+    poses[t].y = y;
+    poses[t].dir = dir;
+    dir = (dir + 350 + randBelow(21)) % 360;
+    x += CosLookup[dir] * MOVE_MM / TRIG_SCALE;
+    y += SinLookup[dir] * MOVE_MM / TRIG_SCALE;
+    if (x < MARGIN || x > FIELD_X - MARGIN || y < MARGIN ||
+        y > FIELD_Y - MARGIN) {
+      dir = (dir + 180) % 360;
+      x += 2 * CosLookup[dir] * MOVE_MM / TRIG_SCALE;
+      y += 2 * SinLookup[dir] * MOVE_MM / TRIG_SCALE;
+    }
+  }
+}
+
+/**
+ * How far boxes a and b overlap along the separating axis that separates
+ * them most, negative if apart. Same trig tables as World, in doubles.
+ */
+static double penetration(struct car * a, struct car * b) {
+  struct car * cars[2] = {a, b};
+  double ux[2], uy[2];
+  double dx = (double)b->x - a->x;
+  double dy = (double)b->y - a->y;
+  double best = 1e18;
+  int i, k;
+
+  for (i = 0; i < 2; i++) {
+    ux[i] = CosLookup[cars[i]->dir] / (double)TRIG_SCALE;
+    uy[i] = SinLookup[cars[i]->dir] / (double)TRIG_SCALE;
+  }
+
+  for (i = 0; i < 4; i++) {
+    // Axis: length or width direction of a or b.
+    double nx = i & 1 ? -uy[i >> 1] : ux[i >> 1];
+    double ny = i & 1 ? ux[i >> 1] : uy[i >> 1];
+    double radius = 0;
+    for (k = 0; k < 2; k++) {
+      radius += CAR_LENGTH_MM / 2.0 * fabs(ux[k] * nx + uy[k] * ny) +
+                CAR_WIDTH_MM / 2.0 * fabs(-uy[k] * nx + ux[k] * ny);
+    }
+    radius -= fabs(dx * nx + dy * ny);
+    best = radius < best ? radius : best;
+  }
+  return best;
+}
+
+/**
+ * Distance along ray from (x, y) at absDir to box of car grown by pad mm on
+ * each side, or -1 if missed.
+ */
+static double rayDistance(struct car * car, double x, double y,
+                          uint16_t absDir, double pad) {
+  double ux = CosLookup[car->dir] / (double)TRIG_SCALE;
+  double uy = SinLookup[car->dir] / (double)TRIG_SCALE;
+  double rx = CosLookup[absDir] / (double)TRIG_SCALE;
+  double ry = SinLookup[absDir] / (double)TRIG_SCALE;
+  double px = x - car->x;
+  double py = y - car->y;
+  double start[2] = {px * ux + py * uy, -px * uy + py * ux};
+  double dir[2] = {rx * ux + ry * uy, -rx * uy + ry * ux};
+  double half[2] = {CAR_LENGTH_MM / 2.0 + pad, CAR_WIDTH_MM / 2.0 + pad};
+  double near = 0, far = 1e18;
+  int k;
+
+  for (k = 0; k < 2; k++) {
+    double t0, t1;
+    if (fabs(dir[k]) < 1e-12) {
+      if (fabs(start[k]) > half[k]) {
+        return -1;
+      }
+      continue;
+    }
+    t0 = (-half[k] - start[k]) / dir[k];
+    t1 = (half[k] - start[k]) / dir[k];
+    if (t0 > t1) {
+      double swap = t0;
+      t0 = t1;
+      t1 = swap;
+    }
+    near = t0 > near ? t0 : near;
+    far = t1 < far ? t1 : far;
+  }
+  return near <= far && far > 0 ? near : -1;
+}
+
+int main(int argc, char ** argv) {
+  static struct trace_pose poses[WORLD_MAX_CARS][MAX_TICKS];
+  static struct wall walls[6] = {
+    {1000, 0, 1000, 1500}, {2000, 0, 2000, 500}, {1000, 1500, 2500, 1500},
+    {2000, 500, 3000, 500}, {2500, 1500, 2500, 5000}, {3000, 500, 3000, 5000}
+  };
+  struct environment env = {0};
+  struct sensor sensors[WORLD_MAX_CARS][NUM_SENSORS];
+  struct car cars[WORLD_MAX_CARS];
+  struct pose_trace traces[WORLD_MAX_CARS];
+  struct world world;
+  uint32_t numTicks = argc > 1 ? strtoul(argv[1], 0, 0) : 2000;
+  uint32_t numCars, i, j, t;
+
+  if (numTicks < 1 || numTicks > MAX_TICKS) {
+    numTicks = MAX_TICKS;
+  }
+  env.walls = walls;
+  env.numWalls = 6;
+  env.finishLineY = FIELD_Y;
+
+  printf("%u ticks, %u sensors on car 0\n\n", numTicks, NUM_SENSORS);
+  printf("%4s %8s %8s %8s %8s %8s %8s %6s %6s %7s\n", "cars", "step ns",
+         "sense ns", "walls ns", "tests", "pairs", "rays", "coll", "diff",
+         "max err");
+
+  for (numCars = 1; numCars <= WORLD_MAX_CARS; numCars++) {
+    double stepTime = 0, senseTime = 0, wallTime = 0, t0, maxError = 0;
+    uint32_t collisions = 0, mismatches = 0;
+    uint64_t boxTests;
+
+    RandState = 12345 + numCars;
+    World_Init(&world, &env);
+    for (i = 0; i < numCars; i++) {
+      randomWalk(poses[i], numTicks);
+      for (j = 0; j < NUM_SENSORS; j++) {
+        sensors[i][j] = (struct sensor){S_IR, SensorDirs[j], 0, 0,
+                                        SENSOR_NO_WALL};
+      }
+      cars[i] = (struct car){0};
+      cars[i].numSensors = i == 0 ? NUM_SENSORS : 0;
+      cars[i].sensors = sensors[i];
+      traces[i] = (struct pose_trace){numTicks, poses[i]};
+      World_AddCar(&world, &cars[i], i == 0 ? 0 : &traces[i]);
+    }
+
+    for (t = 0; t < numTicks; t++) {
+      uint8_t collided;
+
+      // Car 0 is driven by the sim, so set its pose directly.
+      cars[0].x = poses[0][t].x;
+      cars[0].y = poses[0][t].y;
+      cars[0].dir = poses[0][t].dir;
+
+      t0 = now();
+      collided = World_Step(&world, t);
+      stepTime += now() - t0;
+
+      t0 = now();
+      World_UpdateSensors(&world, 0);
+      senseTime += now() - t0;
+
+      for (i = 0; i < numCars; i++) {
+        uint8_t expected = 0;
+        for (j = 0; j < numCars; j++) {
+          double depth;
+          if (i == j) {
+            continue;
+          }
+          depth = penetration(&cars[i], &cars[j]);
+          if (fabs(depth) <= 2) {
+            expected = 0xFF; // grazing, either result is fine
+            break;
+          }
+          expected |= depth > 0;
+        }
+        collisions += (collided >> i) & 1;
+        mismatches += expected != 0xFF && expected != ((collided >> i) & 1);
+      }
+
+      for (j = 0; j < NUM_SENSORS; j++) {
+        uint16_t absDir = (cars[0].dir + SensorDirs[j]) % 360;
+        double exact = world.wallVals[0][j] < MAX_SENSOR_LINE_OF_SIGHT ?
+                       world.wallVals[0][j] : MAX_SENSOR_LINE_OF_SIGHT;
+        double error;
+        uint8_t grazing = 0;
+        for (i = 1; i < numCars; i++) {
+          double d = rayDistance(&cars[i], cars[0].x, cars[0].y, absDir, 0);
+          // Rays within 2 mm of a corner or edge may hit or miss.
+          grazing |= (rayDistance(&cars[i], cars[0].x, cars[0].y, absDir,
+                                  -2) < 0) !=
+                     (rayDistance(&cars[i], cars[0].x, cars[0].y, absDir,
+                                  2) < 0);
+          exact = d >= 0 && d < exact ? d : exact;
+        }
+        if (grazing || exact >= MAX_SENSOR_LINE_OF_SIGHT) {
+          continue;
+        }
+        error = fabs(exact - cars[0].sensors[j].val);
+        maxError = error > maxError ? error : maxError;
+      }
+    }
+
+    // Walls alone, the single car cost World_UpdateSensors adds to.
+    for (t = 0; t < numTicks; t++) {
+      cars[0].x = poses[0][t].x;
+      cars[0].y = poses[0][t].y;
+      cars[0].dir = poses[0][t].dir;
+      t0 = now();
+      Simulator_UpdateSensors(&cars[0], &env);
+      wallTime += now() - t0;
+    }
+
+    boxTests = world.boxTests;
+    printf("%4u %8.1f %8.1f %8.1f %8.2f %8u %8u %6u %6u %7.1f\n", numCars,
+           stepTime * 1e9 / numTicks, senseTime * 1e9 / numTicks,
+           wallTime * 1e9 / numTicks, (double)boxTests / numTicks,
+           numCars * (numCars - 1) / 2, NUM_SENSORS * (numCars - 1),
+           collisions, mismatches, maxError);
+  }
+  return 0;
+}